@@ -42,12 +42,14 @@ using namespace TI;
 PassRefPtr<OpaqueTiString> OpaqueTiString::create(const UString& ustring)
 {
     if (!ustring.isNull())
-        return adoptRef(new OpaqueTiString(ustring.data(), ustring.size()));
+        return create(ustring.data(), ustring.size());
     return 0;
 }
 
 UString OpaqueTiString::ustring() const
 {
+    if (this && m_buffer)
+        return UString(UString::Rep::create(m_characters, m_length, m_buffer->crossThreadCopy()));
     if (this && m_characters)
         return UString(m_characters, m_length, true);
     return UString::null();
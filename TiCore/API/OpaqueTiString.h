@@ -49,11 +49,26 @@ struct OpaqueTiString : public ThreadSafeShared<OpaqueTiString> {
 
     static PassRefPtr<OpaqueTiString> create(const UChar* characters, unsigned length)
     {
-        return adoptRef(new OpaqueTiString(characters, length));
+        UChar* copy = static_cast<UChar*>(fastMalloc(length * sizeof(UChar)));
+        memcpy(copy, characters, length * sizeof(UChar));
+        return adopt(copy, length);
     }
 
     static PassRefPtr<OpaqueTiString> create(const TI::UString&);
 
+    // Takes ownership of characters, which must have been allocated with fastMalloc.
+    static PassRefPtr<OpaqueTiString> adopt(UChar* characters, unsigned length)
+    {
+        return adoptRef(new OpaqueTiString(characters, length, length >= static_cast<unsigned>(TI::minShareSize) ? new TI::UStringBuffer(characters) : 0));
+    }
+
+    // Uses characters owned by the caller, who is told through finalizer when
+    // they are no longer used.
+    static PassRefPtr<OpaqueTiString> createExternal(UChar* characters, unsigned length, TI::UStringBuffer::Finalizer finalizer, void* context)
+    {
+        return adoptRef(new OpaqueTiString(characters, length, new TI::UStringBuffer(characters, length, finalizer, context)));
+    }
+
     UChar* characters() { return this ? m_characters : 0; }
     unsigned length() { return this ? m_length : 0; }
 
@@ -69,20 +84,28 @@ private:
     {
     }
 
-    OpaqueTiString(const UChar* characters, unsigned length)
-        : m_length(length)
+    // Long strings keep their characters in a shared buffer, so that strings
+    // made from them share the characters rather than copying them.
+    OpaqueTiString(UChar* characters, unsigned length, TI::UStringBuffer* buffer)
+        : m_characters(characters)
+        , m_length(length)
     {
-        m_characters = new UChar[length];
-        memcpy(m_characters, characters, length * sizeof(UChar));
+        if (buffer) {
+            // Start out with a thread safe count, so that later copies for
+            // other threads only need an atomic increment.
+            m_buffer = TI::UString::SharedUChar::create(buffer)->crossThreadCopy();
+        }
     }
 
     ~OpaqueTiString()
     {
-        delete[] m_characters;
+        if (!m_buffer)
+            fastFree(m_characters);
     }
 
     UChar* m_characters;
     unsigned m_length;
+    RefPtr<TI::UString::SharedUChar> m_buffer;
 };
 
 #endif
@@ -60,7 +60,7 @@ TiValueRef TiEvalScript(TiContextRef ctx, TiStringRef script, TiObjectRef thisOb
     SourceCode source = makeSource(script->ustring(), sourceURL->ustring(), startingLineNumber);
     Completion completion = evaluate(globalObject->globalExec(), globalObject->globalScopeChain(), source, jsThisObject);
 
-    if (completion.complType() == Throw) {
+    if (completion.complType() == Throw || completion.complType() == Interrupted) {
         if (exception)
             *exception = toRef(exec, completion.value());
         return 0;
@@ -103,7 +103,7 @@ void TiGarbageCollect(TiContextRef ctx)
     TiExcState* exec = toJS(ctx);
     TiGlobalData& globalData = exec->globalData();
 
-    TiLock lock(globalData.isSharedInstance ? LockForReal : SilenceAssertionsOnly);
+    TiLock lock(&globalData);
 
     if (!globalData.heap.isBusy())
         globalData.heap.collect();
@@ -42,6 +42,8 @@ class TiCallbackFunction : public InternalFunction {
 public:
     TiCallbackFunction(TiExcState*, TiObjectCallAsFunctionCallback, const Identifier& name);
 
+    TiObjectCallAsFunctionCallback callback() const { return m_callback; }
+
     static const ClassInfo info;
     
     // InternalFunction mish-mashes constructor and function behavior -- we should 
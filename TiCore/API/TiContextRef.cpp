@@ -35,11 +35,15 @@
 #include "TiContextRefPrivate.h"
 
 #include "APICast.h"
+#include "Error.h"
+#include "Executable.h"
 #include "InitializeThreading.h"
 #include "TiCallbackObject.h"
 #include "TiClassRef.h"
 #include "TiGlobalObject.h"
+#include "TiGlobalObjectSnapshot.h"
 #include "TiObject.h"
+#include <stdio.h>
 #include <wtf/Platform.h>
 
 #if PLATFORM(DARWIN)
@@ -67,6 +71,72 @@ void TiContextGroupRelease(TiContextGroupRef group)
     toJS(group)->deref();
 }
 
+TiCodeMemoryUsage TiContextGroupGetCodeMemoryUsage(TiContextGroupRef group)
+{
+    TiGlobalData* globalData = toJS(group);
+    TiLock lock(globalData);
+
+    CodeMemoryUsage usage = globalData->codeMemoryUsage();
+    TiCodeMemoryUsage result = { usage.bytecodeBytes, usage.metadataBytes, usage.jitCodeBytes };
+    return result;
+}
+
+void TiContextGroupSetCodeFlushingAge(TiContextGroupRef group, unsigned collections)
+{
+    TiGlobalData* globalData = toJS(group);
+    TiLock lock(globalData);
+
+    globalData->codeFlushingAge = collections;
+}
+
+class TiResourceLimitClient : public ResourceLimits::Client {
+public:
+    TiResourceLimitClient(TiResourceLimitCallback callback, void* userData)
+        : m_callback(callback)
+        , m_userData(userData)
+    {
+    }
+
+    virtual bool limitExceeded(TiGlobalData* globalData, ResourceLimits::Resource resource)
+    {
+        TiResourceLimit limit = kTiResourceLimitExecutionTime;
+        switch (resource) {
+        case ResourceLimits::ExecutionTime:
+            limit = kTiResourceLimitExecutionTime;
+            break;
+        case ResourceLimits::CPUTime:
+            limit = kTiResourceLimitCPUTime;
+            break;
+        case ResourceLimits::HeapSize:
+            limit = kTiResourceLimitHeapSize;
+            break;
+        case ResourceLimits::ExecutableMemory:
+            limit = kTiResourceLimitExecutableMemory;
+            break;
+        case ResourceLimits::NoResource:
+            ASSERT_NOT_REACHED();
+        }
+        return m_callback(toRef(globalData), limit, m_userData);
+    }
+
+private:
+    TiResourceLimitCallback m_callback;
+    void* m_userData;
+};
+
+void TiContextGroupSetResourceLimits(TiContextGroupRef group, const TiResourceLimits* limits, TiResourceLimitCallback callback, void* userData)
+{
+    TiGlobalData* globalData = toJS(group);
+    TiLock lock(globalData);
+
+    ResourceLimits& resourceLimits = globalData->resourceLimits;
+    if (limits)
+        resourceLimits.setLimits(limits->executionTime, limits->cpuTime, limits->heapSize, limits->executableMemory);
+    else
+        resourceLimits.setLimits(0, 0, 0, 0);
+    resourceLimits.setClient(callback ? new TiResourceLimitClient(callback, userData) : 0);
+}
+
 TiGlobalContextRef TiGlobalContextCreate(TiClassRef globalObjectClass)
 {
     initializeThreading();
@@ -90,10 +160,10 @@ TiGlobalContextRef TiGlobalContextCreateInGroup(TiContextGroupRef group, TiClass
 {
     initializeThreading();
 
-    TiLock lock(LockForReal);
-
     RefPtr<TiGlobalData> globalData = group ? PassRefPtr<TiGlobalData>(toJS(group)) : TiGlobalData::create();
 
+    TiLock lock(globalData.get());
+
 #if ENABLE(JSC_MULTIPLE_THREADS)
     globalData->makeUsableFromMultipleThreads();
 #endif
@@ -112,6 +182,127 @@ TiGlobalContextRef TiGlobalContextCreateInGroup(TiContextGroupRef group, TiClass
     return TiGlobalContextRetain(toGlobalRef(exec));
 }
 
+static TiClassRef globalObjectClass(TiGlobalObject* globalObject)
+{
+    if (globalObject->inherits(&TiCallbackObject<TiGlobalObject>::info))
+        return static_cast<TiCallbackObject<TiGlobalObject>*>(globalObject)->classRef();
+    return 0;
+}
+
+TiGlobalContextRef TiGlobalContextCreateCopy(TiContextRef ctx, TiValueRef* exception)
+{
+    TiExcState* exec = toJS(ctx);
+    exec->globalData().heap.registerThread();
+    TiLock lock(exec);
+
+    // Activations of running functions still live in the register file.
+    if (exec->globalData().dynamicGlobalObject) {
+        if (exception)
+            *exception = toRef(exec, Error::create(exec, TypeError, "Cannot copy a context while Ti is executing", -1, -1, 0));
+        return 0;
+    }
+
+    TiGlobalObject* globalObject = exec->lexicalGlobalObject();
+    TiGlobalContextRef copy = TiGlobalContextCreateInGroup(toRef(&exec->globalData()), globalObjectClass(globalObject));
+    TiGlobalObject* copyGlobalObject = toJS(copy)->lexicalGlobalObject();
+
+    // The new context is the pristine one the snapshot's built-in objects are
+    // matched against, and is then restored from the snapshot. The snapshot
+    // never leaves this process, so it may hold API callbacks and classes.
+    Vector<char> snapshot;
+    TiGlobalObjectSnapshotWriter writer(globalObject, copyGlobalObject, true);
+    if (!writer.write(snapshot)) {
+        if (exception)
+            *exception = toRef(exec, Error::create(exec, TypeError, "Cannot copy " + writer.unsupportedObject()->className() + " objects", -1, -1, 0));
+        TiGlobalContextRelease(copy);
+        return 0;
+    }
+
+    TiGlobalObjectSnapshotReader reader(copyGlobalObject, true);
+    if (!reader.read(snapshot.data(), snapshot.size())) {
+        ASSERT_NOT_REACHED();
+        TiGlobalContextRelease(copy);
+        return 0;
+    }
+    return copy;
+}
+
+bool TiGlobalContextWriteSnapshot(TiContextRef ctx, const char* path, TiValueRef* exception)
+{
+    TiExcState* exec = toJS(ctx);
+    exec->globalData().heap.registerThread();
+    TiLock lock(exec);
+
+    if (exec->globalData().dynamicGlobalObject) {
+        if (exception)
+            *exception = toRef(exec, Error::create(exec, TypeError, "Cannot write a snapshot while Ti is executing", -1, -1, 0));
+        return false;
+    }
+
+    TiGlobalObject* globalObject = exec->lexicalGlobalObject();
+    TiGlobalContextRef pristineContext = TiGlobalContextCreateInGroup(toRef(&exec->globalData()), globalObjectClass(globalObject));
+
+    Vector<char> snapshot;
+    TiGlobalObjectSnapshotWriter writer(globalObject, toJS(pristineContext)->lexicalGlobalObject(), false);
+    bool written = writer.write(snapshot);
+    TiGlobalContextRelease(pristineContext);
+    if (!written) {
+        if (exception)
+            *exception = toRef(exec, Error::create(exec, TypeError, "Cannot write " + writer.unsupportedObject()->className() + " objects to a snapshot", -1, -1, 0));
+        return false;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (file) {
+        written = fwrite(snapshot.data(), 1, snapshot.size(), file) == snapshot.size();
+        if (fclose(file))
+            written = false;
+    }
+    if (!file || !written) {
+        if (exception)
+            *exception = toRef(exec, Error::create(exec, GeneralError, "Cannot write snapshot file", -1, -1, 0));
+        return false;
+    }
+    return true;
+}
+
+bool TiGlobalContextReadSnapshot(TiGlobalContextRef ctx, const char* path, TiValueRef* exception)
+{
+    TiExcState* exec = toJS(ctx);
+    exec->globalData().heap.registerThread();
+    TiLock lock(exec);
+
+    if (exec->globalData().dynamicGlobalObject) {
+        if (exception)
+            *exception = toRef(exec, Error::create(exec, TypeError, "Cannot read a snapshot while Ti is executing", -1, -1, 0));
+        return false;
+    }
+
+    Vector<char> snapshot;
+    FILE* file = fopen(path, "rb");
+    bool readFile = file;
+    if (file) {
+        char buffer[4096];
+        while (size_t count = fread(buffer, 1, sizeof(buffer), file))
+            snapshot.append(buffer, count);
+        readFile = !ferror(file);
+        fclose(file);
+    }
+    if (!readFile) {
+        if (exception)
+            *exception = toRef(exec, Error::create(exec, GeneralError, "Cannot read snapshot file", -1, -1, 0));
+        return false;
+    }
+
+    TiGlobalObjectSnapshotReader reader(exec->lexicalGlobalObject(), false);
+    if (!reader.read(snapshot.data(), snapshot.size())) {
+        if (exception)
+            *exception = toRef(exec, Error::create(exec, GeneralError, "Snapshot file does not match this version of TiCore or this context", -1, -1, 0));
+        return false;
+    }
+    return true;
+}
+
 TiGlobalContextRef TiGlobalContextRetain(TiGlobalContextRef ctx)
 {
     TiExcState* exec = toJS(ctx);
@@ -169,3 +360,11 @@ TiGlobalContextRef TiContextGetGlobalContext(TiContextRef ctx)
 
     return toGlobalRef(exec->lexicalGlobalObject()->globalExec());
 }
+
+void TiContextRequestTermination(TiContextRef ctx)
+{
+    // Deliberately takes no lock and registers no thread: this only sets the
+    // flag that the running script polls.
+    TiExcState* exec = toJS(ctx);
+    exec->globalData().terminationRequested = 1;
+}
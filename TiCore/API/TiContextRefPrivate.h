@@ -53,6 +53,133 @@ extern "C" {
 */
 JS_EXPORT TiGlobalContextRef TiContextGetGlobalContext(TiContextRef ctx);
 
+/*!
+@typedef TiCodeMemoryUsage
+@abstract Memory held by compiled function code, in bytes.
+@field bytecodeBytes The size of the bytecode instruction streams.
+@field metadataBytes The size of constant pools, inline caches, exception and line number information and other data kept alongside the bytecode.
+@field jitCodeBytes The size of machine code generated by the JIT.
+*/
+typedef struct {
+    size_t bytecodeBytes;
+    size_t metadataBytes;
+    size_t jitCodeBytes;
+} TiCodeMemoryUsage;
+
+/*!
+@function
+@abstract Gets the memory held by compiled function code in a context group.
+@param group The TiContextGroup to examine.
+@result The memory held by compiled code for all functions in group.
+*/
+JS_EXPORT TiCodeMemoryUsage TiContextGroupGetCodeMemoryUsage(TiContextGroupRef group);
+
+/*!
+@function
+@abstract Sets how long compiled function code may go unused before it is discarded.
+@param group The TiContextGroup to configure.
+@param collections The number of garbage collections a function may go without being called before its compiled code is discarded. Pass 0 to keep compiled code for as long as the function exists.
+@discussion Discarded code is regenerated from source the next time the function is called. Code is only discarded by collections that happen while no Ti is executing in group. When the JIT has linked a call site directly to a function, calls from there do not count as calls; instead the function's code is kept for as long as the code containing the call site is.
+*/
+JS_EXPORT void TiContextGroupSetCodeFlushingAge(TiContextGroupRef group, unsigned collections);
+
+/*!
+@enum TiResourceLimit
+@constant kTiResourceLimitExecutionTime The wall clock time a script may run.
+@constant kTiResourceLimitCPUTime The CPU time a script may use.
+@constant kTiResourceLimitHeapSize The size of the garbage collected heap.
+@constant kTiResourceLimitExecutableMemory The memory holding code generated by the JIT.
+*/
+typedef enum {
+    kTiResourceLimitExecutionTime,
+    kTiResourceLimitCPUTime,
+    kTiResourceLimitHeapSize,
+    kTiResourceLimitExecutableMemory
+} TiResourceLimit;
+
+/*!
+@typedef TiResourceLimits
+@abstract Limits on the resources used by the scripts in a context group. A field set to 0 imposes no limit.
+@field executionTime The number of seconds of wall clock time that each call into script may take, counted from the outermost call.
+@field cpuTime The number of seconds of CPU time that each call into script may use, counted from the outermost call. Where the CPU time of a thread can not be measured, wall clock time is used instead.
+@field heapSize The number of bytes the garbage collected heap may grow to. Memory held outside the heap, such as the characters of large strings, is not counted.
+@field executableMemory The number of bytes of memory that code generated by the JIT may occupy.
+*/
+typedef struct {
+    double executionTime;
+    double cpuTime;
+    size_t heapSize;
+    size_t executableMemory;
+} TiResourceLimits;
+
+/*!
+@typedef TiResourceLimitCallback
+@abstract The callback invoked when a context group exceeds one of its resource limits.
+@param group The TiContextGroup that exceeded a limit.
+@param limit The limit that was exceeded.
+@param userData The userData passed to TiContextGroupSetResourceLimits.
+@result true to stop the running script, false to let it continue.
+@discussion The callback is invoked on the thread running script, at a point where it is safe to stop it. It must not run script or create values in group, but it may call TiContextGroupSetResourceLimits, for example to raise the limit that was exceeded. A script allowed to continue past a time limit is given the full time again; a memory limit is reported at most once per call into script.
+*/
+typedef bool (*TiResourceLimitCallback)(TiContextGroupRef group, TiResourceLimit limit, void* userData);
+
+/*!
+@function
+@abstract Limits the time and memory that the scripts in a context group may use.
+@param group The TiContextGroup to limit.
+@param limits The limits to impose, or NULL to remove all limits.
+@param callback The function to call when a limit is exceeded, or NULL to stop the running script whenever a limit is exceeded.
+@param userData A pointer passed to callback.
+@discussion A stopped script throws an exception that it can not catch, as with TiContextRequestTermination. Memory limits are soft: the allocation that exceeds a limit succeeds, and the script is stopped at its next loop iteration or function call. They apply only while script is running; memory allocated outside script, for example by API calls, is not limited. Time limits take effect from the next call into script. Time limits are enforced by a background thread, so scripts pay nothing for them while they run.
+*/
+JS_EXPORT void TiContextGroupSetResourceLimits(TiContextGroupRef group, const TiResourceLimits* limits, TiResourceLimitCallback callback, void* userData);
+
+/*!
+@function
+@abstract Writes a snapshot of a context's global state to a file.
+@param ctx The TiContext whose global object to snapshot.
+@param path The path of the file to write, in UTF-8.
+@param exception A pointer to a TiValueRef in which to store an exception, if any. Pass NULL if you do not care to store an exception.
+@result true if the snapshot was written, otherwise false.
+@discussion The snapshot holds every value reachable from ctx's global object, including functions, the variables they close over, and changes made to the built-in objects. Reading it with TiGlobalContextReadSnapshot gives a new context, in this process or another, the same state without running the scripts that built it up. Functions are stored as source, and are compiled again the first time they are called.
+
+Objects that hold native state can not be written: arguments objects, objects of API classes, functions made with TiObjectMakeFunctionWithCallback or TiObjectMakeConstructor, and values from other global objects. Add them after reading the snapshot instead. Writing fails, storing a TypeError in exception, if ctx holds any of them, or if Ti is executing in ctx's context group.
+*/
+JS_EXPORT bool TiGlobalContextWriteSnapshot(TiContextRef ctx, const char* path, TiValueRef* exception);
+
+/*!
+@function
+@abstract Restores a context's global state from a snapshot file.
+@param ctx A new TiGlobalContext, in which no script has run, with the same global object class as the context the snapshot was written from.
+@param path The path of a file written by TiGlobalContextWriteSnapshot, in UTF-8.
+@param exception A pointer to a TiValueRef in which to store an exception, if any. Pass NULL if you do not care to store an exception.
+@result true if the snapshot was read, otherwise false.
+@discussion The snapshot must have been written by the same version of TiCore. A snapshot holds script source, so read only snapshots from trusted sources. If the file can not be read or does not match ctx, reading fails, storing an exception, and ctx is left partly restored and should be released.
+*/
+JS_EXPORT bool TiGlobalContextReadSnapshot(TiGlobalContextRef ctx, const char* path, TiValueRef* exception);
+
+/*!
+@function
+@abstract Creates a global context that starts out as a copy of an existing one.
+@param ctx The TiContext to copy. The new context is created in ctx's context group, with the same global object class.
+@param exception A pointer to a TiValueRef in which to store an exception, if any. Pass NULL if you do not care to store an exception.
+@result The new global context, or NULL if ctx could not be copied.
+@discussion Equivalent to writing a snapshot of ctx and reading it into a new context, except that the snapshot is kept in memory, and may hold functions made with TiObjectMakeFunctionWithCallback and objects of API classes without private data, which are shared with the copy.
+
+Copying fails, storing a TypeError in exception, if ctx holds arguments objects, objects of API classes with private data, constructors made with TiObjectMakeConstructor or values from other global objects, or if Ti is executing in ctx's context group.
+*/
+JS_EXPORT TiGlobalContextRef TiGlobalContextCreateCopy(TiContextRef ctx, TiValueRef* exception);
+
+/*!
+@function
+@abstract Stops the script running in a context's context group.
+@param ctx A TiContext in the context group whose running script should stop.
+@discussion This function may be called from any thread, or from a signal handler, without waiting for the script to finish. The script throws an exception that it can not catch at its next loop iteration or function call, unwinding all script frames back to the API call that started it, which returns the exception. A native function that is running, such as a long sort, finishes first.
+
+If no script is running, the next script to run in the context group is stopped.
+*/
+JS_EXPORT void TiContextRequestTermination(TiContextRef ctx);
+
 #ifdef __cplusplus
 }
 #endif
@@ -33,6 +33,7 @@
 
 #include "config.h"
 #include "TiObjectRef.h"
+#include "TiObjectRefPrivate.h"
 
 #include "APICast.h"
 #include "CodeBlock.h"
@@ -343,6 +344,154 @@ void TiObjectSetPropertyAtIndex(TiContextRef ctx, TiObjectRef object, unsigned p
     }
 }
 
+struct OpaqueTiPropertyKey : FastAllocBase {
+    OpaqueTiPropertyKey(TiGlobalData* globalData, const Identifier& name)
+        : refCount(0)
+        , globalData(globalData)
+        , name(name)
+        , getOffset(0)
+        , putOffset(0)
+    {
+    }
+
+    unsigned refCount;
+    RefPtr<TiGlobalData> globalData;
+    Identifier name;
+
+    // The structure of the last object whose own property was found, or
+    // replaced, at a known offset. Dictionary structures are not cached,
+    // because their properties move without a change of structure.
+    RefPtr<Structure> getStructure;
+    size_t getOffset;
+    RefPtr<Structure> putStructure;
+    size_t putOffset;
+};
+
+TiPropertyKeyRef TiPropertyKeyCreate(TiContextGroupRef group, TiStringRef propertyName)
+{
+    initializeThreading();
+
+    TiGlobalData* globalData = toJS(group);
+    TiLock lock(globalData);
+
+    return TiPropertyKeyRetain(new OpaqueTiPropertyKey(globalData, propertyName->identifier(globalData)));
+}
+
+TiPropertyKeyRef TiPropertyKeyRetain(TiPropertyKeyRef key)
+{
+    TiLock lock(key->globalData.get());
+
+    ++key->refCount;
+    return key;
+}
+
+void TiPropertyKeyRelease(TiPropertyKeyRef key)
+{
+    // The key may hold the last reference to its group.
+    RefPtr<TiGlobalData> protect(key->globalData);
+    TiLock lock(protect.get());
+
+    if (--key->refCount == 0)
+        delete key;
+}
+
+static TiObject* createKeyGroupMismatchError(TiExcState* exec)
+{
+    return Error::create(exec, TypeError, "Property key belongs to a different context group", -1, -1, 0);
+}
+
+static TiValue getProperty(TiExcState* exec, TiObject* object, OpaqueTiPropertyKey* key)
+{
+    Structure* structure = object->structure();
+    if (structure == key->getStructure)
+        return object->getDirectOffset(key->getOffset);
+
+    PropertySlot slot(object);
+    TiValue value = TiValue(object).get(exec, key->name, slot);
+    if (slot.isCacheable() && slot.slotBase() == object && object->structure() == structure && !structure->isDictionary()) {
+        key->getStructure = structure;
+        key->getOffset = slot.cachedOffset();
+    }
+    return value;
+}
+
+static void putProperty(TiExcState* exec, TiObject* object, OpaqueTiPropertyKey* key, TiValue value)
+{
+    Structure* structure = object->structure();
+    if (structure == key->putStructure) {
+        object->putDirectOffset(key->putOffset, value);
+        return;
+    }
+
+    PutPropertySlot slot;
+    object->put(exec, key->name, value, slot);
+    if (slot.type() == PutPropertySlot::ExistingProperty && slot.base() == object && object->structure() == structure && !structure->isDictionary()) {
+        key->putStructure = structure;
+        key->putOffset = slot.cachedOffset();
+    }
+}
+
+void TiObjectGetProperties(TiContextRef ctx, TiObjectRef object, const TiPropertyKeyRef keys[], size_t count, TiValueRef values[], TiValueRef* exception)
+{
+    TiExcState* exec = toJS(ctx);
+    exec->globalData().heap.registerThread();
+    TiLock lock(exec);
+
+    TiObject* jsObject = toJS(object);
+
+    // A getter may allocate, so the values are kept in a marked list until every property
+    // has been got; TiValueRefs already stored in values would not be seen by the collector.
+    MarkedArgumentBuffer results;
+    for (size_t i = 0; i < count; ++i) {
+        if (keys[i]->globalData != &exec->globalData()) {
+            if (exception)
+                *exception = toRef(exec, createKeyGroupMismatchError(exec));
+            break;
+        }
+        TiValue jsValue = getProperty(exec, jsObject, keys[i]);
+        if (exec->hadException()) {
+            if (exception)
+                *exception = toRef(exec, exec->exception());
+            exec->clearException();
+            break;
+        }
+        results.append(jsValue);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+        values[i] = toRef(exec, i < results.size() ? results.at(i) : jsUndefined());
+}
+
+void TiObjectSetProperties(TiContextRef ctx, TiObjectRef object, const TiPropertyKeyRef keys[], size_t count, const TiValueRef values[], TiPropertyAttributes attributes, TiValueRef* exception)
+{
+    TiExcState* exec = toJS(ctx);
+    exec->globalData().heap.registerThread();
+    TiLock lock(exec);
+
+    TiObject* jsObject = toJS(object);
+
+    for (size_t i = 0; i < count; ++i) {
+        if (keys[i]->globalData != &exec->globalData()) {
+            if (exception)
+                *exception = toRef(exec, createKeyGroupMismatchError(exec));
+            return;
+        }
+        TiValue jsValue = toJS(exec, values[i]);
+
+        if (attributes && !jsObject->hasProperty(exec, keys[i]->name))
+            jsObject->putWithAttributes(exec, keys[i]->name, jsValue, attributes);
+        else
+            putProperty(exec, jsObject, keys[i], jsValue);
+
+        if (exec->hadException()) {
+            if (exception)
+                *exception = toRef(exec, exec->exception());
+            exec->clearException();
+            return;
+        }
+    }
+}
+
 bool TiObjectDeleteProperty(TiContextRef ctx, TiObjectRef object, TiStringRef propertyName, TiValueRef* exception)
 {
     TiExcState* exec = toJS(ctx);
@@ -499,7 +648,7 @@ TiPropertyNameArrayRef TiPropertyNameArrayRetain(TiPropertyNameArrayRef array)
 void TiPropertyNameArrayRelease(TiPropertyNameArrayRef array)
 {
     if (--array->refCount == 0) {
-        TiLock lock(array->globalData->isSharedInstance ? LockForReal : SilenceAssertionsOnly);
+        TiLock lock(array->globalData);
         delete array;
     }
 }
@@ -519,7 +668,7 @@ void TiPropertyNameAccumulatorAddName(TiPropertyNameAccumulatorRef array, TiStri
     PropertyNameArray* propertyNames = toJS(array);
 
     propertyNames->globalData()->heap.registerThread();
-    TiLock lock(propertyNames->globalData()->isSharedInstance ? LockForReal : SilenceAssertionsOnly);
+    TiLock lock(propertyNames->globalData());
 
     propertyNames->add(propertyName->identifier(propertyNames->globalData()));
 }
@@ -0,0 +1,102 @@
+/**
+ * Appcelerator Titanium License
+ * This source code and all modifications done by Appcelerator
+ * are licensed under the Apache Public License (version 2) and
+ * are Copyright (c) 2009 by Appcelerator, Inc.
+ */
+
+/*
+ * Copyright (C) 2009 Apple Computer, Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE COMPUTER, INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE COMPUTER, INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+
+#ifndef TiObjectRefPrivate_h
+#define TiObjectRefPrivate_h
+
+#include <TiCore/TiObjectRef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @typedef TiPropertyKeyRef A property name prepared for repeated use with objects in one context group. */
+typedef struct OpaqueTiPropertyKey* TiPropertyKeyRef;
+
+/*!
+@function
+@abstract Creates a property key.
+@param group The TiContextGroup whose objects the key will be used with.
+@param propertyName A TiString containing the property's name.
+@result A TiPropertyKey with a retain count of 1. Ownership follows the Create Rule.
+@discussion A property key holds its name in the form the engine looks properties up by, so using it does not hash or intern the name again. It also remembers where it last found the property, so getting or setting it on objects of the same shape goes straight to the property's storage.
+*/
+JS_EXPORT TiPropertyKeyRef TiPropertyKeyCreate(TiContextGroupRef group, TiStringRef propertyName);
+
+/*!
+@function
+@abstract Retains a property key.
+@param key The TiPropertyKey to retain.
+@result A TiPropertyKey that is the same as key.
+*/
+JS_EXPORT TiPropertyKeyRef TiPropertyKeyRetain(TiPropertyKeyRef key);
+
+/*!
+@function
+@abstract Releases a property key.
+@param key The TiPropertyKey to release.
+*/
+JS_EXPORT void TiPropertyKeyRelease(TiPropertyKeyRef key);
+
+/*!
+@function
+@abstract Gets several properties from an object.
+@param ctx The execution context to use. It must belong to the context group the keys were created for.
+@param object The TiObject whose properties you want to get.
+@param keys An array of count TiPropertyKeys naming the properties to get.
+@param count The number of properties to get.
+@param values An array of count TiValueRefs in which to store the properties' values, in the order of keys. A property that is not found is stored as undefined.
+@param exception A pointer to a TiValueRef in which to store an exception, if any. Pass NULL if you do not care to store an exception.
+@discussion Equivalent to calling TiObjectGetProperty for each key in turn, but done under a single lock acquisition. If getting a property throws, or a key was created for a different context group (which stores a TypeError in exception), the remaining properties are not got and their entries in values are set to undefined.
+*/
+JS_EXPORT void TiObjectGetProperties(TiContextRef ctx, TiObjectRef object, const TiPropertyKeyRef keys[], size_t count, TiValueRef values[], TiValueRef* exception);
+
+/*!
+@function
+@abstract Sets several properties on an object.
+@param ctx The execution context to use. It must belong to the context group the keys were created for.
+@param object The TiObject whose properties you want to set.
+@param keys An array of count TiPropertyKeys naming the properties to set.
+@param count The number of properties to set.
+@param values An array of count TiValues to use as the properties' values, in the order of keys.
+@param attributes A logically ORed set of TiPropertyAttributes to give to properties that do not already exist.
+@param exception A pointer to a TiValueRef in which to store an exception, if any. Pass NULL if you do not care to store an exception.
+@discussion Equivalent to calling TiObjectSetProperty for each key in turn, but done under a single lock acquisition. If setting a property throws, or a key was created for a different context group (which stores a TypeError in exception), the remaining properties are not set.
+*/
+JS_EXPORT void TiObjectSetProperties(TiContextRef ctx, TiObjectRef object, const TiPropertyKeyRef keys[], size_t count, const TiValueRef values[], TiPropertyAttributes attributes, TiValueRef* exception);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TiObjectRefPrivate_h */
@@ -0,0 +1,147 @@
+/**
+ * Appcelerator Titanium License
+ * This source code and all modifications done by Appcelerator
+ * are licensed under the Apache Public License (version 2) and
+ * are Copyright (c) 2009 by Appcelerator, Inc.
+ */
+
+/*
+ * Copyright (C) 2009 Apple Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE COMPUTER, INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE COMPUTER, INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "TiSerializedValuePrivate.h"
+
+#include "APICast.h"
+#include "Error.h"
+#include "SerializedValue.h"
+#include "TiArrayArray.h"
+#include "TiGlobalObject.h"
+#include "TiLock.h"
+#include <wtf/ByteArray.h>
+
+using namespace TI;
+using namespace WTI;
+
+static inline SerializedValue* toJS(TiSerializedValueRef serialized)
+{
+    return reinterpret_cast<SerializedValue*>(serialized);
+}
+
+static inline TiSerializedValueRef toRef(SerializedValue* serialized)
+{
+    return reinterpret_cast<TiSerializedValueRef>(serialized);
+}
+
+TiSerializedValueRef TiValueSerialize(TiContextRef ctx, TiValueRef value, const TiObjectRef transfer[], size_t transferCount, TiValueRef* exception)
+{
+    TiExcState* exec = toJS(ctx);
+    exec->globalData().heap.registerThread();
+    TiLock lock(exec);
+
+    Vector<TiArrayArray*> transferList;
+    for (size_t i = 0; i < transferCount; ++i) {
+        TiObject* object = toJS(transfer[i]);
+        if (!isTiArrayArray(&exec->globalData(), object)) {
+            if (exception)
+                *exception = toRef(exec, Error::create(exec, TypeError, "Only byte arrays can be transferred", -1, -1, 0));
+            return 0;
+        }
+        transferList.append(asByteArray(object));
+    }
+
+    RefPtr<SerializedValue> serialized = SerializedValue::create(exec, toJS(exec, value), transferList);
+    if (exec->hadException()) {
+        if (exception)
+            *exception = toRef(exec, exec->exception());
+        exec->clearException();
+        return 0;
+    }
+    return toRef(serialized.release().releaseRef());
+}
+
+TiValueRef TiValueDeserialize(TiContextRef ctx, TiSerializedValueRef serialized, TiValueRef* exception)
+{
+    TiExcState* exec = toJS(ctx);
+    exec->globalData().heap.registerThread();
+    TiLock lock(exec);
+
+    TiValue result = toJS(serialized)->deserialize(exec);
+    if (exec->hadException()) {
+        if (exception)
+            *exception = toRef(exec, exec->exception());
+        exec->clearException();
+        return 0;
+    }
+    return toRef(exec, result);
+}
+
+const unsigned char* TiSerializedValueGetData(TiSerializedValueRef serialized, size_t* length)
+{
+    *length = toJS(serialized)->size();
+    return toJS(serialized)->data();
+}
+
+TiSerializedValueRef TiSerializedValueCreateWithData(const unsigned char* data, size_t length)
+{
+    return toRef(SerializedValue::create(data, length).releaseRef());
+}
+
+TiSerializedValueRef TiSerializedValueRetain(TiSerializedValueRef serialized)
+{
+    toJS(serialized)->ref();
+    return serialized;
+}
+
+void TiSerializedValueRelease(TiSerializedValueRef serialized)
+{
+    toJS(serialized)->deref();
+}
+
+TiObjectRef TiObjectMakeByteArray(TiContextRef ctx, size_t length)
+{
+    TiExcState* exec = toJS(ctx);
+    exec->globalData().heap.registerThread();
+    TiLock lock(exec);
+
+    RefPtr<ByteArray> storage = ByteArray::create(length);
+    memset(storage->data(), 0, length);
+    return toRef(new (exec) TiArrayArray(exec, exec->lexicalGlobalObject()->byteArrayStructure(), storage.get()));
+}
+
+unsigned char* TiObjectGetByteArrayData(TiContextRef ctx, TiObjectRef object, size_t* length)
+{
+    TiExcState* exec = toJS(ctx);
+    exec->globalData().heap.registerThread();
+    TiLock lock(exec);
+
+    TiObject* jsObject = toJS(object);
+    if (!isTiArrayArray(&exec->globalData(), jsObject))
+        return 0;
+
+    TiArrayArray* byteArray = asByteArray(jsObject);
+    if (length)
+        *length = byteArray->length();
+    return byteArray->storage()->data();
+}
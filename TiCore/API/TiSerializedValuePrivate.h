@@ -0,0 +1,133 @@
+/**
+ * Appcelerator Titanium License
+ * This source code and all modifications done by Appcelerator
+ * are licensed under the Apache Public License (version 2) and
+ * are Copyright (c) 2009 by Appcelerator, Inc.
+ */
+
+/*
+ * Copyright (C) 2009 Apple Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE COMPUTER, INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE COMPUTER, INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#ifndef TiSerializedValuePrivate_h
+#define TiSerializedValuePrivate_h
+
+#include <TiCore/TiBase.h>
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @typedef TiSerializedValueRef A value copied out of a context, which can be passed to another thread and copied into a context in any context group. */
+typedef struct OpaqueTiSerializedValue* TiSerializedValueRef;
+
+/*!
+@function
+@abstract Copies a value out of a context using the structured clone algorithm.
+@param ctx The execution context to use.
+@param value The TiValue to copy.
+@param transfer An array of byte arrays whose contents should move into the serialized value instead of being copied, or NULL.
+@param transferCount The number of byte arrays in transfer.
+@param exception A pointer to a TiValueRef in which to store an exception, if any. Pass NULL if you do not care to store an exception.
+@result The serialized value, or NULL if value could not be serialized. Release it with TiSerializedValueRelease.
+@discussion Undefined, null, booleans, numbers, strings, objects, arrays, Dates, RegExps, Boolean, Number and String objects, and byte arrays can be serialized, along with cycles and shared references between them. Only the enumerable properties that objects and arrays have themselves are copied. Functions and other objects can not be serialized.
+
+Each transferred byte array is left empty once value has been serialized. Byte arrays whose contents are still used by the embedder are copied instead.
+*/
+JS_EXPORT TiSerializedValueRef TiValueSerialize(TiContextRef ctx, TiValueRef value, const TiObjectRef transfer[], size_t transferCount, TiValueRef* exception);
+
+/*!
+@function
+@abstract Creates a copy of a serialized value in a context.
+@param ctx The execution context to use.
+@param serialized The TiSerializedValue to copy.
+@param exception A pointer to a TiValueRef in which to store an exception, if any. Pass NULL if you do not care to store an exception.
+@result The copy, or NULL if an exception is thrown.
+@discussion A serialized value can be copied any number of times, on any thread. The contents of transferred byte arrays move into the first copy; later copies hold empty byte arrays in their place.
+*/
+JS_EXPORT TiValueRef TiValueDeserialize(TiContextRef ctx, TiSerializedValueRef serialized, TiValueRef* exception);
+
+/*!
+@function
+@abstract Gets the bytes of a serialized value.
+@param serialized The TiSerializedValue whose bytes to get.
+@param length A pointer to a size_t in which to store the number of bytes.
+@result A pointer to the bytes, which stays valid as long as serialized does.
+@discussion The bytes can be stored or sent to another process, and turned back into a serialized value with TiSerializedValueCreateWithData. They do not hold the contents of transferred byte arrays.
+*/
+JS_EXPORT const unsigned char* TiSerializedValueGetData(TiSerializedValueRef serialized, size_t* length);
+
+/*!
+@function
+@abstract Creates a serialized value from bytes got from TiSerializedValueGetData.
+@param data The bytes, which are copied.
+@param length The number of bytes in data.
+@result A TiSerializedValue with a retain count of 1. Ownership follows the Create Rule.
+@discussion The bytes must have been made by the same version of TiCore, on a machine with the same byte order. Transferred byte arrays deserialize as empty byte arrays. Bytes that do not hold a serialized value are not detected until TiValueDeserialize, which then throws an exception.
+*/
+JS_EXPORT TiSerializedValueRef TiSerializedValueCreateWithData(const unsigned char* data, size_t length);
+
+/*!
+@function
+@abstract Retains a serialized value.
+@param serialized The TiSerializedValue to retain.
+@result A TiSerializedValue that is the same as serialized.
+*/
+JS_EXPORT TiSerializedValueRef TiSerializedValueRetain(TiSerializedValueRef serialized);
+
+/*!
+@function
+@abstract Releases a serialized value.
+@param serialized The TiSerializedValue to release.
+*/
+JS_EXPORT void TiSerializedValueRelease(TiSerializedValueRef serialized);
+
+/*!
+@function
+@abstract Creates a byte array, whose indexed properties are bytes stored outside the garbage collected heap.
+@param ctx The execution context to use.
+@param length The number of bytes in the array, all of them initially 0.
+@result A TiObject that is a byte array.
+*/
+JS_EXPORT TiObjectRef TiObjectMakeByteArray(TiContextRef ctx, size_t length);
+
+/*!
+@function
+@abstract Gets the bytes of a byte array.
+@param ctx The execution context to use.
+@param object The TiObject whose bytes to get.
+@param length A pointer to a size_t in which to store the number of bytes. Pass NULL if you do not care to store it.
+@result A pointer to the bytes, which stays valid until the byte array is garbage collected or transferred, or NULL if object is not a byte array.
+*/
+JS_EXPORT unsigned char* TiObjectGetByteArrayData(TiContextRef ctx, TiObjectRef object, size_t* length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TiSerializedValuePrivate_h */
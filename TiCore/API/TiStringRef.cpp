@@ -32,6 +32,7 @@
 
 #include "config.h"
 #include "TiStringRef.h"
+#include "TiStringRefPrivate.h"
 
 #include "InitializeThreading.h"
 #include "OpaqueTiString.h"
@@ -50,17 +51,25 @@ TiStringRef TiStringCreateWithUTF8CString(const char* string)
 {
     initializeThreading();
     if (string) {
+        // Convert straight into the buffer the string will own.
         size_t length = strlen(string);
-        Vector<UChar, 1024> buffer(length);
-        UChar* p = buffer.data();
+        UChar* buffer = static_cast<UChar*>(fastMalloc(length * sizeof(UChar)));
+        UChar* p = buffer;
         if (conversionOK == convertUTF8ToUTF16(&string, string + length, &p, p + length))
-            return OpaqueTiString::create(buffer.data(), p - buffer.data()).releaseRef();
+            return OpaqueTiString::adopt(buffer, p - buffer).releaseRef();
+        fastFree(buffer);
     }
 
     // Null string.
     return OpaqueTiString::create().releaseRef();
 }
 
+TiStringRef TiStringCreateWithCharactersNoCopy(TiChar* chars, size_t numChars, TiStringFinalizer finalizer, void* context)
+{
+    initializeThreading();
+    return OpaqueTiString::createExternal(chars, numChars, finalizer, context).releaseRef();
+}
+
 TiStringRef TiStringRetain(TiStringRef string)
 {
     string->ref();
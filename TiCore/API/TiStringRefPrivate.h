@@ -0,0 +1,69 @@
+/**
+ * Appcelerator Titanium License
+ * This source code and all modifications done by Appcelerator
+ * are licensed under the Apache Public License (version 2) and
+ * are Copyright (c) 2009 by Appcelerator, Inc.
+ */
+
+/*
+ * Copyright (C) 2009 Apple Computer, Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE COMPUTER, INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE COMPUTER, INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+
+#ifndef TiStringRefPrivate_h
+#define TiStringRefPrivate_h
+
+#include <TiCore/TiStringRef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+@typedef TiStringFinalizer
+@abstract The callback invoked when a string made with TiStringCreateWithCharactersNoCopy no longer uses its characters.
+@param chars The characters passed to TiStringCreateWithCharactersNoCopy.
+@param numChars The number of characters passed to TiStringCreateWithCharactersNoCopy.
+@param context The context passed to TiStringCreateWithCharactersNoCopy.
+@discussion The callback may be invoked on any thread, and must not call back into Ti.
+*/
+typedef void (*TiStringFinalizer)(TiChar* chars, size_t numChars, void* context);
+
+/*!
+@function
+@abstract Creates a Ti string that uses a buffer of Unicode characters without copying it.
+@param chars The buffer of Unicode characters to use. It must stay valid and unchanged until finalizer is called.
+@param numChars The number of characters in chars.
+@param finalizer The function to call once neither the TiString nor any Ti value made from it uses chars, or NULL if chars need not be released.
+@param context A pointer passed to finalizer.
+@result A TiString using chars. Ownership follows the Create Rule.
+@discussion Ti strings made from the result with TiValueMakeString share chars rather than copying them, so the characters may be used long after the TiString is released. Ti stores strings as UTF-16, so text in other encodings has to be converted before it can be passed here.
+*/
+JS_EXPORT TiStringRef TiStringCreateWithCharactersNoCopy(TiChar* chars, size_t numChars, TiStringFinalizer finalizer, void* context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TiStringRefPrivate_h */
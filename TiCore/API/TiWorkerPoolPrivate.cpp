@@ -0,0 +1,222 @@
+/**
+ * Appcelerator Titanium License
+ * This source code and all modifications done by Appcelerator
+ * are licensed under the Apache Public License (version 2) and
+ * are Copyright (c) 2009 by Appcelerator, Inc.
+ */
+
+/*
+ * Copyright (C) 2009 Apple Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE COMPUTER, INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE COMPUTER, INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "TiWorkerPoolPrivate.h"
+
+#include "APICast.h"
+#include "Completion.h"
+#include "Error.h"
+#include "InitializeThreading.h"
+#include "JSONObject.h"
+#include "LiteralParser.h"
+#include "OpaqueTiString.h"
+#include "SourceCode.h"
+#include "TiContextRef.h"
+#include "TiContextRefPrivate.h"
+#include "TiGlobalObject.h"
+#include "TiLock.h"
+#include <wtf/MainThread.h>
+#include <wtf/MessageQueue.h>
+#include <wtf/OwnPtr.h>
+#include <wtf/PassOwnPtr.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+using namespace TI;
+
+struct TiWorkerPoolJob : FastAllocBase {
+    RefPtr<OpaqueTiString> script;
+    RefPtr<OpaqueTiString> sourceURL;
+    RefPtr<OpaqueTiString> message;
+    TiWorkerPoolJobCallback callback;
+    void* userData;
+
+    RefPtr<OpaqueTiString> result;
+    RefPtr<OpaqueTiString> exception;
+};
+
+struct OpaqueTiWorkerPool : FastAllocBase {
+    OpaqueTiWorkerPool(TiWorkerPoolInitializeCallback initialize, void* userData, bool callbacksOnMainThread)
+        : initialize(initialize)
+        , userData(userData)
+        , callbacksOnMainThread(callbacksOnMainThread)
+    {
+    }
+
+    void start(unsigned threadCount);
+    void stop();
+
+    TiWorkerPoolInitializeCallback initialize;
+    void* userData;
+    bool callbacksOnMainThread;
+
+    MessageQueue<TiWorkerPoolJob> jobs;
+    Vector<ThreadIdentifier> threads;
+
+private:
+    static void* workerThread(void*);
+    void runJobs();
+    TiGlobalContextRef createContext(TiContextGroupRef);
+};
+
+static void completeJob(void* context)
+{
+    OwnPtr<TiWorkerPoolJob> job(static_cast<TiWorkerPoolJob*>(context));
+    job->callback(job->result.get(), job->exception.get(), job->userData);
+}
+
+static void runJob(TiGlobalContextRef ctx, TiWorkerPoolJob* job)
+{
+    TiExcState* exec = toJS(ctx);
+    TiLock lock(exec);
+
+    TiGlobalObject* globalObject = exec->lexicalGlobalObject();
+    exec = globalObject->globalExec();
+
+    Completion completion;
+    if (job->message) {
+        TiValue message = LiteralParser(exec, job->message->ustring(), LiteralParser::StrictJSON).tryLiteralParse();
+        if (!message)
+            completion = Completion(Throw, Error::create(exec, SyntaxError, "Unable to parse JSON message", -1, -1, 0));
+        else {
+            PutPropertySlot slot;
+            globalObject->put(exec, Identifier(exec, "message"), message, slot);
+        }
+    }
+
+    if (completion.complType() != Throw) {
+        SourceCode source = makeSource(job->script->ustring(), job->sourceURL ? job->sourceURL->ustring() : UString(), 1);
+        completion = evaluate(exec, globalObject->globalScopeChain(), source, globalObject);
+    }
+
+    if (completion.complType() == Throw || completion.complType() == Interrupted) {
+        job->exception = OpaqueTiString::create(completion.value().toString(exec));
+        exec->clearException();
+        return;
+    }
+
+    if (completion.value())
+        job->result = OpaqueTiString::create(JSONStringify(exec, completion.value(), 0));
+    if (exec->hadException()) {
+        job->exception = OpaqueTiString::create(exec->exception().toString(exec));
+        exec->clearException();
+    }
+}
+
+void OpaqueTiWorkerPool::start(unsigned threadCount)
+{
+    for (unsigned i = 0; i < threadCount; ++i)
+        threads.append(createThread(workerThread, this, "Ti Worker Pool"));
+}
+
+void OpaqueTiWorkerPool::stop()
+{
+    // A null job stops the thread that takes it, after every job queued before it.
+    for (size_t i = 0; i < threads.size(); ++i)
+        jobs.append(0);
+    for (size_t i = 0; i < threads.size(); ++i)
+        waitForThreadCompletion(threads[i], 0);
+}
+
+void* OpaqueTiWorkerPool::workerThread(void* pool)
+{
+    static_cast<OpaqueTiWorkerPool*>(pool)->runJobs();
+    return 0;
+}
+
+TiGlobalContextRef OpaqueTiWorkerPool::createContext(TiContextGroupRef group)
+{
+    TiGlobalContextRef ctx = TiGlobalContextCreateInGroup(group, 0);
+    if (initialize)
+        initialize(ctx, userData);
+    return ctx;
+}
+
+void OpaqueTiWorkerPool::runJobs()
+{
+    TiContextGroupRef group = TiContextGroupCreate();
+    TiGlobalContextRef initialContext = createContext(group);
+    // The worker's contexts keep the group alive from here on, so that releasing
+    // the initial context last also destroys the group's heap.
+    TiContextGroupRelease(group);
+
+    TiGlobalContextRef copy = TiGlobalContextCreateCopy(initialContext, 0);
+    bool canCopy = copy;
+
+    while (OwnPtr<TiWorkerPoolJob> job = jobs.waitForMessage()) {
+        TiGlobalContextRef ctx;
+        if (copy) {
+            ctx = copy;
+            copy = 0;
+        } else
+            ctx = canCopy ? TiGlobalContextCreateCopy(initialContext, 0) : createContext(TiContextGetGroup(initialContext));
+
+        runJob(ctx, job.get());
+        TiGlobalContextRelease(ctx);
+
+        if (callbacksOnMainThread)
+            callOnMainThread(completeJob, job.release());
+        else
+            completeJob(job.release());
+    }
+
+    if (copy)
+        TiGlobalContextRelease(copy);
+    TiGlobalContextRelease(initialContext);
+}
+
+TiWorkerPoolRef TiWorkerPoolCreate(unsigned threadCount, TiWorkerPoolInitializeCallback initialize, void* userData, bool callbacksOnMainThread)
+{
+    initializeThreading();
+
+    OpaqueTiWorkerPool* pool = new OpaqueTiWorkerPool(initialize, userData, callbacksOnMainThread);
+    pool->start(threadCount);
+    return pool;
+}
+
+void TiWorkerPoolSubmitJob(TiWorkerPoolRef pool, TiStringRef script, TiStringRef sourceURL, TiStringRef message, TiWorkerPoolJobCallback callback, void* userData)
+{
+    TiWorkerPoolJob* job = new TiWorkerPoolJob;
+    job->script = script;
+    job->sourceURL = sourceURL;
+    job->message = message;
+    job->callback = callback;
+    job->userData = userData;
+    pool->jobs.append(job);
+}
+
+void TiWorkerPoolRelease(TiWorkerPoolRef pool)
+{
+    pool->stop();
+    delete pool;
+}
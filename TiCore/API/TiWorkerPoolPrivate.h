@@ -0,0 +1,107 @@
+/**
+ * Appcelerator Titanium License
+ * This source code and all modifications done by Appcelerator
+ * are licensed under the Apache Public License (version 2) and
+ * are Copyright (c) 2009 by Appcelerator, Inc.
+ */
+
+/*
+ * Copyright (C) 2009 Apple Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE COMPUTER, INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE COMPUTER, INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#ifndef TiWorkerPoolPrivate_h
+#define TiWorkerPoolPrivate_h
+
+#include <TiCore/TiBase.h>
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @typedef TiWorkerPoolRef A pool of threads that run scripts, each thread in its own context group. */
+typedef struct OpaqueTiWorkerPool* TiWorkerPoolRef;
+
+/*!
+@typedef TiWorkerPoolInitializeCallback
+@abstract The callback invoked on each worker thread to set up the worker's context.
+@param ctx The worker's global context.
+@param userData The userData passed to TiWorkerPoolCreate.
+@discussion Use this callback to add native functions and to evaluate the scripts every job needs. Each job runs in a copy of ctx made with TiGlobalContextCreateCopy, so jobs can not see each other's changes. If ctx can not be copied, each job runs in a new context that this callback is invoked again to set up.
+*/
+typedef void
+(*TiWorkerPoolInitializeCallback) (TiGlobalContextRef ctx, void* userData);
+
+/*!
+@typedef TiWorkerPoolJobCallback
+@abstract The callback invoked when a job has finished.
+@param result A TiString containing the JSON text of the job script's completion value, or NULL if the script threw an exception or its completion value has no JSON text.
+@param exception A TiString containing the exception the job script threw, converted to a string, or NULL.
+@param userData The userData passed to TiWorkerPoolSubmitJob.
+@discussion The strings are released after the callback returns. Retain them to keep them longer.
+*/
+typedef void
+(*TiWorkerPoolJobCallback) (TiStringRef result, TiStringRef exception, void* userData);
+
+/*!
+@function
+@abstract Creates a pool of threads that run scripts.
+@param threadCount The number of threads in the pool.
+@param initialize The callback to set up each worker's context, or NULL.
+@param userData A pointer passed to initialize.
+@param callbacksOnMainThread true to invoke job callbacks on the main thread through callOnMainThread, false to invoke them on the worker thread that ran the job.
+@result The new worker pool. Release it with TiWorkerPoolRelease.
+@discussion Each thread has its own context group, so the threads run and collect garbage in parallel without sharing any locks.
+*/
+JS_EXPORT TiWorkerPoolRef TiWorkerPoolCreate(unsigned threadCount, TiWorkerPoolInitializeCallback initialize, void* userData, bool callbacksOnMainThread);
+
+/*!
+@function
+@abstract Queues a script to run on the next free thread of a worker pool.
+@param pool The TiWorkerPool to run the script on.
+@param script A TiString containing the script to evaluate.
+@param sourceURL A TiString containing a URL for the script's source file, used only when reporting exceptions. Pass NULL if you do not care to include source file information in exceptions.
+@param message A TiString containing JSON text. The script sees the parsed value as the global variable "message". Pass NULL to leave "message" undefined.
+@param callback The callback invoked with the job's result.
+@param userData A pointer passed to callback.
+@discussion This function may be called from any thread.
+*/
+JS_EXPORT void TiWorkerPoolSubmitJob(TiWorkerPoolRef pool, TiStringRef script, TiStringRef sourceURL, TiStringRef message, TiWorkerPoolJobCallback callback, void* userData);
+
+/*!
+@function
+@abstract Runs every job already submitted to a worker pool, then stops its threads and destroys it.
+@param pool The TiWorkerPool to release.
+@discussion Callbacks for jobs that complete on the main thread may still be pending when this function returns.
+*/
+JS_EXPORT void TiWorkerPoolRelease(TiWorkerPoolRef pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TiWorkerPoolPrivate_h */
@@ -33,6 +33,10 @@
 #include "TiCore.h"
 #include "TiBasePrivate.h"
 #include "TiContextRefPrivate.h"
+#include "TiObjectRefPrivate.h"
+#include "TiSerializedValuePrivate.h"
+#include "TiStringRefPrivate.h"
+#include "TiWorkerPoolPrivate.h"
 #include <math.h>
 #define ASSERT_DISABLED 0
 #include <wtf/Assertions.h>
@@ -744,6 +748,477 @@ static void testInitializeFinalize()
     ASSERT(TiObjectGetPrivate(o) == (void*)3);
 }
 
+static TiValueRef evaluateScript(TiContextRef ctx, const char* source, TiValueRef* exception)
+{
+    TiStringRef script = TiStringCreateWithUTF8CString(source);
+    TiValueRef result = TiEvalScript(ctx, script, NULL, NULL, 1, exception);
+    TiStringRelease(script);
+    return result;
+}
+
+// Like assertEqualsAsUTF8String, for values from contexts other than context.
+static void assertEqualsAsUTF8StringInContext(TiContextRef ctx, TiValueRef value, const char* expectedValue)
+{
+    TiStringRef valueAsString = value ? TiValueToStringCopy(ctx, value, NULL) : NULL;
+    if (!valueAsString || !TiStringIsEqualToUTF8CString(valueAsString, expectedValue)) {
+        fprintf(stderr, "assertEqualsAsUTF8StringInContext failed: %p, %s\n", value, expectedValue);
+        failed = 1;
+    }
+    if (valueAsString)
+        TiStringRelease(valueAsString);
+}
+
+static TiValueRef terminate_callAsFunction(TiContextRef ctx, TiObjectRef function, TiObjectRef thisObject, size_t argumentCount, const TiValueRef arguments[], TiValueRef* exception)
+{
+    UNUSED_PARAM(function);
+    UNUSED_PARAM(thisObject);
+    UNUSED_PARAM(argumentCount);
+    UNUSED_PARAM(arguments);
+    UNUSED_PARAM(exception);
+
+    TiContextRequestTermination(ctx);
+    return TiValueMakeUndefined(ctx);
+}
+
+static void testTermination()
+{
+    TiGlobalContextRef terminationContext = TiGlobalContextCreateInGroup(NULL, NULL);
+    TiStringRef terminateName = TiStringCreateWithUTF8CString("terminate");
+    TiObjectSetProperty(terminationContext, TiContextGetGlobalObject(terminationContext), terminateName, TiObjectMakeFunctionWithCallback(terminationContext, terminateName, terminate_callAsFunction), kTiPropertyAttributeNone, NULL);
+    TiStringRelease(terminateName);
+
+    // The running loop stops, and can not catch the exception.
+    TiValueRef exception = NULL;
+    TiValueRef result = evaluateScript(terminationContext, "var iterations = 0, caught = false; try { while (true) { if (++iterations == 1000) terminate(); } } catch (e) { caught = true; } 'finished'", &exception);
+    ASSERT(!result);
+    assertEqualsAsUTF8StringInContext(terminationContext, exception, "Ti execution was terminated.");
+    assertEqualsAsUTF8StringInContext(terminationContext, evaluateScript(terminationContext, "iterations + ' ' + caught", NULL), "1000 false");
+
+    // Termination requested while no script runs stops the next script only.
+    TiContextRequestTermination(terminationContext);
+    exception = NULL;
+    result = evaluateScript(terminationContext, "for (var i = 0; i < 10; ++i) { } 'finished'", &exception);
+    ASSERT(!result);
+    assertEqualsAsUTF8StringInContext(terminationContext, exception, "Ti execution was terminated.");
+    assertEqualsAsUTF8StringInContext(terminationContext, evaluateScript(terminationContext, "for (var i = 0; i < 10; ++i) { } 'finished'", NULL), "finished");
+
+    TiGlobalContextRelease(terminationContext);
+}
+
+static unsigned resourceLimitCallbackCount;
+static bool raiseHeapSizeLimit_callback(TiContextGroupRef group, TiResourceLimit limit, void* userData)
+{
+    TiResourceLimits* limits = (TiResourceLimits*)userData;
+
+    ++resourceLimitCallbackCount;
+    if (limit != kTiResourceLimitHeapSize)
+        return true;
+    limits->heapSize *= 64;
+    TiContextGroupSetResourceLimits(group, limits, raiseHeapSizeLimit_callback, userData);
+    return false;
+}
+
+static void testResourceLimits()
+{
+    TiContextGroupRef group = TiContextGroupCreate();
+    TiGlobalContextRef limitedContext = TiGlobalContextCreateInGroup(group, NULL);
+    TiResourceLimits limits = { 0, 0, 0, 0 };
+
+    // A time limit stops an endless loop, which can not catch the exception.
+    limits.executionTime = 0.05;
+    TiContextGroupSetResourceLimits(group, &limits, NULL, NULL);
+    TiValueRef exception = NULL;
+    TiValueRef result = evaluateScript(limitedContext, "var caught = false; try { while (true) { } } catch (e) { caught = true; }", &exception);
+    ASSERT(!result);
+    assertEqualsAsUTF8StringInContext(limitedContext, exception, "Ti execution exceeded timeout.");
+    assertEqualsAsUTF8StringInContext(limitedContext, evaluateScript(limitedContext, "caught", NULL), "false");
+
+    // A heap size limit stops a script that keeps everything it allocates.
+    limits.executionTime = 0;
+    limits.heapSize = 4 * 1024 * 1024;
+    TiContextGroupSetResourceLimits(group, &limits, NULL, NULL);
+    exception = NULL;
+    result = evaluateScript(limitedContext, "var kept = []; while (true) kept.push({ index: kept.length });", &exception);
+    ASSERT(!result);
+    assertEqualsAsUTF8StringInContext(limitedContext, exception, "Ti execution exceeded its heap size limit.");
+    evaluateScript(limitedContext, "kept = null;", NULL);
+    TiGarbageCollect(limitedContext);
+
+    // A callback that raises the limit lets the script go on.
+    resourceLimitCallbackCount = 0;
+    TiContextGroupSetResourceLimits(group, &limits, raiseHeapSizeLimit_callback, &limits);
+    exception = NULL;
+    result = evaluateScript(limitedContext, "var kept = []; for (var i = 0; i < 200000; ++i) kept.push({ index: i }); kept.length", &exception);
+    ASSERT(!exception);
+    assertEqualsAsUTF8StringInContext(limitedContext, result, "200000");
+    ASSERT(resourceLimitCallbackCount == 1);
+
+    TiContextGroupSetResourceLimits(group, NULL, NULL, NULL);
+    TiContextGroupRelease(group);
+    TiGlobalContextRelease(limitedContext);
+}
+
+static TiValueRef deserializeAsGlobal(TiContextRef ctx, TiSerializedValueRef serialized, const char* name)
+{
+    TiValueRef exception = NULL;
+    TiValueRef copy = TiValueDeserialize(ctx, serialized, &exception);
+    ASSERT(copy && !exception);
+    TiStringRef propertyName = TiStringCreateWithUTF8CString(name);
+    TiObjectSetProperty(ctx, TiContextGetGlobalObject(ctx), propertyName, copy, kTiPropertyAttributeNone, NULL);
+    TiStringRelease(propertyName);
+    return copy;
+}
+
+static void testSerialization()
+{
+    TiGlobalContextRef source = TiGlobalContextCreateInGroup(NULL, NULL);
+    TiGlobalContextRef target = TiGlobalContextCreateInGroup(NULL, NULL);
+    TiValueRef exception = NULL;
+
+    // Cycles and shared references, Dates and RegExps survive the copy.
+    TiValueRef value = evaluateScript(source, "var d = new Date(86400000); var o = { name: 'root', list: [1, 'two', null], date: d, sameDate: d, re: /ab+c/gi }; o.self = o; o.list.push(o); o", NULL);
+    TiSerializedValueRef serialized = TiValueSerialize(source, value, NULL, 0, &exception);
+    ASSERT(serialized && !exception);
+    deserializeAsGlobal(target, serialized, "copy");
+    assertEqualsAsUTF8StringInContext(target, evaluateScript(target, "copy.self === copy && copy.list[3] === copy && copy.list.length == 4 && copy.list[1] == 'two'", NULL), "true");
+    assertEqualsAsUTF8StringInContext(target, evaluateScript(target, "copy.date instanceof Date && copy.date.getTime() == 86400000 && copy.sameDate === copy.date", NULL), "true");
+    assertEqualsAsUTF8StringInContext(target, evaluateScript(target, "copy.re instanceof RegExp && copy.re.source == 'ab+c' && copy.re.global && copy.re.ignoreCase && !copy.re.multiline", NULL), "true");
+
+    // Bytes that are not exactly one serialized value are rejected: every
+    // truncation, trailing bytes, and an unknown tag.
+    size_t length;
+    const unsigned char* data = TiSerializedValueGetData(serialized, &length);
+    unsigned char* corrupt = (unsigned char*)malloc(length + 1);
+    memcpy(corrupt, data, length);
+    corrupt[length] = 0;
+    size_t corruptLength;
+    for (corruptLength = 0; corruptLength <= length + 1; ++corruptLength) {
+        if (corruptLength == length)
+            continue;
+        TiSerializedValueRef truncated = TiSerializedValueCreateWithData(corrupt, corruptLength);
+        exception = NULL;
+        ASSERT(!TiValueDeserialize(target, truncated, &exception));
+        ASSERT(exception);
+        TiSerializedValueRelease(truncated);
+    }
+    corrupt[0] = 0xFF;
+    TiSerializedValueRef badTag = TiSerializedValueCreateWithData(corrupt, length);
+    exception = NULL;
+    ASSERT(!TiValueDeserialize(target, badTag, &exception));
+    ASSERT(exception);
+    TiSerializedValueRelease(badTag);
+    free(corrupt);
+
+    // The bytes, copied, give the same value.
+    TiSerializedValueRef copied = TiSerializedValueCreateWithData(data, length);
+    deserializeAsGlobal(target, copied, "copy2");
+    assertEqualsAsUTF8StringInContext(target, evaluateScript(target, "copy2.self === copy2 && copy2 !== copy && copy2.date.getTime() == 86400000", NULL), "true");
+    TiSerializedValueRelease(copied);
+    TiSerializedValueRelease(serialized);
+
+    // Byte arrays are copied, unless they are transferred, which empties them.
+    TiObjectRef byteArray = TiObjectMakeByteArray(source, 4);
+    unsigned char* bytes = TiObjectGetByteArrayData(source, byteArray, &length);
+    ASSERT(length == 4);
+    unsigned i;
+    for (i = 0; i < 4; ++i)
+        bytes[i] = i + 1;
+    serialized = TiValueSerialize(source, byteArray, NULL, 0, NULL);
+    TiObjectGetByteArrayData(source, byteArray, &length);
+    ASSERT(length == 4);
+    deserializeAsGlobal(target, serialized, "bytes");
+    assertEqualsAsUTF8StringInContext(target, evaluateScript(target, "bytes.length + ':' + bytes[0] + bytes[3]", NULL), "4:14");
+    TiSerializedValueRelease(serialized);
+
+    serialized = TiValueSerialize(source, byteArray, &byteArray, 1, NULL);
+    ASSERT(TiObjectGetByteArrayData(source, byteArray, &length) && !length);
+    TiStringRef lengthName = TiStringCreateWithUTF8CString("length");
+    assertEqualsAsUTF8StringInContext(source, TiObjectGetProperty(source, byteArray, lengthName, NULL), "0");
+    TiStringRelease(lengthName);
+    deserializeAsGlobal(target, serialized, "transferred");
+    assertEqualsAsUTF8StringInContext(target, evaluateScript(target, "transferred.length + ':' + transferred[0] + transferred[3]", NULL), "4:14");
+    deserializeAsGlobal(target, serialized, "transferredAgain");
+    assertEqualsAsUTF8StringInContext(target, evaluateScript(target, "transferredAgain.length", NULL), "0");
+    TiSerializedValueRelease(serialized);
+
+    // Functions can not be serialized.
+    exception = NULL;
+    ASSERT(!TiValueSerialize(source, evaluateScript(source, "({ f: function() { } })", NULL), NULL, 0, &exception));
+    ASSERT(exception);
+
+    TiGlobalContextRelease(source);
+    TiGlobalContextRelease(target);
+}
+
+static void workerPool_initialize(TiGlobalContextRef ctx, void* userData)
+{
+    UNUSED_PARAM(userData);
+
+    evaluateScript(ctx, "function reply(message) { return { echo: message.text, doubled: message.number * 2 }; }", NULL);
+}
+
+typedef struct {
+    bool called;
+    char result[64];
+    char exception[64];
+} WorkerPoolJobResult;
+
+static void workerPool_jobDone(TiStringRef result, TiStringRef exception, void* userData)
+{
+    WorkerPoolJobResult* jobResult = (WorkerPoolJobResult*)userData;
+    jobResult->called = true;
+    if (result)
+        TiStringGetUTF8CString(result, jobResult->result, sizeof(jobResult->result));
+    if (exception)
+        TiStringGetUTF8CString(exception, jobResult->exception, sizeof(jobResult->exception));
+}
+
+static void testWorkerPool()
+{
+    WorkerPoolJobResult replyResult = { false, "", "" };
+    WorkerPoolJobResult throwResult = { false, "", "" };
+
+    TiWorkerPoolRef pool = TiWorkerPoolCreate(2, workerPool_initialize, NULL, false);
+    TiStringRef script = TiStringCreateWithUTF8CString("reply(message)");
+    TiStringRef message = TiStringCreateWithUTF8CString("{\"text\": \"hello\", \"number\": 21}");
+    TiWorkerPoolSubmitJob(pool, script, NULL, message, workerPool_jobDone, &replyResult);
+    TiStringRelease(script);
+    TiStringRelease(message);
+    script = TiStringCreateWithUTF8CString("throw new Error('no reply')");
+    TiWorkerPoolSubmitJob(pool, script, NULL, NULL, workerPool_jobDone, &throwResult);
+    TiStringRelease(script);
+
+    // Releasing the pool runs the jobs already submitted.
+    TiWorkerPoolRelease(pool);
+
+    ASSERT(replyResult.called);
+    if (strcmp(replyResult.result, "{\"echo\":\"hello\",\"doubled\":42}") || replyResult.exception[0]) {
+        fprintf(stderr, "testWorkerPool failed: reply was %s, exception %s\n", replyResult.result, replyResult.exception);
+        failed = 1;
+    }
+    ASSERT(throwResult.called);
+    if (throwResult.result[0] || strcmp(throwResult.exception, "Error: no reply")) {
+        fprintf(stderr, "testWorkerPool failed: result was %s, exception %s\n", throwResult.result, throwResult.exception);
+        failed = 1;
+    }
+}
+
+static void testPropertyKeys()
+{
+    TiGlobalContextRef ctx = TiGlobalContextCreateInGroup(NULL, NULL);
+    TiValueRef exception = NULL;
+
+    TiStringRef name = TiStringCreateWithUTF8CString("a");
+    TiPropertyKeyRef keys[2];
+    keys[0] = TiPropertyKeyCreate(TiContextGetGroup(ctx), name);
+    TiStringRelease(name);
+    name = TiStringCreateWithUTF8CString("b");
+    keys[1] = TiPropertyKeyCreate(TiContextGetGroup(ctx), name);
+    TiStringRelease(name);
+
+    // The same keys read and write objects of different structures, including ones
+    // where the property comes from the prototype or a getter, twice each so that
+    // both the first lookup and any cached one are exercised.
+    TiObjectRef objects = TiValueToObject(ctx, evaluateScript(ctx, "var objects = [{ a: 1, b: 2 }, { b: 4, a: 3 }, { x: 0, a: 5, b: 6 }, Object.create({ a: 7, b: 8 }), { get a() { return 9; }, b: 10 }]; objects", NULL), NULL);
+    unsigned pass, i;
+    for (pass = 0; pass < 2; ++pass) {
+        for (i = 0; i < 5; ++i) {
+            TiObjectRef object = TiValueToObject(ctx, TiObjectGetPropertyAtIndex(ctx, objects, i, NULL), NULL);
+            TiValueRef values[2];
+            TiObjectGetProperties(ctx, object, keys, 2, values, &exception);
+            ASSERT(!exception);
+            if (TiValueToNumber(ctx, values[0], NULL) != 2 * i + 1 || TiValueToNumber(ctx, values[1], NULL) != 2 * i + 2) {
+                fprintf(stderr, "testPropertyKeys failed: got wrong values from object %u\n", i);
+                failed = 1;
+            }
+        }
+    }
+    for (pass = 0; pass < 2; ++pass) {
+        for (i = 0; i < 4; ++i) {
+            TiObjectRef object = TiValueToObject(ctx, TiObjectGetPropertyAtIndex(ctx, objects, i, NULL), NULL);
+            TiValueRef values[2];
+            values[0] = TiValueMakeNumber(ctx, 100 * pass + 10 * i);
+            values[1] = TiValueMakeNumber(ctx, 100 * pass + 10 * i + 1);
+            TiObjectSetProperties(ctx, object, keys, 2, values, kTiPropertyAttributeNone, &exception);
+            ASSERT(!exception);
+        }
+    }
+    assertEqualsAsUTF8StringInContext(ctx, evaluateScript(ctx, "objects.slice(0, 4).map(function(o) { return o.a + ',' + o.b; }).join(' ')", NULL), "100,101 110,111 120,121 130,131");
+    assertEqualsAsUTF8StringInContext(ctx, evaluateScript(ctx, "Object.getPrototypeOf(objects[3]).a + ',' + objects[3].hasOwnProperty('a')", NULL), "7,true");
+
+    // A key from another context group is rejected with a TypeError.
+    TiGlobalContextRef otherContext = TiGlobalContextCreateInGroup(NULL, NULL);
+    name = TiStringCreateWithUTF8CString("a");
+    TiPropertyKeyRef otherKey = TiPropertyKeyCreate(TiContextGetGroup(otherContext), name);
+    TiStringRelease(name);
+    TiObjectRef object = TiValueToObject(ctx, TiObjectGetPropertyAtIndex(ctx, objects, 0, NULL), NULL);
+    TiValueRef value = NULL;
+    TiObjectGetProperties(ctx, object, &otherKey, 1, &value, &exception);
+    ASSERT(exception);
+    assertEqualsAsUTF8StringInContext(ctx, exception, "TypeError: Property key belongs to a different context group");
+    ASSERT(TiValueIsUndefined(ctx, value));
+    exception = NULL;
+    value = TiValueMakeNumber(ctx, 0);
+    TiObjectSetProperties(ctx, object, &otherKey, 1, &value, kTiPropertyAttributeNone, &exception);
+    ASSERT(exception);
+    assertEqualsAsUTF8StringInContext(ctx, exception, "TypeError: Property key belongs to a different context group");
+    assertEqualsAsUTF8StringInContext(ctx, evaluateScript(ctx, "objects[0].a", NULL), "100");
+    TiPropertyKeyRelease(otherKey);
+    TiGlobalContextRelease(otherContext);
+
+    TiPropertyKeyRelease(keys[0]);
+    TiPropertyKeyRelease(keys[1]);
+    TiGlobalContextRelease(ctx);
+}
+
+typedef struct {
+    TiChar* chars;
+    size_t numChars;
+    unsigned count;
+} ExternalStringFinalized;
+
+static void externalString_finalize(TiChar* chars, size_t numChars, void* context)
+{
+    ExternalStringFinalized* finalized = (ExternalStringFinalized*)context;
+    ASSERT(chars == finalized->chars);
+    ASSERT(numChars == finalized->numChars);
+    ++finalized->count;
+}
+
+static void testExternalStrings()
+{
+    TiChar chars[] = { 'e', 'x', 't', 'e', 'r', 'n', 'a', 'l' };
+    ExternalStringFinalized finalized = { chars, 8, 0 };
+
+    TiStringRef string = TiStringCreateWithCharactersNoCopy(chars, 8, externalString_finalize, &finalized);
+    ASSERT(TiStringGetCharactersPtr(string) == chars);
+    ASSERT(TiStringGetLength(string) == 8);
+    ASSERT(TiStringIsEqualToUTF8CString(string, "external"));
+
+    // Values made from the string go on using the characters after the string
+    // itself has been released.
+    TiGlobalContextRef ctx = TiGlobalContextCreateInGroup(NULL, NULL);
+    TiValueRef value = TiValueMakeString(ctx, string);
+    TiStringRef propertyName = TiStringCreateWithUTF8CString("external");
+    TiObjectSetProperty(ctx, TiContextGetGlobalObject(ctx), propertyName, value, kTiPropertyAttributeNone, NULL);
+    TiStringRelease(propertyName);
+    TiStringRelease(string);
+    ASSERT(!finalized.count);
+
+    assertEqualsAsUTF8StringInContext(ctx, evaluateScript(ctx, "external.length + ':' + external.toUpperCase() + ':' + (external == 'external')", NULL), "8:EXTERNAL:true");
+    TiStringRef copy = TiValueToStringCopy(ctx, value, NULL);
+    ASSERT(TiStringIsEqualToUTF8CString(copy, "external"));
+
+    // The finalizer runs once, when the last value using the characters goes
+    // away; a string copied out of a value has characters of its own.
+    TiGlobalContextRelease(ctx);
+    ASSERT(TiStringIsEqualToUTF8CString(copy, "external"));
+    TiStringRelease(copy);
+    if (finalized.count != 1) {
+        fprintf(stderr, "testExternalStrings failed: finalizer called %u times\n", finalized.count);
+        failed = 1;
+    }
+
+    // A string that is never shared is finalized when it is released, and one
+    // without a finalizer needs nothing more.
+    finalized.count = 0;
+    string = TiStringCreateWithCharactersNoCopy(chars, 8, externalString_finalize, &finalized);
+    TiStringRelease(string);
+    ASSERT(finalized.count == 1);
+    string = TiStringCreateWithCharactersNoCopy(chars, 8, NULL, NULL);
+    ASSERT(TiStringIsEqualToUTF8CString(string, "external"));
+    TiStringRelease(string);
+    ASSERT(finalized.count == 1);
+}
+
+static TiValueRef snapshot_callAsFunction(TiContextRef ctx, TiObjectRef function, TiObjectRef thisObject, size_t argumentCount, const TiValueRef arguments[], TiValueRef* exception)
+{
+    UNUSED_PARAM(function);
+    UNUSED_PARAM(thisObject);
+    UNUSED_PARAM(argumentCount);
+    UNUSED_PARAM(arguments);
+    UNUSED_PARAM(exception);
+
+    return TiValueMakeUndefined(ctx);
+}
+
+static bool writeSnapshotBytes(const char* path, const char* bytes, size_t length)
+{
+    FILE* file = fopen(path, "wb");
+    if (!file)
+        return false;
+    bool written = fwrite(bytes, 1, length, file) == length;
+    return !fclose(file) && written;
+}
+
+static void testSnapshots()
+{
+    const char* path = "testapi.snapshot";
+    TiGlobalContextRef source = TiGlobalContextCreateInGroup(NULL, NULL);
+    TiValueRef exception = NULL;
+
+    evaluateScript(source, "var makeCounter = function(start) { var n = start; return function() { return ++n; }; }; var counter = makeCounter(10); counter();", NULL);
+    evaluateScript(source, "var o = { _v: 1, get v() { return this._v * 2; }, set v(x) { this._v = x; } }; var shared = [o, o, new Date(1000), /x+/g];", NULL);
+    evaluateScript(source, "Array.prototype.sum = function() { var total = 0; for (var i = 0; i < this.length; ++i) total += this[i]; return total; };", NULL);
+
+    // Native functions can not be written to a file.
+    TiStringRef name = TiStringCreateWithUTF8CString("native");
+    TiObjectRef native = TiObjectMakeFunctionWithCallback(source, name, snapshot_callAsFunction);
+    TiObjectSetProperty(source, TiContextGetGlobalObject(source), name, native, kTiPropertyAttributeNone, NULL);
+    ASSERT(!TiGlobalContextWriteSnapshot(source, path, &exception));
+    ASSERT(exception);
+    assertEqualsAsUTF8StringInContext(source, evaluateScript(source, "delete native", NULL), "true");
+    TiStringRelease(name);
+
+    exception = NULL;
+    ASSERT(TiGlobalContextWriteSnapshot(source, path, &exception));
+    ASSERT(!exception);
+    TiGlobalContextRelease(source);
+
+    // A fresh global object picks up closures with their state, accessors, shared
+    // references and changes to the built-ins.
+    TiGlobalContextRef restored = TiGlobalContextCreateInGroup(NULL, NULL);
+    ASSERT(TiGlobalContextReadSnapshot(restored, path, &exception));
+    ASSERT(!exception);
+    assertEqualsAsUTF8StringInContext(restored, evaluateScript(restored, "counter() + ',' + counter() + ',' + makeCounter(0)()", NULL), "12,13,1");
+    assertEqualsAsUTF8StringInContext(restored, evaluateScript(restored, "var before = o.v; o.v = 5; before + ',' + o.v + ',' + o._v", NULL), "2,10,5");
+    assertEqualsAsUTF8StringInContext(restored, evaluateScript(restored, "shared[0] === shared[1] && shared[0] === o && shared[2].getTime() == 1000 && shared[3].global && shared[3].test('xx')", NULL), "true");
+    assertEqualsAsUTF8StringInContext(restored, evaluateScript(restored, "[1, 2, 3].sum() + ',' + (typeof native)", NULL), "6,undefined");
+    TiGlobalContextRelease(restored);
+
+    // Missing, truncated and corrupted files are rejected.
+    FILE* file = fopen(path, "rb");
+    ASSERT(file);
+    char bytes[65536];
+    size_t length = fread(bytes, 1, sizeof(bytes), file);
+    fclose(file);
+    ASSERT(length > 16 && length < sizeof(bytes));
+
+    const size_t truncatedLengths[] = { 0, 8, length / 2, length - 1 };
+    size_t i;
+    for (i = 0; i <= sizeof(truncatedLengths) / sizeof(truncatedLengths[0]); ++i) {
+        if (i < sizeof(truncatedLengths) / sizeof(truncatedLengths[0]))
+            ASSERT(writeSnapshotBytes(path, bytes, truncatedLengths[i]));
+        else {
+            // A snapshot from a different version of TiCore.
+            bytes[0] ^= 0xFF;
+            ASSERT(writeSnapshotBytes(path, bytes, length));
+        }
+        TiGlobalContextRef malformed = TiGlobalContextCreateInGroup(NULL, NULL);
+        exception = NULL;
+        ASSERT(!TiGlobalContextReadSnapshot(malformed, path, &exception));
+        ASSERT(exception);
+        TiGlobalContextRelease(malformed);
+    }
+
+    remove(path);
+    TiGlobalContextRef missing = TiGlobalContextCreateInGroup(NULL, NULL);
+    exception = NULL;
+    ASSERT(!TiGlobalContextReadSnapshot(missing, path, &exception));
+    ASSERT(exception);
+    TiGlobalContextRelease(missing);
+}
+
 int main(int argc, char* argv[])
 {
     const char *scriptPath = "testapi.js";
@@ -1180,6 +1655,32 @@ int main(int argc, char* argv[])
         free(scriptUTF8);
     }
 
+    // Functions made by the Function constructor are cached by source. The
+    // cached code's constants must survive a collection that frees every
+    // function created from it.
+    {
+        TiStringRef functionScript = TiStringCreateWithUTF8CString("new Function(\"return 'lit-one' + ':' + 'lit-two'\")()");
+        TiStringRef garbageScript = TiStringCreateWithUTF8CString("var garbage = []; for (var i = 0; i < 10000; ++i) garbage.push('t' + i); garbage = null;");
+        TiStringRef sourceURL = TiStringCreateWithUTF8CString("function constructor cache");
+
+        assertEqualsAsUTF8String(TiEvalScript(context, functionScript, NULL, sourceURL, 1, NULL), "lit-one:lit-two");
+        TiGarbageCollect(context);
+        TiEvalScript(context, garbageScript, NULL, sourceURL, 1, NULL);
+        assertEqualsAsUTF8String(TiEvalScript(context, functionScript, NULL, sourceURL, 1, NULL), "lit-one:lit-two");
+
+        TiStringRelease(functionScript);
+        TiStringRelease(garbageScript);
+        TiStringRelease(sourceURL);
+    }
+
+    testTermination();
+    testResourceLimits();
+    testSerialization();
+    testWorkerPool();
+    testPropertyKeys();
+    testExternalStrings();
+    testSnapshots();
+
     // Clear out local variables pointing at TiObjectRefs to allow their values to be collected
     function = NULL;
     v = NULL;
@@ -100,6 +100,8 @@ SOURCES += \
     API/JSCallbackObject.cpp \
     API/JSClassRef.cpp \
     API/JSContextRef.cpp \
+    API/TiSerializedValuePrivate.cpp \
+    API/TiWorkerPoolPrivate.cpp \
     API/JSObjectRef.cpp \
     API/JSStringRef.cpp \
     API/JSValueRef.cpp \
@@ -113,11 +115,14 @@ SOURCES += \
     runtime/JSNotAnObject.cpp \
     runtime/JSONObject.cpp \
     runtime/LiteralParser.cpp \
+    runtime/SerializedValue.cpp \
     runtime/MarkStack.cpp \
     runtime/TimeoutChecker.cpp \
+    runtime/ResourceLimits.cpp \
     bytecode/CodeBlock.cpp \
     bytecode/StructureStubInfo.cpp \
     bytecode/JumpTable.cpp \
+    bytecode/EvalCodeCache.cpp \
     assembler/ARMAssembler.cpp \
     assembler/MacroAssemblerARM.cpp \
     jit/JIT.cpp \
@@ -197,6 +202,7 @@ SOURCES += \
     runtime/JSCell.cpp \
     runtime/JSFunction.cpp \
     runtime/JSGlobalObjectFunctions.cpp \
+    runtime/TiGlobalObjectSnapshot.cpp \
     runtime/JSImmediate.cpp \
     runtime/JSLock.cpp \
     runtime/JSNumberCell.cpp \
@@ -223,6 +229,7 @@ SOURCES += \
     runtime/PropertySlot.cpp \
     runtime/PrototypeFunction.cpp \
     runtime/RegExp.cpp \
+    runtime/RegExpCache.cpp \
     runtime/RegExpConstructor.cpp \
     runtime/RegExpObject.cpp \
     runtime/RegExpPrototype.cpp \
@@ -56,6 +56,7 @@ public:
     using MacroAssemblerX86Common::sub32;
     using MacroAssemblerX86Common::load32;
     using MacroAssemblerX86Common::store32;
+    using MacroAssemblerX86Common::branch32;
     using MacroAssemblerX86Common::call;
     using MacroAssemblerX86Common::loadDouble;
     using MacroAssemblerX86Common::convertInt32ToDouble;
@@ -84,6 +85,12 @@ public:
         sub32(imm, Address(scratchRegister));
     }
 
+    Jump branch32(Condition cond, AbsoluteAddress left, Imm32 right)
+    {
+        move(ImmPtr(left.m_ptr), scratchRegister);
+        return branch32(cond, Address(scratchRegister), right);
+    }
+
     void load32(void* address, RegisterID dest)
     {
         if (dest == X86Registers::eax)
@@ -902,6 +902,20 @@ void CodeBlock::dump(TiExcState* exec, const Vector<Instruction>::const_iterator
             printf("[%4d] jneq_ptr\t\t %s, %s, %d(->%d)\n", location, registerName(exec, r0).c_str(), registerName(exec, r1).c_str(), offset, location + offset);
             break;
         }
+        case op_jless: {
+            int r0 = (++it)->u.operand;
+            int r1 = (++it)->u.operand;
+            int offset = (++it)->u.operand;
+            printf("[%4d] jless\t\t %s, %s, %d(->%d)\n", location, registerName(exec, r0).c_str(), registerName(exec, r1).c_str(), offset, location + offset);
+            break;
+        }
+        case op_jlesseq: {
+            int r0 = (++it)->u.operand;
+            int r1 = (++it)->u.operand;
+            int offset = (++it)->u.operand;
+            printf("[%4d] jlesseq\t\t %s, %s, %d(->%d)\n", location, registerName(exec, r0).c_str(), registerName(exec, r1).c_str(), offset, location + offset);
+            break;
+        }
         case op_jnless: {
             int r0 = (++it)->u.operand;
             int r1 = (++it)->u.operand;
@@ -1174,8 +1188,6 @@ void CodeBlock::dumpStatistics()
     #undef DEFINE_VARS
 
     // Non-vector data members
-    size_t evalCodeCacheIsNotEmpty = 0;
-
     size_t symbolTableIsNotEmpty = 0;
     size_t symbolTableTotalSize = 0;
 
@@ -1211,9 +1223,6 @@ void CodeBlock::dumpStatistics()
             #define GET_STATS(name) if (!codeBlock->m_rareData->m_##name.isEmpty()) { name##IsNotEmpty++; name##TotalSize += sizeInBytes(codeBlock->m_rareData->m_##name); }
                 FOR_EACH_MEMBER_VECTOR_RARE_DATA(GET_STATS)
             #undef GET_STATS
-
-            if (!codeBlock->m_rareData->m_evalCodeCache.isEmpty())
-                evalCodeCacheIsNotEmpty++;
         }
 
         switch (codeBlock->codeType()) {
@@ -1258,7 +1267,6 @@ void CodeBlock::dumpStatistics()
         FOR_EACH_MEMBER_VECTOR_EXCEPTION_INFO(PRINT_STATS)
     #undef PRINT_STATS
 
-    printf("Number of CodeBlocks with evalCodeCache: %zu\n", evalCodeCacheIsNotEmpty);
     printf("Number of CodeBlocks with symbolTable: %zu\n", symbolTableIsNotEmpty);
 
     printf("Size of all symbolTables: %zu\n", symbolTableTotalSize);
@@ -1649,6 +1657,8 @@ void CodeBlock::shrinkToFit()
     m_linkedCallerList.shrinkToFit();
 #endif
 
+    m_jumpTargets.shrinkToFit();
+
     m_identifiers.shrinkToFit();
     m_functionDecls.shrinkToFit();
     m_functionExprs.shrinkToFit();
@@ -1672,4 +1682,51 @@ void CodeBlock::shrinkToFit()
     }
 }
 
+void CodeBlock::addMemoryUsage(CodeMemoryUsage& usage) const
+{
+    usage.bytecodeBytes += sizeInBytes(m_instructions);
+
+    size_t metadataBytes = sizeof(*this);
+#if !ENABLE(JIT)
+    metadataBytes += sizeInBytes(m_propertyAccessInstructions);
+    metadataBytes += sizeInBytes(m_globalResolveInstructions);
+#else
+    metadataBytes += sizeInBytes(m_structureStubInfos);
+    metadataBytes += sizeInBytes(m_globalResolveInfos);
+    metadataBytes += sizeInBytes(m_callLinkInfos);
+    metadataBytes += sizeInBytes(m_methodCallLinkInfos);
+    metadataBytes += sizeInBytes(m_linkedCallerList);
+#endif
+    metadataBytes += sizeInBytes(m_jumpTargets);
+    metadataBytes += sizeInBytes(m_identifiers);
+    metadataBytes += sizeInBytes(m_constantRegisters);
+    metadataBytes += sizeInBytes(m_functionDecls);
+    metadataBytes += sizeInBytes(m_functionExprs);
+    metadataBytes += m_symbolTable->capacity() * (sizeof(SymbolTable::KeyType) + sizeof(SymbolTable::MappedType));
+
+    if (m_exceptionInfo) {
+        metadataBytes += sizeof(ExceptionInfo);
+        metadataBytes += sizeInBytes(m_exceptionInfo->m_expressionInfo);
+        metadataBytes += sizeInBytes(m_exceptionInfo->m_lineInfo);
+        metadataBytes += sizeInBytes(m_exceptionInfo->m_getByIdExceptionInfo);
+#if ENABLE(JIT)
+        metadataBytes += sizeInBytes(m_exceptionInfo->m_callReturnIndexVector);
+#endif
+    }
+
+    if (m_rareData) {
+        metadataBytes += sizeof(RareData);
+        metadataBytes += sizeInBytes(m_rareData->m_exceptionHandlers);
+        metadataBytes += sizeInBytes(m_rareData->m_regexps);
+        metadataBytes += sizeInBytes(m_rareData->m_immediateSwitchJumpTables);
+        metadataBytes += sizeInBytes(m_rareData->m_characterSwitchJumpTables);
+        metadataBytes += sizeInBytes(m_rareData->m_stringSwitchJumpTables);
+#if ENABLE(JIT)
+        metadataBytes += sizeInBytes(m_rareData->m_functionRegisterInfos);
+#endif
+    }
+
+    usage.metadataBytes += metadataBytes;
+}
+
 } // namespace TI
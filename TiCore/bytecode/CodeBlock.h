@@ -37,7 +37,7 @@
 #ifndef CodeBlock_h
 #define CodeBlock_h
 
-#include "EvalCodeCache.h"
+#include "Executable.h"
 #include "Instruction.h"
 #include "JITCode.h"
 #include "TiGlobalObject.h"
@@ -328,6 +328,8 @@ namespace TI {
             m_linkedCallerList.shrink(lastPos);
         }
 
+        bool hasLinkedCallers() const { return !m_linkedCallerList.isEmpty(); }
+
         StructureStubInfo& getStubInfo(ReturnAddressPtr returnAddress)
         {
             return *(binaryChop<StructureStubInfo, void*, getStructureStubInfoReturnLocation>(m_structureStubInfos.begin(), m_structureStubInfos.size(), returnAddress.value()));
@@ -356,7 +358,7 @@ namespace TI {
         bool isNumericCompareFunction() { return m_isNumericCompareFunction; }
 
         Vector<Instruction>& instructions() { return m_instructions; }
-        void discardBytecode() { m_instructions.clear(); }
+        void discardBytecode() { m_instructions.clear(); m_jumpTargets.clear(); }
 
 #ifndef NDEBUG
         unsigned instructionCount() { return m_instructionCount; }
@@ -391,6 +393,7 @@ namespace TI {
         void addJumpTarget(unsigned jumpTarget) { m_jumpTargets.append(jumpTarget); }
         unsigned jumpTarget(int index) const { return m_jumpTargets[index]; }
         unsigned lastJumpTarget() const { return m_jumpTargets.last(); }
+        void discardJumpTargets() { m_jumpTargets.clear(); }
 
 #if !ENABLE(JIT)
         void addPropertyAccessInstruction(unsigned propertyAccessInstruction) { m_propertyAccessInstructions.append(propertyAccessInstruction); }
@@ -476,9 +479,8 @@ namespace TI {
         SymbolTable* symbolTable() { return m_symbolTable; }
         SharedSymbolTable* sharedSymbolTable() { ASSERT(m_codeType == FunctionCode); return static_cast<SharedSymbolTable*>(m_symbolTable); }
 
-        EvalCodeCache& evalCodeCache() { createRareDataIfNecessary(); return m_rareData->m_evalCodeCache; }
-
         void shrinkToFit();
+        void addMemoryUsage(CodeMemoryUsage&) const;
 
         // FIXME: Make these remaining members private.
 
@@ -560,8 +562,6 @@ namespace TI {
             Vector<SimpleJumpTable> m_characterSwitchJumpTables;
             Vector<StringJumpTable> m_stringSwitchJumpTables;
 
-            EvalCodeCache m_evalCodeCache;
-
 #if ENABLE(JIT)
             Vector<FunctionRegisterInfo> m_functionRegisterInfos;
 #endif
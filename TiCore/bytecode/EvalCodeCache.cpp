@@ -0,0 +1,276 @@
+/**
+ * Appcelerator Titanium License
+ * This source code and all modifications done by Appcelerator
+ * are licensed under the Apache Public License (version 2) and
+ * are Copyright (c) 2009 by Appcelerator, Inc.
+ */
+
+/*
+ * Copyright (C) 2008, 2009 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1.  Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ * 2.  Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ * 3.  Neither the name of Apple Computer, Inc. ("Apple") nor the names of
+ *     its contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE AND ITS CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL APPLE OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "EvalCodeCache.h"
+
+#include "Executable.h"
+#include "ScopeChain.h"
+#include "SourceCode.h"
+#include "TiGlobalObject.h"
+
+namespace TI {
+
+// Templating code evaluates the same generated sources, often a few KB each,
+// from many different functions, so the budget covers the source text as well
+// as the compiled code.
+static const size_t defaultCapacity = 512 * 1024;
+
+// Eval code is cached per local scope depth, which is never negative.
+static const int functionConstructorScopeDepth = -1;
+
+struct EvalCodeCache::Entry : FastAllocBase {
+    Entry(UString::Rep* source, TiGlobalObject* globalObject, int scopeDepth, PassRefPtr<ScriptExecutable> executable)
+        : source(source)
+        , globalObject(globalObject)
+        , scopeDepth(scopeDepth)
+        , executable(executable)
+        , cost(0)
+        , previous(0)
+        , next(0)
+        , nextWithSameSource(0)
+    {
+    }
+
+    RefPtr<UString::Rep> source;
+    TiGlobalObject* globalObject;
+    int scopeDepth;
+    RefPtr<ScriptExecutable> executable;
+    size_t cost;
+
+    Entry* previous;
+    Entry* next;
+    Entry* nextWithSameSource;
+};
+
+EvalCodeCache::EvalCodeCache()
+    : m_head(0)
+    , m_tail(0)
+    , m_capacity(defaultCapacity)
+    , m_size(0)
+    , m_hits(0)
+    , m_misses(0)
+    , m_evictions(0)
+{
+}
+
+EvalCodeCache::~EvalCodeCache()
+{
+    clear();
+}
+
+PassRefPtr<EvalExecutable> EvalCodeCache::get(TiExcState* exec, const UString& evalSource, ScopeChainNode* scopeChain, TiValue& exceptionValue)
+{
+    // Eval code is compiled for the number of scopes between it and the nearest
+    // activation, and its constant pool is marked by its global object.
+    bool isCacheable = (*scopeChain->begin())->isVariableObject();
+    TiGlobalObject* globalObject = scopeChain->globalObject;
+    int scopeDepth = isCacheable ? ScopeChain(scopeChain).localDepth() : 0;
+
+    if (isCacheable) {
+        if (Entry* entry = find(evalSource.rep(), globalObject, scopeDepth))
+            return static_cast<EvalExecutable*>(entry->executable.get());
+    }
+
+    RefPtr<EvalExecutable> evalExecutable = EvalExecutable::create(exec, makeSource(evalSource));
+    exceptionValue = evalExecutable->compile(exec, scopeChain);
+    if (exceptionValue)
+        return 0;
+
+    if (isCacheable) {
+        CodeMemoryUsage usage = evalExecutable->memoryUsage();
+        add(evalSource.rep(), globalObject, scopeDepth, evalExecutable, usage.bytecodeBytes + usage.metadataBytes + usage.jitCodeBytes);
+    }
+
+    return evalExecutable.release();
+}
+
+static size_t functionCodeSize(FunctionExecutable* executable)
+{
+    CodeMemoryUsage usage = executable->memoryUsage();
+    return sizeof(FunctionExecutable) + usage.bytecodeBytes + usage.metadataBytes + usage.jitCodeBytes;
+}
+
+PassRefPtr<FunctionExecutable> EvalCodeCache::getFunction(const UString& source, TiGlobalObject* globalObject)
+{
+    Entry* entry = find(source.rep(), globalObject, functionConstructorScopeDepth);
+    if (!entry)
+        return 0;
+
+    // Function code is generated on first call and may be flushed later, so
+    // the entry's cost is brought up to date whenever it is used again. That
+    // can evict the entry itself, so keep the executable alive first.
+    RefPtr<FunctionExecutable> executable = static_cast<FunctionExecutable*>(entry->executable.get());
+    setCost(entry, functionCodeSize(executable.get()));
+    evictToCapacity();
+    return executable.release();
+}
+
+void EvalCodeCache::addFunction(const UString& source, TiGlobalObject* globalObject, PassRefPtr<FunctionExecutable> executable)
+{
+    size_t codeSize = functionCodeSize(executable.get());
+    add(source.rep(), globalObject, functionConstructorScopeDepth, executable, codeSize);
+}
+
+void EvalCodeCache::markFunctions(MarkStack& markStack, TiGlobalObject* globalObject)
+{
+    for (Entry* entry = m_head; entry; entry = entry->next) {
+        if (entry->globalObject == globalObject && entry->scopeDepth == functionConstructorScopeDepth)
+            static_cast<FunctionExecutable*>(entry->executable.get())->markAggregate(markStack);
+    }
+}
+
+void EvalCodeCache::removeEntriesForGlobalObject(TiGlobalObject* globalObject)
+{
+    Entry* entry = m_head;
+    while (entry) {
+        Entry* next = entry->next;
+        if (entry->globalObject == globalObject)
+            remove(entry);
+        entry = next;
+    }
+}
+
+void EvalCodeCache::clear()
+{
+    while (m_head)
+        remove(m_head);
+}
+
+void EvalCodeCache::setCapacity(size_t capacity)
+{
+    m_capacity = capacity;
+    evictToCapacity();
+}
+
+EvalCodeCache::Entry* EvalCodeCache::find(UString::Rep* source, TiGlobalObject* globalObject, int scopeDepth)
+{
+    for (Entry* entry = m_entries.get(source); entry; entry = entry->nextWithSameSource) {
+        if (entry->globalObject == globalObject && entry->scopeDepth == scopeDepth) {
+            ++m_hits;
+            moveToHead(entry);
+            return entry;
+        }
+    }
+    ++m_misses;
+    return 0;
+}
+
+void EvalCodeCache::add(UString::Rep* source, TiGlobalObject* globalObject, int scopeDepth, PassRefPtr<ScriptExecutable> executable, size_t codeSize)
+{
+    if (sizeof(Entry) + source->size() * sizeof(UChar) + codeSize > m_capacity)
+        return;
+
+    Entry* entry = new Entry(source, globalObject, scopeDepth, executable);
+    setCost(entry, codeSize);
+
+    pair<EntryMap::iterator, bool> result = m_entries.add(source, entry);
+    if (!result.second) {
+        entry->nextWithSameSource = result.first->second;
+        result.first->second = entry;
+    }
+
+    entry->next = m_head;
+    if (m_head)
+        m_head->previous = entry;
+    else
+        m_tail = entry;
+    m_head = entry;
+
+    evictToCapacity();
+}
+
+void EvalCodeCache::setCost(Entry* entry, size_t codeSize)
+{
+    m_size -= entry->cost;
+    entry->cost = sizeof(Entry) + entry->source->size() * sizeof(UChar) + codeSize;
+    m_size += entry->cost;
+}
+
+void EvalCodeCache::remove(Entry* entry)
+{
+    EntryMap::iterator it = m_entries.find(entry->source);
+    ASSERT(it != m_entries.end());
+    if (it->second == entry) {
+        if (entry->nextWithSameSource)
+            it->second = entry->nextWithSameSource;
+        else
+            m_entries.remove(it);
+    } else {
+        Entry* previous = it->second;
+        while (previous->nextWithSameSource != entry)
+            previous = previous->nextWithSameSource;
+        previous->nextWithSameSource = entry->nextWithSameSource;
+    }
+
+    if (entry->previous)
+        entry->previous->next = entry->next;
+    else
+        m_head = entry->next;
+    if (entry->next)
+        entry->next->previous = entry->previous;
+    else
+        m_tail = entry->previous;
+
+    m_size -= entry->cost;
+    delete entry;
+}
+
+void EvalCodeCache::moveToHead(Entry* entry)
+{
+    if (entry == m_head)
+        return;
+
+    entry->previous->next = entry->next;
+    if (entry->next)
+        entry->next->previous = entry->previous;
+    else
+        m_tail = entry->previous;
+
+    entry->previous = 0;
+    entry->next = m_head;
+    m_head->previous = entry;
+    m_head = entry;
+}
+
+void EvalCodeCache::evictToCapacity()
+{
+    while (m_size > m_capacity) {
+        ++m_evictions;
+        remove(m_tail);
+    }
+}
+
+} // namespace TI
@@ -36,47 +36,78 @@
 #ifndef EvalCodeCache_h
 #define EvalCodeCache_h
 
-#include "Executable.h"
-#include "TiGlobalObject.h"
-#include "Nodes.h"
-#include "Parser.h"
-#include "SourceCode.h"
 #include "UString.h"
 #include <wtf/HashMap.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/PassRefPtr.h>
 #include <wtf/RefPtr.h>
 
 namespace TI {
 
-    class EvalCodeCache {
+    class EvalExecutable;
+    class FunctionExecutable;
+    class MarkStack;
+    class ScopeChainNode;
+    class ScriptExecutable;
+    class TiExcState;
+    class TiGlobalObject;
+    class TiValue;
+
+    // Compiled eval code and Function constructor executables, shared by every
+    // caller in a TiGlobalData. Entries are keyed by source and by the shape of
+    // the scope chain the code was compiled for, and are evicted least recently
+    // used first once the memory they hold exceeds the cache's capacity.
+    class EvalCodeCache : public Noncopyable {
     public:
-        PassRefPtr<EvalExecutable> get(TiExcState* exec, const UString& evalSource, ScopeChainNode* scopeChain, TiValue& exceptionValue)
-        {
-            RefPtr<EvalExecutable> evalExecutable;
+        EvalCodeCache();
+        ~EvalCodeCache();
 
-            if (evalSource.size() < maxCacheableSourceLength && (*scopeChain->begin())->isVariableObject())
-                evalExecutable = m_cacheMap.get(evalSource.rep());
+        PassRefPtr<EvalExecutable> get(TiExcState*, const UString& evalSource, ScopeChainNode*, TiValue& exceptionValue);
 
-            if (!evalExecutable) {
-                evalExecutable = EvalExecutable::create(exec, makeSource(evalSource));
-                exceptionValue = evalExecutable->compile(exec, scopeChain);
-                if (exceptionValue)
-                    return 0;
+        // The Function constructor always creates its functions in the global scope.
+        PassRefPtr<FunctionExecutable> getFunction(const UString& source, TiGlobalObject*);
+        void addFunction(const UString& source, TiGlobalObject*, PassRefPtr<FunctionExecutable>);
 
-                if (evalSource.size() < maxCacheableSourceLength && (*scopeChain->begin())->isVariableObject() && m_cacheMap.size() < maxCacheEntries)
-                    m_cacheMap.set(evalSource.rep(), evalExecutable);
-            }
+        // The constant pool of cached code is marked by the global object it was
+        // compiled for, so the code must not outlive that global object. Eval
+        // code is marked as one of the global object's code blocks, and function
+        // code through markFunctions().
+        void markFunctions(MarkStack&, TiGlobalObject*);
+        void removeEntriesForGlobalObject(TiGlobalObject*);
+        void clear();
 
-            return evalExecutable.release();
-        }
+        size_t capacity() const { return m_capacity; }
+        void setCapacity(size_t);
+        size_t size() const { return m_size; }
+        bool isEmpty() const { return !m_size; }
 
-        bool isEmpty() const { return m_cacheMap.isEmpty(); }
+        unsigned hits() const { return m_hits; }
+        unsigned misses() const { return m_misses; }
+        unsigned evictions() const { return m_evictions; }
 
     private:
-        static const int maxCacheableSourceLength = 256;
-        static const int maxCacheEntries = 64;
+        struct Entry;
+
+        Entry* find(UString::Rep* source, TiGlobalObject*, int scopeDepth);
+        void add(UString::Rep* source, TiGlobalObject*, int scopeDepth, PassRefPtr<ScriptExecutable>, size_t codeSize);
+        void remove(Entry*);
+        void setCost(Entry*, size_t codeSize);
+        void moveToHead(Entry*);
+        void evictToCapacity();
+
+        typedef HashMap<RefPtr<UString::Rep>, Entry*> EntryMap;
+        EntryMap m_entries;
+
+        // Least recently used entries are at the tail of the list.
+        Entry* m_head;
+        Entry* m_tail;
+
+        size_t m_capacity;
+        size_t m_size;
 
-        typedef HashMap<RefPtr<UString::Rep>, RefPtr<EvalExecutable> > EvalCacheMap;
-        EvalCacheMap m_cacheMap;
+        unsigned m_hits;
+        unsigned m_misses;
+        unsigned m_evictions;
     };
 
 } // namespace TI
@@ -37,6 +37,8 @@
 #include "config.h"
 #include "Opcode.h"
 
+#include <stdio.h>
+
 using namespace std;
 
 namespace TI {
@@ -56,6 +58,10 @@ const char* const opcodeNames[] = {
 long long OpcodeStats::opcodeCounts[numOpcodeIDs];
 long long OpcodeStats::opcodePairCounts[numOpcodeIDs][numOpcodeIDs];
 int OpcodeStats::lastOpcode = -1;
+long long OpcodeStats::generatedInstructions = 0;
+long long OpcodeStats::fusedInstructions = 0;
+long long OpcodeStats::threadedJumps = 0;
+long long OpcodeStats::jumpsToReturns = 0;
 
 static OpcodeStats logger;
 
@@ -120,6 +126,15 @@ OpcodeStats::~OpcodeStats()
             *(currentPairIndex++) = make_pair(i, j);
     qsort(sortedPairIndices, numOpcodeIDs * numOpcodeIDs, sizeof(pair<int, int>), compareOpcodePairIndices);
     
+    printf("\nGenerated bytecode statistics\n");
+
+    // A fusion rewinds an instruction that was already counted and emits a
+    // superinstruction in place of the jump that would have followed it.
+    printf("Instructions before peephole optimization: %lld\n", generatedInstructions);
+    printf("Instructions after peephole optimization: %lld\n", generatedInstructions - fusedInstructions);
+    printf("Jumps threaded: %lld\n", threadedJumps);
+    printf("Jumps replaced by returns: %lld\n", jumpsToReturns);
+
     printf("\nExecuted opcode statistics\n"); 
     
     printf("Total instructions executed: %lld\n\n", totalInstructions);
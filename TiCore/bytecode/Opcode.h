@@ -133,6 +133,8 @@ namespace TI {
         macro(op_jeq_null, 3) \
         macro(op_jneq_null, 3) \
         macro(op_jneq_ptr, 4) \
+        macro(op_jless, 4) \
+        macro(op_jlesseq, 4) \
         macro(op_jnless, 4) \
         macro(op_jnlesseq, 4) \
         macro(op_jmp_scopes, 3) \
@@ -234,6 +236,13 @@ namespace TI {
         static long long opcodePairCounts[numOpcodeIDs][numOpcodeIDs];
         static int lastOpcode;
 
+        // Bytecode generation counters, so the effect of the generator's
+        // peephole fusions and jump optimization pass can be measured.
+        static long long generatedInstructions;
+        static long long fusedInstructions;
+        static long long threadedJumps;
+        static long long jumpsToReturns;
+
         static void recordInstruction(int opcode);
         static void resetLastInstruction();
     };
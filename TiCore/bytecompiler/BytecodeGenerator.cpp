@@ -150,6 +150,8 @@ void BytecodeGenerator::generate()
 
     m_scopeNode->emitBytecode(*this);
 
+    optimizeJumps();
+
 #ifndef NDEBUG
     m_codeBlock->setInstructionCount(m_codeBlock->instructions().size());
 
@@ -167,6 +169,11 @@ void BytecodeGenerator::generate()
         m_codeBlock->clearExceptionInfo();
 #endif
 
+#if !ENABLE(JIT)
+    // Jump targets are only consulted by the JIT once generation is complete.
+    m_codeBlock->discardJumpTargets();
+#endif
+
     m_codeBlock->shrinkToFit();
 }
 
@@ -582,6 +589,9 @@ void BytecodeGenerator::emitOpcode(OpcodeID opcodeID)
 {
     instructions().append(globalData()->interpreter->getOpcode(opcodeID));
     m_lastOpcodeID = opcodeID;
+#if ENABLE(OPCODE_STATS)
+    ++OpcodeStats::generatedInstructions;
+#endif
 }
 
 void BytecodeGenerator::retrieveLastBinaryOp(int& dstIndex, int& src1Index, int& src2Index)
@@ -605,12 +615,106 @@ void ALWAYS_INLINE BytecodeGenerator::rewindBinaryOp()
 {
     ASSERT(instructions().size() >= 4);
     instructions().shrink(instructions().size() - 4);
+#if ENABLE(OPCODE_STATS)
+    ++OpcodeStats::fusedInstructions;
+#endif
 }
 
 void ALWAYS_INLINE BytecodeGenerator::rewindUnaryOp()
 {
     ASSERT(instructions().size() >= 3);
     instructions().shrink(instructions().size() - 3);
+#if ENABLE(OPCODE_STATS)
+    ++OpcodeStats::fusedInstructions;
+#endif
+}
+
+static int jumpTargetOperand(OpcodeID opcodeID)
+{
+    switch (opcodeID) {
+        case op_jmp:
+            return 1;
+        case op_jtrue:
+        case op_jfalse:
+        case op_jeq_null:
+        case op_jneq_null:
+            return 2;
+        case op_jneq_ptr:
+        case op_jless:
+        case op_jlesseq:
+        case op_jnless:
+        case op_jnlesseq:
+            return 3;
+        default:
+            return 0;
+    }
+}
+
+// Runs over the finished instruction stream and retargets forward jumps that
+// land on an unconditional op_jmp, or on a conditional jump testing the same
+// register, so chains produced by nested if/else, ?: and logical operators
+// cost a single dispatch.  An op_jmp that lands on an op_ret is replaced by
+// the op_ret itself.  The pass only rewrites operands in place: instruction
+// offsets must stay identical so that exception info regenerated for this
+// code block still lines up.
+void BytecodeGenerator::optimizeJumps()
+{
+    Interpreter* interpreter = m_globalData->interpreter;
+    Vector<Instruction>& instructions = this->instructions();
+    size_t size = instructions.size();
+
+    for (size_t i = 0; i < size; ) {
+        OpcodeID opcodeID = interpreter->getOpcodeID(instructions[i].u.opcode);
+        size_t next = i + opcodeLengths[opcodeID];
+
+        int operand = jumpTargetOperand(opcodeID);
+        if (!operand || instructions[i + operand].u.operand <= 0) {
+            i = next;
+            continue;
+        }
+
+        // Only forward edges are followed, so this walk terminates.
+        size_t target = i + instructions[i + operand].u.operand;
+        while (target < size) {
+            OpcodeID targetOpcodeID = interpreter->getOpcodeID(instructions[target].u.opcode);
+            if (targetOpcodeID == op_jmp) {
+                target += instructions[target + 1].u.operand;
+                continue;
+            }
+
+            // "a && b" and "a || b" in a condition branch on the same register
+            // twice; the outcome of the second test is already known.
+            if ((opcodeID == op_jtrue || opcodeID == op_jfalse) && (targetOpcodeID == op_jtrue || targetOpcodeID == op_jfalse || targetOpcodeID == op_loop_if_true)
+                && instructions[target + 1].u.operand == instructions[i + 1].u.operand) {
+                if ((targetOpcodeID == op_jfalse) != (opcodeID == op_jfalse)) {
+                    target += OPCODE_LENGTH(op_jtrue);
+                    continue;
+                }
+                if (instructions[target + 2].u.operand > 0) {
+                    target += instructions[target + 2].u.operand;
+                    continue;
+                }
+            }
+            break;
+        }
+
+        if (target != i + instructions[i + operand].u.operand) {
+            instructions[i + operand] = static_cast<int>(target - i);
+#if ENABLE(OPCODE_STATS)
+            ++OpcodeStats::threadedJumps;
+#endif
+        }
+
+        if (opcodeID == op_jmp && target < size && interpreter->getOpcodeID(instructions[target].u.opcode) == op_ret) {
+            instructions[i] = instructions[target];
+            instructions[i + 1] = instructions[target + 1];
+#if ENABLE(OPCODE_STATS)
+            ++OpcodeStats::jumpsToReturns;
+#endif
+        }
+
+        i = next;
+    }
 }
 
 PassRefPtr<Label> BytecodeGenerator::emitJump(Label* target)
@@ -623,7 +727,7 @@ PassRefPtr<Label> BytecodeGenerator::emitJump(Label* target)
 
 PassRefPtr<Label> BytecodeGenerator::emitJumpIfTrue(RegisterID* cond, Label* target)
 {
-    if (m_lastOpcodeID == op_less && !target->isForward()) {
+    if (m_lastOpcodeID == op_less) {
         int dstIndex;
         int src1Index;
         int src2Index;
@@ -634,13 +738,13 @@ PassRefPtr<Label> BytecodeGenerator::emitJumpIfTrue(RegisterID* cond, Label* tar
             rewindBinaryOp();
 
             size_t begin = instructions().size();
-            emitOpcode(op_loop_if_less);
+            emitOpcode(target->isForward() ? op_jless : op_loop_if_less);
             instructions().append(src1Index);
             instructions().append(src2Index);
             instructions().append(target->bind(begin, instructions().size()));
             return target;
         }
-    } else if (m_lastOpcodeID == op_lesseq && !target->isForward()) {
+    } else if (m_lastOpcodeID == op_lesseq) {
         int dstIndex;
         int src1Index;
         int src2Index;
@@ -651,12 +755,27 @@ PassRefPtr<Label> BytecodeGenerator::emitJumpIfTrue(RegisterID* cond, Label* tar
             rewindBinaryOp();
 
             size_t begin = instructions().size();
-            emitOpcode(op_loop_if_lesseq);
+            emitOpcode(target->isForward() ? op_jlesseq : op_loop_if_lesseq);
             instructions().append(src1Index);
             instructions().append(src2Index);
             instructions().append(target->bind(begin, instructions().size()));
             return target;
         }
+    } else if (m_lastOpcodeID == op_not && target->isForward()) {
+        int dstIndex;
+        int srcIndex;
+
+        retrieveLastUnaryOp(dstIndex, srcIndex);
+
+        if (cond->index() == dstIndex && cond->isTemporary() && !cond->refCount()) {
+            rewindUnaryOp();
+
+            size_t begin = instructions().size();
+            emitOpcode(op_jfalse);
+            instructions().append(srcIndex);
+            instructions().append(target->bind(begin, instructions().size()));
+            return target;
+        }
     } else if (m_lastOpcodeID == op_eq_null && target->isForward()) {
         int dstIndex;
         int srcIndex;
@@ -843,6 +962,9 @@ unsigned BytecodeGenerator::addRegExp(RegExp* r)
 
 RegisterID* BytecodeGenerator::emitMove(RegisterID* dst, RegisterID* src)
 {
+    if (dst->index() == src->index())
+        return dst;
+
     emitOpcode(op_mov);
     instructions().append(dst->index());
     instructions().append(src->index());
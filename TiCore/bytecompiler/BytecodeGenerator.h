@@ -377,6 +377,8 @@ namespace TI {
         void rewindBinaryOp();
         void rewindUnaryOp();
 
+        void optimizeJumps();
+
         PassRefPtr<Label> emitComplexJumpScopes(Label* target, ControlFlowContext* topScope, ControlFlowContext* bottomScope);
 
         typedef HashMap<EncodedTiValue, unsigned, EncodedTiValueHash, EncodedTiValueHashTraits> TiValueMap;
@@ -71,6 +71,9 @@ void Debugger::recompileAllTiFunctions(TiGlobalData* globalData)
     if (globalData->dynamicGlobalObject)
         return;
 
+    // Cached eval code was compiled with or without debugger hooks as well.
+    globalData->evalCodeCache.clear();
+
     typedef HashSet<FunctionExecutable*> FunctionExecutableSet;
     typedef HashMap<SourceProvider*, TiExcState*> SourceProviderMap;
 
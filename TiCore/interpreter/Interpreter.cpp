@@ -314,8 +314,7 @@ NEVER_INLINE TiValue Interpreter::callEval(CallFrame* callFrame, RegisterFile* r
         return parsedObject;
 
     ScopeChainNode* scopeChain = callFrame->scopeChain();
-    CodeBlock* codeBlock = callFrame->codeBlock();
-    RefPtr<EvalExecutable> eval = codeBlock->evalCodeCache().get(callFrame, programSource, scopeChain, exceptionValue);
+    RefPtr<EvalExecutable> eval = callFrame->globalData().evalCodeCache.get(callFrame, programSource, scopeChain, exceptionValue);
 
     TiValue result = jsUndefined();
     if (eval)
@@ -663,6 +662,7 @@ TiValue Interpreter::execute(FunctionExecutable* functionExecutable, CallFrame*
     for (ArgList::const_iterator it = args.begin(); it != end; ++it)
         newCallFrame->r(++dst) = *it;
 
+    functionExecutable->resetCodeAge();
     CodeBlock* codeBlock = &functionExecutable->bytecode(callFrame, scopeChain);
     newCallFrame = slideRegisterWindowForCall(codeBlock, &m_registerFile, newCallFrame, argc + RegisterFile::CallFrameHeaderSize, argc);
     if (UNLIKELY(!newCallFrame)) {
@@ -721,6 +721,7 @@ CallFrameClosure Interpreter::prepareForRepeatCall(FunctionExecutable* FunctionE
     for (int i = 0; i < argc; ++i)
         newCallFrame->r(++dst) = jsUndefined();
     
+    FunctionExecutable->resetCodeAge();
     CodeBlock* codeBlock = &FunctionExecutable->bytecode(callFrame, scopeChain);
     newCallFrame = slideRegisterWindowForCall(codeBlock, &m_registerFile, newCallFrame, argc + RegisterFile::CallFrameHeaderSize, argc);
     if (UNLIKELY(!newCallFrame)) {
@@ -1119,7 +1120,6 @@ TiValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
 
     Instruction* vPC = callFrame->codeBlock()->instructions().begin();
     Profiler** enabledProfilerReference = Profiler::enabledProfilerReference();
-    unsigned tickCount = globalData->timeoutChecker.ticksUntilNextCheck();
 
 #define CHECK_FOR_EXCEPTION() \
     do { \
@@ -1134,12 +1134,9 @@ TiValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
 #endif
 
 #define CHECK_FOR_TIMEOUT() \
-    if (!--tickCount) { \
-        if (globalData->timeoutChecker.didTimeOut(callFrame)) { \
-            exceptionValue = jsNull(); \
-            goto vm_throw; \
-        } \
-        tickCount = globalData->timeoutChecker.ticksUntilNextCheck(); \
+    if (UNLIKELY(globalData->terminationRequested) && globalData->shouldTerminateExecution()) { \
+        exceptionValue = createInterruptedExecutionException(globalData); \
+        goto vm_throw; \
     }
     
 #if ENABLE(OPCODE_SAMPLING)
@@ -2797,6 +2794,52 @@ TiValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
         vPC += OPCODE_LENGTH(op_loop_if_lesseq);
         NEXT_INSTRUCTION();
     }
+    DEFINE_OPCODE(op_jless) {
+        /* jless src1(r) src2(r) target(offset)
+
+           Checks whether register src1 is less than register src2, as
+           with the ECMAScript '<' operator, and then jumps to offset
+           target from the current instruction, if and only if the 
+           result of the comparison is true.
+        */
+        TiValue src1 = callFrame->r(vPC[1].u.operand).jsValue();
+        TiValue src2 = callFrame->r(vPC[2].u.operand).jsValue();
+        int target = vPC[3].u.operand;
+
+        bool result = jsLess(callFrame, src1, src2);
+        CHECK_FOR_EXCEPTION();
+        
+        if (result) {
+            vPC += target;
+            NEXT_INSTRUCTION();
+        }
+
+        vPC += OPCODE_LENGTH(op_jless);
+        NEXT_INSTRUCTION();
+    }
+    DEFINE_OPCODE(op_jlesseq) {
+        /* jlesseq src1(r) src2(r) target(offset)
+
+           Checks whether register src1 is less than or equal to
+           register src2, as with the ECMAScript '<=' operator,
+           and then jumps to offset target from the current instruction,
+           if and only if the result of the comparison is true.
+        */
+        TiValue src1 = callFrame->r(vPC[1].u.operand).jsValue();
+        TiValue src2 = callFrame->r(vPC[2].u.operand).jsValue();
+        int target = vPC[3].u.operand;
+
+        bool result = jsLessEq(callFrame, src1, src2);
+        CHECK_FOR_EXCEPTION();
+        
+        if (result) {
+            vPC += target;
+            NEXT_INSTRUCTION();
+        }
+
+        vPC += OPCODE_LENGTH(op_jlesseq);
+        NEXT_INSTRUCTION();
+    }
     DEFINE_OPCODE(op_jnless) {
         /* jnless src1(r) src2(r) target(offset)
 
@@ -3016,6 +3059,7 @@ TiValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
 
         if (callType == CallTypeJS) {
             ScopeChainNode* callDataScopeChain = callData.js.scopeChain;
+            callData.js.functionExecutable->resetCodeAge();
             CodeBlock* newCodeBlock = &callData.js.functionExecutable->bytecode(callFrame, callDataScopeChain);
 
             CallFrame* previousCallFrame = callFrame;
@@ -3170,6 +3214,7 @@ TiValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
         
         if (callType == CallTypeJS) {
             ScopeChainNode* callDataScopeChain = callData.js.scopeChain;
+            callData.js.functionExecutable->resetCodeAge();
             CodeBlock* newCodeBlock = &callData.js.functionExecutable->bytecode(callFrame, callDataScopeChain);
             
             CallFrame* previousCallFrame = callFrame;
@@ -3309,6 +3354,7 @@ TiValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
         for (size_t count = codeBlock->m_numVars; i < count; ++i)
             callFrame->r(i) = jsUndefined();
 
+        CHECK_FOR_TIMEOUT();
         vPC += OPCODE_LENGTH(op_enter);
         NEXT_INSTRUCTION();
     }
@@ -3336,6 +3382,7 @@ TiValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
         callFrame->r(dst) = TiValue(activation);
         callFrame->setScopeChain(callFrame->scopeChain()->copy()->push(activation));
 
+        CHECK_FOR_TIMEOUT();
         vPC += OPCODE_LENGTH(op_enter_with_activation);
         NEXT_INSTRUCTION();
     }
@@ -3418,6 +3465,7 @@ TiValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
 
         if (constructType == ConstructTypeJS) {
             ScopeChainNode* callDataScopeChain = constructData.js.scopeChain;
+            constructData.js.functionExecutable->resetCodeAge();
             CodeBlock* newCodeBlock = &constructData.js.functionExecutable->bytecode(callFrame, callDataScopeChain);
 
             Structure* structure;
@@ -3831,11 +3879,6 @@ TiValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
     }
     vm_throw: {
         globalData->exception = TiValue();
-        if (!tickCount) {
-            // The exceptionValue is a lie! (GCC produces bad code for reasons I 
-            // cannot fathom if we don't assign to the exceptionValue before branching)
-            exceptionValue = createInterruptedExecutionException(globalData);
-        }
         handler = throwException(callFrame, exceptionValue, vPC - callFrame->codeBlock()->instructions().begin(), false);
         if (!handler) {
             *exception = exceptionValue;
@@ -143,8 +143,8 @@ namespace TI {
 
         Register* lastGlobal() const { return m_start - m_numGlobals; }
         
-        void markGlobals(MarkStack& markStack, Heap* heap) { heap->markConservatively(markStack, lastGlobal(), m_start); }
-        void markCallFrames(MarkStack& markStack, Heap* heap) { heap->markConservatively(markStack, m_start, m_end); }
+        void markGlobals(MarkStack& markStack, Heap* heap) { heap->markRegisters(markStack, lastGlobal(), m_start); }
+        void markCallFrames(MarkStack& markStack, Heap* heap) { heap->markRegisters(markStack, m_start, m_end); }
 
     private:
         void releaseExcessCapacity();
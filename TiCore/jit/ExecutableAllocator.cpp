@@ -34,12 +34,19 @@
 
 #include "ExecutableAllocator.h"
 
+#include "TiGlobalData.h"
+
 #if ENABLE(ASSEMBLER)
 
 namespace TI {
 
 size_t ExecutableAllocator::pageSize = 0;
 
+void ExecutableAllocator::memoryLimitExceeded()
+{
+    m_globalData->resourceLimits.executableMemoryLimitExceeded();
+}
+
 }
 
 #endif // HAVE(ASSEMBLER)
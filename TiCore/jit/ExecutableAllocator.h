@@ -80,6 +80,9 @@ inline size_t roundUpAllocationSize(size_t request, size_t granularity)
 
 namespace TI {
 
+class ExecutableAllocator;
+class TiGlobalData;
+
 class ExecutablePool : public RefCounted<ExecutablePool> {
 private:
     struct Allocation {
@@ -92,9 +95,9 @@ private:
     typedef Vector<Allocation, 2> AllocationList;
 
 public:
-    static PassRefPtr<ExecutablePool> create(size_t n)
+    static PassRefPtr<ExecutablePool> create(ExecutableAllocator* allocator, size_t n)
     {
-        return adoptRef(new ExecutablePool(n));
+        return adoptRef(new ExecutablePool(allocator, n));
     }
 
     void* alloc(size_t n)
@@ -116,12 +119,7 @@ public:
         return poolAllocate(n);
     }
     
-    ~ExecutablePool()
-    {
-        AllocationList::const_iterator end = m_pools.end();
-        for (AllocationList::const_iterator ptr = m_pools.begin(); ptr != end; ++ptr)
-            ExecutablePool::systemRelease(*ptr);
-    }
+    ~ExecutablePool();
 
     size_t available() const { return (m_pools.size() > 1) ? 0 : m_end - m_freePtr; }
 
@@ -129,10 +127,11 @@ private:
     static Allocation systemAlloc(size_t n);
     static void systemRelease(const Allocation& alloc);
 
-    ExecutablePool(size_t n);
+    ExecutablePool(ExecutableAllocator*, size_t n);
 
     void* poolAllocate(size_t n);
 
+    ExecutableAllocator* m_allocator;
     char* m_freePtr;
     char* m_end;
     AllocationList m_pools;
@@ -143,11 +142,34 @@ class ExecutableAllocator {
 
 public:
     static size_t pageSize;
-    ExecutableAllocator()
+    ExecutableAllocator(TiGlobalData* globalData)
+        : m_globalData(globalData)
+        , m_committedBytes(0)
+        , m_memoryLimit(0)
     {
         if (!pageSize)
             intializePageSize();
-        m_smallAllocationPool = ExecutablePool::create(JIT_ALLOCATOR_LARGE_ALLOC_SIZE);
+        m_smallAllocationPool = ExecutablePool::create(this, JIT_ALLOCATOR_LARGE_ALLOC_SIZE);
+    }
+
+    // The memory held by all pools, in bytes.
+    size_t committedBytes() const { return m_committedBytes; }
+
+    // Growing past limit bytes is reported to the TiGlobalData's resource
+    // limits. Zero means no limit.
+    void setMemoryLimit(size_t limit) { m_memoryLimit = limit; }
+
+    void didAllocate(size_t size)
+    {
+        m_committedBytes += size;
+        if (m_memoryLimit && m_committedBytes > m_memoryLimit)
+            memoryLimitExceeded();
+    }
+
+    void didRelease(size_t size)
+    {
+        ASSERT(m_committedBytes >= size);
+        m_committedBytes -= size;
     }
 
     PassRefPtr<ExecutablePool> poolForSize(size_t n)
@@ -158,10 +180,10 @@ public:
 
         // If the request is large, we just provide a unshared allocator
         if (n > JIT_ALLOCATOR_LARGE_ALLOC_SIZE)
-            return ExecutablePool::create(n);
+            return ExecutablePool::create(this, n);
 
         // Create a new allocator
-        RefPtr<ExecutablePool> pool = ExecutablePool::create(JIT_ALLOCATOR_LARGE_ALLOC_SIZE);
+        RefPtr<ExecutablePool> pool = ExecutablePool::create(this, JIT_ALLOCATOR_LARGE_ALLOC_SIZE);
 
         // If the new allocator will result in more free space than in
         // the current small allocator, then we will use it instead
@@ -243,11 +265,17 @@ private:
     static void reprotectRegion(void*, size_t, ProtectionSeting);
 #endif
 
+    void memoryLimitExceeded();
+
+    TiGlobalData* m_globalData;
+    size_t m_committedBytes;
+    size_t m_memoryLimit;
     RefPtr<ExecutablePool> m_smallAllocationPool;
     static void intializePageSize();
 };
 
-inline ExecutablePool::ExecutablePool(size_t n)
+inline ExecutablePool::ExecutablePool(ExecutableAllocator* allocator, size_t n)
+    : m_allocator(allocator)
 {
     size_t allocSize = roundUpAllocationSize(n, JIT_ALLOCATOR_PAGE_SIZE);
     Allocation mem = systemAlloc(allocSize);
@@ -256,6 +284,16 @@ inline ExecutablePool::ExecutablePool(size_t n)
     if (!m_freePtr)
         CRASH(); // Failed to allocate
     m_end = m_freePtr + allocSize;
+    m_allocator->didAllocate(allocSize);
+}
+
+inline ExecutablePool::~ExecutablePool()
+{
+    AllocationList::const_iterator end = m_pools.end();
+    for (AllocationList::const_iterator ptr = m_pools.begin(); ptr != end; ++ptr) {
+        m_allocator->didRelease(ptr->size);
+        ExecutablePool::systemRelease(*ptr);
+    }
 }
 
 inline void* ExecutablePool::poolAllocate(size_t n)
@@ -274,6 +312,7 @@ inline void* ExecutablePool::poolAllocate(size_t n)
     }
 
     m_pools.append(result);
+    m_allocator->didAllocate(allocSize);
     return result.pages;
 }
 
@@ -103,18 +103,18 @@ JIT::JIT(TiGlobalData* globalData, CodeBlock* codeBlock)
 #if USE(JSVALUE32_64)
 void JIT::emitTimeoutCheck()
 {
-    Jump skipTimeout = branchSub32(NonZero, Imm32(1), timeoutCheckRegister);
+    Jump skipTimeout = branch32(Equal, AbsoluteAddress(const_cast<int*>(&m_globalData->terminationRequested)), Imm32(0));
     JITStubCall stubCall(this, cti_timeout_check);
     stubCall.addArgument(regT1, regT0); // save last result registers.
-    stubCall.call(timeoutCheckRegister);
+    stubCall.call();
     stubCall.getArgument(0, regT1, regT0); // reload last result registers.
     skipTimeout.link(this);
 }
 #else
 void JIT::emitTimeoutCheck()
 {
-    Jump skipTimeout = branchSub32(NonZero, Imm32(1), timeoutCheckRegister);
-    JITStubCall(this, cti_timeout_check).call(timeoutCheckRegister);
+    Jump skipTimeout = branch32(Equal, AbsoluteAddress(const_cast<int*>(&m_globalData->terminationRequested)), Imm32(0));
+    JITStubCall(this, cti_timeout_check).call();
     skipTimeout.link(this);
 
     killLastResultRegister();
@@ -256,6 +256,8 @@ void JIT::privateCompileMainPass()
         DEFINE_OP(op_jmp)
         DEFINE_OP(op_jmp_scopes)
         DEFINE_OP(op_jneq_null)
+        DEFINE_OP(op_jless)
+        DEFINE_OP(op_jlesseq)
         DEFINE_OP(op_jneq_ptr)
         DEFINE_OP(op_jnless)
         DEFINE_OP(op_jnlesseq)
@@ -396,6 +398,8 @@ void JIT::privateCompileSlowCases()
         DEFINE_SLOWCASE_OP(op_get_by_pname)
         DEFINE_SLOWCASE_OP(op_instanceof)
         DEFINE_SLOWCASE_OP(op_jfalse)
+        DEFINE_SLOWCASE_OP(op_jless)
+        DEFINE_SLOWCASE_OP(op_jlesseq)
         DEFINE_SLOWCASE_OP(op_jnless)
         DEFINE_SLOWCASE_OP(op_jnlesseq)
         DEFINE_SLOWCASE_OP(op_jtrue)
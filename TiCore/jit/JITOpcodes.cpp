@@ -126,6 +126,8 @@ void JIT::privateCompileCTIMachineTrampolines(RefPtr<ExecutablePool>* executable
     restoreReturnAddressBeforeReturn(regT3);
     loadPtr(Address(regT0, OBJECT_OFFSETOF(TiFunction, m_executable)), regT2);
     hasCodeBlock3.link(this);
+    // Calls through here are not linked, so they keep the callee's code young.
+    store32(Imm32(0), Address(regT2, OBJECT_OFFSETOF(FunctionExecutable, m_codeAge)));
     
     // Check argCount matches callee arity.
     Jump arityCheckOkay3 = branch32(Equal, Address(regT2, OBJECT_OFFSETOF(FunctionExecutable, m_numParameters)), regT1);
@@ -363,14 +365,12 @@ void JIT::emit_op_loop(Instruction* currentInstruction)
     addJump(jump(), target);
 }
 
-void JIT::emit_op_loop_if_less(Instruction* currentInstruction)
+void JIT::emit_op_jless(Instruction* currentInstruction)
 {
     unsigned op1 = currentInstruction[1].u.operand;
     unsigned op2 = currentInstruction[2].u.operand;
     unsigned target = currentInstruction[3].u.operand;
 
-    emitTimeoutCheck();
-
     if (isOperandConstantImmediateInt(op1)) {
         emitLoad(op2, regT1, regT0);
         addSlowCase(branch32(NotEqual, regT1, Imm32(TiValue::Int32Tag)));
@@ -391,7 +391,13 @@ void JIT::emit_op_loop_if_less(Instruction* currentInstruction)
     addJump(branch32(LessThan, regT0, regT2), target);
 }
 
-void JIT::emitSlow_op_loop_if_less(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
+void JIT::emit_op_loop_if_less(Instruction* currentInstruction)
+{
+    emitTimeoutCheck();
+    emit_op_jless(currentInstruction);
+}
+
+void JIT::emitSlow_op_jless(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
 {
     unsigned op1 = currentInstruction[1].u.operand;
     unsigned op2 = currentInstruction[2].u.operand;
@@ -401,21 +407,24 @@ void JIT::emitSlow_op_loop_if_less(Instruction* currentInstruction, Vector<SlowC
         linkSlowCase(iter); // int32 check
     linkSlowCase(iter); // int32 check
 
-    JITStubCall stubCall(this, cti_op_loop_if_less);
+    JITStubCall stubCall(this, cti_op_jless);
     stubCall.addArgument(op1);
     stubCall.addArgument(op2);
     stubCall.call();
     emitJumpSlowToHot(branchTest32(NonZero, regT0), target);
 }
 
-void JIT::emit_op_loop_if_lesseq(Instruction* currentInstruction)
+void JIT::emitSlow_op_loop_if_less(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
+{
+    emitSlow_op_jless(currentInstruction, iter);
+}
+
+void JIT::emit_op_jlesseq(Instruction* currentInstruction)
 {
     unsigned op1 = currentInstruction[1].u.operand;
     unsigned op2 = currentInstruction[2].u.operand;
     unsigned target = currentInstruction[3].u.operand;
 
-    emitTimeoutCheck();
-
     if (isOperandConstantImmediateInt(op1)) {
         emitLoad(op2, regT1, regT0);
         addSlowCase(branch32(NotEqual, regT1, Imm32(TiValue::Int32Tag)));
@@ -436,7 +445,13 @@ void JIT::emit_op_loop_if_lesseq(Instruction* currentInstruction)
     addJump(branch32(LessThanOrEqual, regT0, regT2), target);
 }
 
-void JIT::emitSlow_op_loop_if_lesseq(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
+void JIT::emit_op_loop_if_lesseq(Instruction* currentInstruction)
+{
+    emitTimeoutCheck();
+    emit_op_jlesseq(currentInstruction);
+}
+
+void JIT::emitSlow_op_jlesseq(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
 {
     unsigned op1 = currentInstruction[1].u.operand;
     unsigned op2 = currentInstruction[2].u.operand;
@@ -446,13 +461,18 @@ void JIT::emitSlow_op_loop_if_lesseq(Instruction* currentInstruction, Vector<Slo
         linkSlowCase(iter); // int32 check
     linkSlowCase(iter); // int32 check
 
-    JITStubCall stubCall(this, cti_op_loop_if_lesseq);
+    JITStubCall stubCall(this, cti_op_jlesseq);
     stubCall.addArgument(op1);
     stubCall.addArgument(op2);
     stubCall.call();
     emitJumpSlowToHot(branchTest32(NonZero, regT0), target);
 }
 
+void JIT::emitSlow_op_loop_if_lesseq(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
+{
+    emitSlow_op_jlesseq(currentInstruction, iter);
+}
+
 void JIT::emit_op_new_object(Instruction* currentInstruction)
 {
     JITStubCall(this, cti_op_new_object).call(currentInstruction[1].u.operand);
@@ -1448,13 +1468,20 @@ void JIT::emit_op_enter(Instruction*)
     // object lifetime and increasing GC pressure.
     for (int i = 0; i < m_codeBlock->m_numVars; ++i)
         emitStore(i, jsUndefined());
+
+    emitTimeoutCheck();
 }
 
 void JIT::emit_op_enter_with_activation(Instruction* currentInstruction)
 {
-    emit_op_enter(currentInstruction);
+    // Even though JIT code doesn't use them, we initialize our constant
+    // registers to zap stale pointers, to avoid unnecessarily prolonging
+    // object lifetime and increasing GC pressure.
+    for (int i = 0; i < m_codeBlock->m_numVars; ++i)
+        emitStore(i, jsUndefined());
 
     JITStubCall(this, cti_op_push_activation).call(currentInstruction[1].u.operand);
+    emitTimeoutCheck();
 }
 
 void JIT::emit_op_create_arguments(Instruction*)
@@ -1605,6 +1632,8 @@ void JIT::privateCompileCTIMachineTrampolines(RefPtr<ExecutablePool>* executable
     restoreReturnAddressBeforeReturn(regT3);
     loadPtr(Address(regT0, OBJECT_OFFSETOF(TiFunction, m_executable)), regT2);
     hasCodeBlock3.link(this);
+    // Calls through here are not linked, so they keep the callee's code young.
+    store32(Imm32(0), Address(regT2, OBJECT_OFFSETOF(FunctionExecutable, m_codeAge)));
     
     // Check argCount matches callee arity.
     Jump arityCheckOkay3 = branch32(Equal, Address(regT2, OBJECT_OFFSETOF(FunctionExecutable, m_numParameters)), regT1);
@@ -1917,10 +1946,8 @@ void JIT::emit_op_loop(Instruction* currentInstruction)
     addJump(jump(), target);
 }
 
-void JIT::emit_op_loop_if_less(Instruction* currentInstruction)
+void JIT::emit_op_jless(Instruction* currentInstruction)
 {
-    emitTimeoutCheck();
-
     unsigned op1 = currentInstruction[1].u.operand;
     unsigned op2 = currentInstruction[2].u.operand;
     unsigned target = currentInstruction[3].u.operand;
@@ -1950,10 +1977,14 @@ void JIT::emit_op_loop_if_less(Instruction* currentInstruction)
     }
 }
 
-void JIT::emit_op_loop_if_lesseq(Instruction* currentInstruction)
+void JIT::emit_op_loop_if_less(Instruction* currentInstruction)
 {
     emitTimeoutCheck();
+    emit_op_jless(currentInstruction);
+}
 
+void JIT::emit_op_jlesseq(Instruction* currentInstruction)
+{
     unsigned op1 = currentInstruction[1].u.operand;
     unsigned op2 = currentInstruction[2].u.operand;
     unsigned target = currentInstruction[3].u.operand;
@@ -1974,6 +2005,12 @@ void JIT::emit_op_loop_if_lesseq(Instruction* currentInstruction)
     }
 }
 
+void JIT::emit_op_loop_if_lesseq(Instruction* currentInstruction)
+{
+    emitTimeoutCheck();
+    emit_op_jlesseq(currentInstruction);
+}
+
 void JIT::emit_op_new_object(Instruction* currentInstruction)
 {
     JITStubCall(this, cti_op_new_object).call(currentInstruction[1].u.operand);
@@ -2773,6 +2810,7 @@ void JIT::emit_op_enter(Instruction*)
     for (size_t j = 0; j < count; ++j)
         emitInitRegister(j);
 
+    emitTimeoutCheck();
 }
 
 void JIT::emit_op_enter_with_activation(Instruction* currentInstruction)
@@ -2785,6 +2823,7 @@ void JIT::emit_op_enter_with_activation(Instruction* currentInstruction)
         emitInitRegister(j);
 
     JITStubCall(this, cti_op_push_activation).call(currentInstruction[1].u.operand);
+    emitTimeoutCheck();
 }
 
 void JIT::emit_op_create_arguments(Instruction*)
@@ -2882,21 +2921,21 @@ void JIT::emitSlow_op_get_by_val(Instruction* currentInstruction, Vector<SlowCas
     stubCall.call(dst);
 }
 
-void JIT::emitSlow_op_loop_if_less(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
+void JIT::emitSlow_op_jless(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
 {
     unsigned op1 = currentInstruction[1].u.operand;
     unsigned op2 = currentInstruction[2].u.operand;
     unsigned target = currentInstruction[3].u.operand;
     if (isOperandConstantImmediateInt(op2)) {
         linkSlowCase(iter);
-        JITStubCall stubCall(this, cti_op_loop_if_less);
+        JITStubCall stubCall(this, cti_op_jless);
         stubCall.addArgument(regT0);
         stubCall.addArgument(op2, regT2);
         stubCall.call();
         emitJumpSlowToHot(branchTest32(NonZero, regT0), target);
     } else if (isOperandConstantImmediateInt(op1)) {
         linkSlowCase(iter);
-        JITStubCall stubCall(this, cti_op_loop_if_less);
+        JITStubCall stubCall(this, cti_op_jless);
         stubCall.addArgument(op1, regT2);
         stubCall.addArgument(regT0);
         stubCall.call();
@@ -2904,7 +2943,7 @@ void JIT::emitSlow_op_loop_if_less(Instruction* currentInstruction, Vector<SlowC
     } else {
         linkSlowCase(iter);
         linkSlowCase(iter);
-        JITStubCall stubCall(this, cti_op_loop_if_less);
+        JITStubCall stubCall(this, cti_op_jless);
         stubCall.addArgument(regT0);
         stubCall.addArgument(regT1);
         stubCall.call();
@@ -2912,13 +2951,18 @@ void JIT::emitSlow_op_loop_if_less(Instruction* currentInstruction, Vector<SlowC
     }
 }
 
-void JIT::emitSlow_op_loop_if_lesseq(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
+void JIT::emitSlow_op_loop_if_less(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
+{
+    emitSlow_op_jless(currentInstruction, iter);
+}
+
+void JIT::emitSlow_op_jlesseq(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
 {
     unsigned op2 = currentInstruction[2].u.operand;
     unsigned target = currentInstruction[3].u.operand;
     if (isOperandConstantImmediateInt(op2)) {
         linkSlowCase(iter);
-        JITStubCall stubCall(this, cti_op_loop_if_lesseq);
+        JITStubCall stubCall(this, cti_op_jlesseq);
         stubCall.addArgument(regT0);
         stubCall.addArgument(currentInstruction[2].u.operand, regT2);
         stubCall.call();
@@ -2926,7 +2970,7 @@ void JIT::emitSlow_op_loop_if_lesseq(Instruction* currentInstruction, Vector<Slo
     } else {
         linkSlowCase(iter);
         linkSlowCase(iter);
-        JITStubCall stubCall(this, cti_op_loop_if_lesseq);
+        JITStubCall stubCall(this, cti_op_jlesseq);
         stubCall.addArgument(regT0);
         stubCall.addArgument(regT1);
         stubCall.call();
@@ -2934,6 +2978,11 @@ void JIT::emitSlow_op_loop_if_lesseq(Instruction* currentInstruction, Vector<Slo
     }
 }
 
+void JIT::emitSlow_op_loop_if_lesseq(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
+{
+    emitSlow_op_jlesseq(currentInstruction, iter);
+}
+
 void JIT::emitSlow_op_put_by_val(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
 {
     unsigned base = currentInstruction[1].u.operand;
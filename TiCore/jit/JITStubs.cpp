@@ -109,7 +109,6 @@ SYMBOL_STRING(ctiTrampoline) ":" "\n"
     "pushl %edi" "\n"
     "pushl %ebx" "\n"
     "subl $0x3c, %esp" "\n"
-    "movl $512, %esi" "\n"
     "movl 0x58(%esp), %edi" "\n"
     "call *0x50(%esp)" "\n"
     "addl $0x3c, %esp" "\n"
@@ -170,7 +169,6 @@ SYMBOL_STRING(ctiTrampoline) ":" "\n"
     "pushq %r15" "\n"
     "pushq %rbx" "\n"
     "subq $0x48, %rsp" "\n"
-    "movq $512, %r12" "\n"
     "movq $0xFFFF000000000000, %r14" "\n"
     "movq $0xFFFF000000000002, %r15" "\n"
     "movq 0x90(%rsp), %r13" "\n"
@@ -235,7 +233,6 @@ SYMBOL_STRING(ctiTrampoline) ":" "\n"
     "str r2, [sp, #0x34]" "\n"
     "str r3, [sp, #0x38]" "\n"
     "cpy r5, r2" "\n"
-    "mov r6, #512" "\n"
     "blx r0" "\n"
     "ldr r6, [sp, #0x2c]" "\n"
     "ldr r5, [sp, #0x28]" "\n"
@@ -301,7 +298,6 @@ extern "C" {
             push edi;
             push ebx;
             sub esp, 0x3c;
-            mov esi, 512;
             mov ecx, esp;
             mov edi, [esp + 0x58];
             call [esp + 0x50];
@@ -362,7 +358,6 @@ SYMBOL_STRING(ctiTrampoline) ":" "\n"
     "pushl %edi" "\n"
     "pushl %ebx" "\n"
     "subl $0x1c, %esp" "\n"
-    "movl $512, %esi" "\n"
     "movl 0x38(%esp), %edi" "\n"
     "call *0x30(%esp)" "\n"
     "addl $0x1c, %esp" "\n"
@@ -429,7 +424,6 @@ SYMBOL_STRING(ctiTrampoline) ":" "\n"
     "pushq %rsi" "\n"
     "pushq %rdi" "\n"
     "subq $0x48, %rsp" "\n"
-    "movq $512, %r12" "\n"
     "movq $0xFFFF000000000000, %r14" "\n"
     "movq $0xFFFF000000000002, %r15" "\n"
     "movq %rdx, %r13" "\n"
@@ -494,7 +488,6 @@ SYMBOL_STRING(ctiTrampoline) ":" "\n"
     "str r2, [sp, #0x34]" "\n"
     "str r3, [sp, #0x38]" "\n"
     "cpy r5, r2" "\n"
-    "mov r6, #512" "\n"
     "blx r0" "\n"
     "ldr r6, [sp, #0x2c]" "\n"
     "ldr r5, [sp, #0x28]" "\n"
@@ -545,7 +538,6 @@ SYMBOL_STRING(ctiTrampoline) ":" "\n"
     "stmdb sp!, {r4-r8, lr}" "\n"
     "sub sp, sp, #36" "\n"
     "mov r4, r2" "\n"
-    "mov r5, #512" "\n"
     "mov lr, pc" "\n"
     "mov pc, r0" "\n"
     "add sp, sp, #36" "\n"
@@ -592,7 +584,6 @@ extern "C" {
             push edi;
             push ebx;
             sub esp, 0x1c;
-            mov esi, 512;
             mov ecx, esp;
             mov edi, [esp + 0x38];
             call [esp + 0x30];
@@ -1009,19 +1000,15 @@ DEFINE_STUB_FUNCTION(EncodedTiValue, op_pre_inc)
     return TiValue::encode(result);
 }
 
-DEFINE_STUB_FUNCTION(int, timeout_check)
+DEFINE_STUB_FUNCTION(void, timeout_check)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
     
     TiGlobalData* globalData = stackFrame.globalData;
-    TimeoutChecker& timeoutChecker = globalData->timeoutChecker;
-
-    if (timeoutChecker.didTimeOut(stackFrame.callFrame)) {
+    if (globalData->terminationRequested && globalData->shouldTerminateExecution()) {
         globalData->exception = createInterruptedExecutionException(globalData);
         VM_THROW_EXCEPTION_AT_END();
     }
-    
-    return timeoutChecker.ticksUntilNextCheck();
 }
 
 DEFINE_STUB_FUNCTION(void, register_file_check)
@@ -1038,32 +1025,6 @@ DEFINE_STUB_FUNCTION(void, register_file_check)
     throwStackOverflowError(oldCallFrame, stackFrame.globalData, ReturnAddressPtr(oldCallFrame->returnPC()), STUB_RETURN_ADDRESS);
 }
 
-DEFINE_STUB_FUNCTION(int, op_loop_if_less)
-{
-    STUB_INIT_STACK_FRAME(stackFrame);
-
-    TiValue src1 = stackFrame.args[0].jsValue();
-    TiValue src2 = stackFrame.args[1].jsValue();
-    CallFrame* callFrame = stackFrame.callFrame;
-
-    bool result = jsLess(callFrame, src1, src2);
-    CHECK_FOR_EXCEPTION_AT_END();
-    return result;
-}
-
-DEFINE_STUB_FUNCTION(int, op_loop_if_lesseq)
-{
-    STUB_INIT_STACK_FRAME(stackFrame);
-
-    TiValue src1 = stackFrame.args[0].jsValue();
-    TiValue src2 = stackFrame.args[1].jsValue();
-    CallFrame* callFrame = stackFrame.callFrame;
-
-    bool result = jsLessEq(callFrame, src1, src2);
-    CHECK_FOR_EXCEPTION_AT_END();
-    return result;
-}
-
 DEFINE_STUB_FUNCTION(TiObject*, op_new_object)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
@@ -1510,6 +1471,7 @@ DEFINE_STUB_FUNCTION(void*, op_call_TiFunction)
     ASSERT(!function->isHostFunction());
     FunctionExecutable* executable = function->jsExecutable();
     ScopeChainNode* callDataScopeChain = function->scope().node();
+    executable->resetCodeAge();
     executable->jitCode(stackFrame.callFrame, callDataScopeChain);
 
     return function;
@@ -1571,8 +1533,11 @@ DEFINE_STUB_FUNCTION(void*, vm_lazyLinkCall)
     JITCode& jitCode = executable->generatedJITCode();
     
     CodeBlock* codeBlock = 0;
-    if (!executable->isHostFunction())
-        codeBlock = &static_cast<FunctionExecutable*>(executable)->bytecode(stackFrame.callFrame, callee->scope().node());
+    if (!executable->isHostFunction()) {
+        FunctionExecutable* functionExecutable = static_cast<FunctionExecutable*>(executable);
+        functionExecutable->resetCodeAge();
+        codeBlock = &functionExecutable->bytecode(stackFrame.callFrame, callee->scope().node());
+    }
     CallLinkInfo* callLinkInfo = &stackFrame.callFrame->callerFrame()->codeBlock()->getCallLinkInfo(stackFrame.args[1].returnAddress());
 
     if (!callLinkInfo->seenOnce())
@@ -288,6 +288,7 @@ TiValue JSC_HOST_CALL arrayProtoFuncJoin(TiExcState* exec, TiObject*, TiValue th
     UChar comma = ',';
     UString separator = args.at(0).isUndefined() ? UString(&comma, 1) : args.at(0).toString(exec);
 
+    bool isRealArray = isTiArray(&exec->globalData(), thisObj);
     unsigned length = thisObj->get(exec, exec->propertyNames().length).toUInt32(exec);
     for (unsigned k = 0; k < length; k++) {
         if (k >= 1)
@@ -298,7 +299,11 @@ TiValue JSC_HOST_CALL arrayProtoFuncJoin(TiExcState* exec, TiObject*, TiValue th
             break;
         }
 
-        TiValue element = thisObj->get(exec, k);
+        TiValue element;
+        if (isRealArray && asArray(thisObj)->canGetIndex(k))
+            element = asArray(thisObj)->getIndex(k);
+        else
+            element = thisObj->get(exec, k);
         if (element.isUndefinedOrNull())
             continue;
 
@@ -325,7 +330,11 @@ TiValue JSC_HOST_CALL arrayProtoFuncConcat(TiExcState* exec, TiObject*, TiValue
     ArgList::const_iterator it = args.begin();
     ArgList::const_iterator end = args.end();
     while (1) {
-        if (curArg.inherits(&TiArray::info)) {
+        // Trailing holes from an earlier argument leave arr shorter than n.
+        if (isTiArray(&exec->globalData(), curArg) && asArray(curArg)->isDense() && arr->length() == static_cast<unsigned>(n)
+            && arr->appendDenseValues(asArray(curArg)->denseValues(), asArray(curArg)->length()))
+            n += asArray(curArg)->length();
+        else if (curArg.inherits(&TiArray::info)) {
             unsigned length = curArg.get(exec, exec->propertyNames().length).toUInt32(exec);
             TiObject* curObject = curArg.toObject(exec);
             for (unsigned k = 0; k < length; ++k) {
@@ -367,10 +376,14 @@ TiValue JSC_HOST_CALL arrayProtoFuncPop(TiExcState* exec, TiObject*, TiValue thi
 
 TiValue JSC_HOST_CALL arrayProtoFuncPush(TiExcState* exec, TiObject*, TiValue thisValue, const ArgList& args)
 {
-    if (isTiArray(&exec->globalData(), thisValue) && args.size() == 1) {
+    if (isTiArray(&exec->globalData(), thisValue)) {
         TiArray* array = asArray(thisValue);
-        array->push(exec, *args.begin());
-        return jsNumber(exec, array->length());
+        if (args.size() == 1) {
+            array->push(exec, *args.begin());
+            return jsNumber(exec, array->length());
+        }
+        if (array->appendDenseValues(args.begin(), args.size()))
+            return jsNumber(exec, array->length());
     }
 
     TiObject* thisObj = thisValue.toThisObject(exec);
@@ -384,6 +397,12 @@ TiValue JSC_HOST_CALL arrayProtoFuncPush(TiExcState* exec, TiObject*, TiValue th
 
 TiValue JSC_HOST_CALL arrayProtoFuncReverse(TiExcState* exec, TiObject*, TiValue thisValue, const ArgList&)
 {
+    if (isTiArray(&exec->globalData(), thisValue) && asArray(thisValue)->isDense()) {
+        TiArray* array = asArray(thisValue);
+        std::reverse(array->denseValues(), array->denseValues() + array->length());
+        return array;
+    }
+
     TiObject* thisObj = thisValue.toThisObject(exec);
     unsigned length = thisObj->get(exec, exec->propertyNames().length).toUInt32(exec);
     unsigned middle = length / 2;
@@ -417,13 +436,15 @@ TiValue JSC_HOST_CALL arrayProtoFuncShift(TiExcState* exec, TiObject*, TiValue t
         result = jsUndefined();
     } else {
         result = thisObj->get(exec, 0);
-        for (unsigned k = 1; k < length; k++) {
-            if (TiValue obj = getProperty(exec, thisObj, k))
-                thisObj->put(exec, k - 1, obj);
-            else
-                thisObj->deleteProperty(exec, k - 1);
+        if (!isTiArray(&exec->globalData(), thisObj) || !asArray(thisObj)->shiftCount(1)) {
+            for (unsigned k = 1; k < length; k++) {
+                if (TiValue obj = getProperty(exec, thisObj, k))
+                    thisObj->put(exec, k - 1, obj);
+                else
+                    thisObj->deleteProperty(exec, k - 1);
+            }
+            thisObj->deleteProperty(exec, length - 1);
         }
-        thisObj->deleteProperty(exec, length - 1);
         putProperty(exec, thisObj, exec->propertyNames().length, jsNumber(exec, length - 1));
     }
     return result;
@@ -466,6 +487,10 @@ TiValue JSC_HOST_CALL arrayProtoFuncSlice(TiExcState* exec, TiObject*, TiValue t
     int n = 0;
     int b = static_cast<int>(begin);
     int e = static_cast<int>(end);
+    if (isTiArray(&exec->globalData(), thisObj) && asArray(thisObj)->length() == length && asArray(thisObj)->isDense()) {
+        if (b >= e || resObj->appendDenseValues(asArray(thisObj)->denseValues() + b, e - b))
+            return result;
+    }
     for (int k = b; k < e; k++, n++) {
         if (TiValue v = getProperty(exec, thisObj, k))
             resObj->put(exec, n, v);
@@ -554,13 +579,20 @@ TiValue JSC_HOST_CALL arrayProtoFuncSplice(TiExcState* exec, TiObject*, TiValue
     else
         deleteCount = length - begin;
 
+    unsigned additionalArgs = std::max<int>(args.size() - 2, 0);
+    if (isTiArray(&exec->globalData(), thisObj) && asArray(thisObj)->length() == length && asArray(thisObj)->isDense()) {
+        TiArray* array = asArray(thisObj);
+        if (resObj->appendDenseValues(array->denseValues() + begin, deleteCount)
+            && array->spliceDense(begin, deleteCount, additionalArgs ? args.begin() + 2 : 0, additionalArgs))
+            return result;
+    }
+
     for (unsigned k = 0; k < deleteCount; k++) {
         if (TiValue v = getProperty(exec, thisObj, k + begin))
             resObj->put(exec, k, v);
     }
     resObj->setLength(deleteCount);
 
-    unsigned additionalArgs = std::max<int>(args.size() - 2, 0);
     if (additionalArgs != deleteCount) {
         if (additionalArgs < deleteCount) {
             for (unsigned k = begin; k < length - deleteCount; ++k) {
@@ -594,7 +626,7 @@ TiValue JSC_HOST_CALL arrayProtoFuncUnShift(TiExcState* exec, TiObject*, TiValue
     // 15.4.4.13
     unsigned length = thisObj->get(exec, exec->propertyNames().length).toUInt32(exec);
     unsigned nrArgs = args.size();
-    if (nrArgs) {
+    if (nrArgs && (!isTiArray(&exec->globalData(), thisObj) || !asArray(thisObj)->unshiftCount(nrArgs))) {
         for (unsigned k = length; k > 0; --k) {
             if (TiValue v = getProperty(exec, thisObj, k - 1))
                 thisObj->put(exec, k + nrArgs - 1, v);
@@ -1037,6 +1069,15 @@ TiValue JSC_HOST_CALL arrayProtoFuncIndexOf(TiExcState* exec, TiObject*, TiValue
     }
 
     TiValue searchElement = args.at(0);
+    if (isTiArray(&exec->globalData(), thisObj) && asArray(thisObj)->length() == length && asArray(thisObj)->isDense()) {
+        TiValue* values = asArray(thisObj)->denseValues();
+        for (; index < length; ++index) {
+            if (TiValue::strictEqual(searchElement, values[index]))
+                return jsNumber(exec, index);
+        }
+        return jsNumber(exec, -1);
+    }
+
     for (; index < length; ++index) {
         TiValue e = getProperty(exec, thisObj, index);
         if (!e)
@@ -1068,6 +1109,15 @@ TiValue JSC_HOST_CALL arrayProtoFuncLastIndexOf(TiExcState* exec, TiObject*, TiV
         index = static_cast<int>(d);
 
     TiValue searchElement = args.at(0);
+    if (isTiArray(&exec->globalData(), thisObj) && asArray(thisObj)->length() == length && asArray(thisObj)->isDense()) {
+        TiValue* values = asArray(thisObj)->denseValues();
+        for (; index >= 0; --index) {
+            if (TiValue::strictEqual(searchElement, values[index]))
+                return jsNumber(exec, index);
+        }
+        return jsNumber(exec, -1);
+    }
+
     for (; index >= 0; --index) {
         TiValue e = getProperty(exec, thisObj, index);
         if (!e)
@@ -41,6 +41,7 @@
 #include "TiValue.h"
 #include "MarkStack.h"
 #include "Nodes.h"
+#include "Register.h"
 #include "Tracing.h"
 #include <algorithm>
 #include <limits.h>
@@ -177,6 +178,7 @@ Heap::Heap(TiGlobalData* globalData)
     
     memset(&primaryHeap, 0, sizeof(CollectorHeap));
     memset(&numberHeap, 0, sizeof(CollectorHeap));
+    rebuildBlockFilter();
 }
 
 Heap::~Heap()
@@ -199,6 +201,9 @@ void Heap::destroy()
     delete m_markListSet;
     m_markListSet = 0;
 
+    returnAllocationBuffer<PrimaryHeap>();
+    returnAllocationBuffer<NumberHeap>();
+
     sweep<PrimaryHeap>();
     // No need to sweep number heap, because the JSNumber destructor doesn't do anything.
 
@@ -320,6 +325,10 @@ NEVER_INLINE CollectorBlock* Heap::allocateBlock()
     }
     heap.blocks[heap.usedBlocks++] = block;
 
+    CollectorBlock** position = std::lower_bound(m_blockTable.begin(), m_blockTable.end(), block);
+    m_blockTable.insert(position - m_blockTable.begin(), block);
+    addToBlockFilter(block);
+
     return block;
 }
 
@@ -328,6 +337,10 @@ NEVER_INLINE void Heap::freeBlock(size_t block)
 {
     CollectorHeap& heap = heapType == PrimaryHeap ? primaryHeap : numberHeap;
 
+    CollectorBlock** position = std::lower_bound(m_blockTable.begin(), m_blockTable.end(), heap.blocks[block]);
+    ASSERT(position != m_blockTable.end() && *position == heap.blocks[block]);
+    m_blockTable.remove(position - m_blockTable.begin());
+
     freeBlock(heap.blocks[block]);
 
     // swap with the last block so we compact as we go
@@ -363,6 +376,15 @@ NEVER_INLINE void Heap::freeBlock(CollectorBlock* block)
 
 void Heap::freeBlocks(CollectorHeap* heap)
 {
+    HeapType heapType = heap == &primaryHeap ? PrimaryHeap : NumberHeap;
+    size_t remainingBlocks = 0;
+    for (size_t i = 0; i < m_blockTable.size(); ++i) {
+        if (m_blockTable[i]->type != heapType)
+            m_blockTable[remainingBlocks++] = m_blockTable[i];
+    }
+    m_blockTable.shrink(remainingBlocks);
+    rebuildBlockFilter();
+
     for (size_t i = 0; i < heap->usedBlocks; ++i)
         if (heap->blocks[i])
             freeBlock(heap->blocks[i]);
@@ -385,13 +407,38 @@ void Heap::recordExtraCost(size_t cost)
     // NOTE: we target the primaryHeap unconditionally as JSNumber doesn't modify cost 
 
     primaryHeap.extraCost += cost;
+
+    // Make the next allocation take the slow case, which decides whether all
+    // this extra cost calls for a collection.
+    if (primaryHeap.extraCost > ALLOCATIONS_PER_COLLECTION)
+        returnAllocationBuffer<PrimaryHeap>();
 }
 
-template <HeapType heapType> ALWAYS_INLINE void* Heap::heapAllocate(size_t s)
+template <HeapType heapType> void Heap::returnAllocationBuffer()
 {
     typedef typename HeapConstants<heapType>::Block Block;
     typedef typename HeapConstants<heapType>::Cell Cell;
 
+    CollectorHeap& heap = heapType == PrimaryHeap ? primaryHeap : numberHeap;
+    Block* block = reinterpret_cast<Block*>(heap.allocationBlock);
+    if (!block)
+        return;
+
+    // firstBlockWithPossibleSpace still points at or before the block: it was
+    // set to the block when the buffer was claimed, and blocks only move in
+    // sweep, which runs after the buffer has been returned.
+    block->freeList = reinterpret_cast<Cell*>(heap.nextFreeCell);
+    block->usedCells -= static_cast<uint32_t>(heap.freeCellsLeft);
+
+    heap.allocationBlock = 0;
+    heap.nextFreeCell = 0;
+    heap.freeCellsLeft = 0;
+}
+
+template <HeapType heapType> ALWAYS_INLINE void* Heap::heapAllocate(size_t s)
+{
+    typedef typename HeapConstants<heapType>::Cell Cell;
+
     CollectorHeap& heap = heapType == PrimaryHeap ? primaryHeap : numberHeap;
     ASSERT(TiLock::lockCount() > 0);
     ASSERT(TiLock::currentThreadIsHoldingLock());
@@ -408,9 +455,32 @@ template <HeapType heapType> ALWAYS_INLINE void* Heap::heapAllocate(size_t s)
     collect();
 #endif
 
+    if (LIKELY(heap.freeCellsLeft)) {
+        Cell* newCell = reinterpret_cast<Cell*>(heap.nextFreeCell);
+        // "next" field is a cell offset -- 0 means next cell, so a zeroed block is already initialized
+        heap.nextFreeCell = (newCell + 1) + newCell->u.freeCell.next;
+        --heap.freeCellsLeft;
+        ++heap.numLiveObjects;
+        return newCell;
+    }
+
+    return allocateSlowCase<heapType>();
+}
+
+template <HeapType heapType> NEVER_INLINE void* Heap::allocateSlowCase()
+{
+    typedef typename HeapConstants<heapType>::Block Block;
+    typedef typename HeapConstants<heapType>::Cell Cell;
+
+    CollectorHeap& heap = heapType == PrimaryHeap ? primaryHeap : numberHeap;
+
+    // The buffer is empty, so its block is full.
+    returnAllocationBuffer<heapType>();
+
     size_t numLiveObjects = heap.numLiveObjects;
     size_t usedBlocks = heap.usedBlocks;
     size_t i = heap.firstBlockWithPossibleSpace;
+    bool collected = false;
 
     // if we have a huge amount of extra cost, we'll try to collect even if we still have
     // free cells left.
@@ -455,6 +525,7 @@ collect:
             heap.operationInProgress = NoOperation;
 #endif
             bool foundGarbage = collect();
+            collected = true;
             numLiveObjects = heap.numLiveObjects;
             usedBlocks = heap.usedBlocks;
             i = heap.firstBlockWithPossibleSpace;
@@ -465,21 +536,48 @@ collect:
                 goto scan;
         }
 
+        ResourceLimits& resourceLimits = m_globalData->resourceLimits;
+        size_t heapSizeLimit = resourceLimits.heapSizeLimit();
+        if (UNLIKELY(heapSizeLimit) && (primaryHeap.usedBlocks + numberHeap.usedBlocks + 1) * BLOCK_SIZE > heapSizeLimit) {
+            // Growing would take the heap past its limit: collect first, even
+            // if a collection is not due, and report the limit only if that
+            // does not make room.
+            if (!collected && resourceLimits.shouldCollectAtHeapSizeLimit()) {
+#ifndef NDEBUG
+                heap.operationInProgress = NoOperation;
+#endif
+                bool foundGarbage = collect();
+                collected = true;
+                numLiveObjects = heap.numLiveObjects;
+                usedBlocks = heap.usedBlocks;
+                i = heap.firstBlockWithPossibleSpace;
+#ifndef NDEBUG
+                heap.operationInProgress = Allocation;
+#endif
+                if (foundGarbage)
+                    goto scan;
+            }
+            resourceLimits.heapSizeLimitExceeded();
+        } else if (UNLIKELY(heapSizeLimit))
+            resourceLimits.heapIsBelowHeapSizeLimit();
+
         // didn't find a block, and GC didn't reclaim anything, need to allocate a new block
         targetBlock = reinterpret_cast<Block*>(allocateBlock<heapType>());
         heap.firstBlockWithPossibleSpace = heap.usedBlocks - 1;
         targetBlockUsedCells = 0;
     }
 
-    // find a free spot in the block and detach it from the free list
-    Cell* newCell = targetBlock->freeList;
-
-    // "next" field is a cell offset -- 0 means next cell, so a zeroed block is already initialized
-    targetBlock->freeList = (newCell + 1) + newCell->u.freeCell.next;
-
-    targetBlock->usedCells = static_cast<uint32_t>(targetBlockUsedCells + 1);
+    // Claim the rest of the block's free list as the allocation buffer, and
+    // take the first cell from it.
+    size_t freeCells = HeapConstants<heapType>::cellsPerBlock - targetBlockUsedCells;
+    targetBlock->usedCells = static_cast<uint32_t>(HeapConstants<heapType>::cellsPerBlock);
     heap.numLiveObjects = numLiveObjects + 1;
 
+    Cell* newCell = targetBlock->freeList;
+    heap.allocationBlock = targetBlock;
+    heap.nextFreeCell = (newCell + 1) + newCell->u.freeCell.next;
+    heap.freeCellsLeft = freeCells - 1;
+
 #ifndef NDEBUG
     // FIXME: Consider doing this in NDEBUG builds too (see comment above).
     heap.operationInProgress = NoOperation;
@@ -746,6 +844,70 @@ void Heap::registerThread()
 // cell size needs to be a power of two for this to be valid
 #define IS_HALF_CELL_ALIGNED(p) (((intptr_t)(p) & (CELL_MASK >> 1)) == 0)
 
+inline size_t Heap::blockFilterIndex(CollectorBlock* block) const
+{
+    return (reinterpret_cast<uintptr_t>(block) / BLOCK_SIZE) & m_blockFilterMask;
+}
+
+inline void Heap::setBlockFilterBit(CollectorBlock* block)
+{
+    if (block < m_minBlock)
+        m_minBlock = block;
+    if (block > m_maxBlock)
+        m_maxBlock = block;
+    size_t index = blockFilterIndex(block);
+    m_blockFilter[index >> 5] |= 1u << (index & 0x1F);
+}
+
+void Heap::addToBlockFilter(CollectorBlock* block)
+{
+    // The filter at least doubles each time it is resized, so rebuilding it
+    // here costs a constant amount per block allocated.
+    if (m_blockTable.size() * blockFilterBitsPerBlock > m_blockFilter.size() * 32) {
+        rebuildBlockFilter();
+        return;
+    }
+    setBlockFilterBit(block);
+}
+
+void Heap::rebuildBlockFilter()
+{
+    size_t words = minBlockFilterWords;
+    while (words * 32 < m_blockTable.size() * blockFilterBitsPerBlock)
+        words *= 2;
+    m_blockFilter.fill(0, words);
+    m_blockFilterMask = words * 32 - 1;
+
+    m_minBlock = reinterpret_cast<CollectorBlock*>(BLOCK_MASK);
+    m_maxBlock = 0;
+    for (size_t i = 0; i < m_blockTable.size(); ++i)
+        setBlockFilterBit(m_blockTable[i]);
+}
+
+ALWAYS_INLINE bool Heap::isBlock(CollectorBlock* block) const
+{
+    if (block < m_minBlock || block > m_maxBlock)
+        return false;
+    size_t index = blockFilterIndex(block);
+    if (!(m_blockFilter[index >> 5] & (1u << (index & 0x1F))))
+        return false;
+    return std::binary_search(m_blockTable.begin(), m_blockTable.end(), block);
+}
+
+ALWAYS_INLINE void Heap::markCellIfLive(MarkStack& markStack, CollectorBlock* block, uintptr_t cellAddress)
+{
+    // Mark the the number heap, we can mark these Cells directly to avoid the virtual call cost
+    if (block->type == NumberHeap) {
+        Heap::markCell(reinterpret_cast<TiCell*>(cellAddress));
+        return;
+    }
+
+    if (reinterpret_cast<CollectorCell*>(cellAddress)->u.freeCell.zeroIfFree) {
+        markStack.append(reinterpret_cast<TiCell*>(cellAddress));
+        markStack.drain();
+    }
+}
+
 void Heap::markConservatively(MarkStack& markStack, void* start, void* end)
 {
     if (start > end) {
@@ -761,11 +923,6 @@ void Heap::markConservatively(MarkStack& markStack, void* start, void* end)
     char** p = static_cast<char**>(start);
     char** e = static_cast<char**>(end);
 
-    size_t usedPrimaryBlocks = primaryHeap.usedBlocks;
-    size_t usedNumberBlocks = numberHeap.usedBlocks;
-    CollectorBlock** primaryBlocks = primaryHeap.blocks;
-    CollectorBlock** numberBlocks = numberHeap.blocks;
-
     const size_t lastCellOffset = sizeof(CollectorCell) * (CELLS_PER_BLOCK - 1);
 
     while (p != e) {
@@ -775,30 +932,39 @@ void Heap::markConservatively(MarkStack& markStack, void* start, void* end)
             xAsBits &= CELL_ALIGN_MASK;
             uintptr_t offset = xAsBits & BLOCK_OFFSET_MASK;
             CollectorBlock* blockAddr = reinterpret_cast<CollectorBlock*>(xAsBits - offset);
-            // Mark the the number heap, we can mark these Cells directly to avoid the virtual call cost
-            for (size_t block = 0; block < usedNumberBlocks; block++) {
-                if ((numberBlocks[block] == blockAddr) & (offset <= lastCellOffset)) {
-                    Heap::markCell(reinterpret_cast<TiCell*>(xAsBits));
-                    goto endMarkLoop;
-                }
-            }
-          
-            // Mark the primary heap
-            for (size_t block = 0; block < usedPrimaryBlocks; block++) {
-                if ((primaryBlocks[block] == blockAddr) & (offset <= lastCellOffset)) {
-                    if (reinterpret_cast<CollectorCell*>(xAsBits)->u.freeCell.zeroIfFree) {
-                        markStack.append(reinterpret_cast<TiCell*>(xAsBits));
-                        markStack.drain();
-                    }
-                    break;
-                }
-            }
-        endMarkLoop:
-            ;
+            if (offset <= lastCellOffset && isBlock(blockAddr))
+                markCellIfLive(markStack, blockAddr, xAsBits);
         }
     }
 }
 
+// Unlike the machine stack, every register holds either an encoded TiValue
+// or a raw pointer stored by the call frame header or by an instruction, so
+// only a pointer to the start of a cell can keep that cell alive.
+void Heap::markRegisters(MarkStack& markStack, Register* start, Register* end)
+{
+    ASSERT(start <= end);
+
+    const size_t lastCellOffset = sizeof(CollectorCell) * (CELLS_PER_BLOCK - 1);
+
+    for (Register* r = start; r != end; ++r) {
+        TiValue value = r->jsValue();
+        void* candidate = value.isCell() ? static_cast<void*>(value.asCell()) : *reinterpret_cast<void* const*>(r);
+
+        uintptr_t cellAddress = reinterpret_cast<uintptr_t>(candidate);
+        if (!cellAddress || (cellAddress & (SMALL_CELL_SIZE - 1)))
+            continue;
+        uintptr_t offset = cellAddress & BLOCK_OFFSET_MASK;
+        CollectorBlock* block = reinterpret_cast<CollectorBlock*>(cellAddress - offset);
+        if (offset > lastCellOffset || !isBlock(block))
+            continue;
+        if (block->type == PrimaryHeap && (cellAddress & CELL_MASK))
+            continue;
+
+        markCellIfLive(markStack, block, cellAddress & CELL_ALIGN_MASK);
+    }
+}
+
 void NEVER_INLINE Heap::markCurrentThreadConservativelyInternal(MarkStack& markStack)
 {
     void* dummy;
@@ -1152,6 +1318,14 @@ bool Heap::collect()
         CRASH();
 
     JAVASCRIPTCORE_GC_BEGIN();
+
+    // Throw away cold function code before marking, so the constants it
+    // referenced can be reclaimed by this collection.
+    m_globalData->flushColdCode();
+
+    returnAllocationBuffer<PrimaryHeap>();
+    returnAllocationBuffer<NumberHeap>();
+
     primaryHeap.operationInProgress = Collection;
     numberHeap.operationInProgress = Collection;
 
@@ -1177,6 +1351,7 @@ bool Heap::collect()
     size_t originalLiveObjects = primaryHeap.numLiveObjects + numberHeap.numLiveObjects;
     size_t numLiveObjects = sweep<PrimaryHeap>();
     numLiveObjects += sweep<NumberHeap>();
+    rebuildBlockFilter();
 
     primaryHeap.operationInProgress = NoOperation;
     numberHeap.operationInProgress = NoOperation;
@@ -1200,6 +1375,7 @@ static void addToStatistics(Heap::Statistics& statistics, const CollectorHeap& h
             statistics.free += (HC::cellsPerBlock - heap.blocks[i]->usedCells) * HC::cellSize;
         }
     }
+    statistics.free += heap.freeCellsLeft * HC::cellSize;
 }
 
 Heap::Statistics Heap::statistics() const
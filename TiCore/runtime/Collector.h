@@ -36,6 +36,7 @@
 #include <wtf/Noncopyable.h>
 #include <wtf/OwnPtr.h>
 #include <wtf/Threading.h>
+#include <wtf/Vector.h>
 
 // This is supremely lame that we require pthreads to build on windows.
 #if ENABLE(JSC_MULTIPLE_THREADS)
@@ -52,6 +53,7 @@ namespace TI {
     class TiValue;
     class MarkedArgumentBuffer;
     class MarkStack;
+    class Register;
 
     enum OperationInProgress { NoOperation, Allocation, Collection };
     enum HeapType { PrimaryHeap, NumberHeap };
@@ -68,6 +70,14 @@ namespace TI {
         size_t numLiveObjectsAtLastCollect;
         size_t extraCost;
 
+        // The allocation buffer: the free list of one block, claimed whole so
+        // that allocating a cell only pops it. The block's usedCells counts
+        // the buffer's cells as used until it is returned; numLiveObjects
+        // counts only the cells handed out.
+        void* allocationBlock;
+        void* nextFreeCell;
+        size_t freeCellsLeft;
+
         OperationInProgress operationInProgress;
     };
 
@@ -112,6 +122,7 @@ namespace TI {
         static void markCell(TiCell*);
 
         void markConservatively(MarkStack&, void* start, void* end);
+        void markRegisters(MarkStack&, Register* start, Register* end);
 
         HashSet<MarkedArgumentBuffer*>& markListSet() { if (!m_markListSet) m_markListSet = new HashSet<MarkedArgumentBuffer*>; return *m_markListSet; }
 
@@ -124,6 +135,8 @@ namespace TI {
 
     private:
         template <HeapType heapType> void* heapAllocate(size_t);
+        template <HeapType heapType> NEVER_INLINE void* allocateSlowCase();
+        template <HeapType heapType> void returnAllocationBuffer();
         template <HeapType heapType> size_t sweep();
         static CollectorBlock* cellBlock(const TiCell*);
         static size_t cellOffset(const TiCell*);
@@ -137,6 +150,13 @@ namespace TI {
         NEVER_INLINE void freeBlock(CollectorBlock*);
         void freeBlocks(CollectorHeap*);
 
+        bool isBlock(CollectorBlock*) const;
+        size_t blockFilterIndex(CollectorBlock*) const;
+        void setBlockFilterBit(CollectorBlock*);
+        void addToBlockFilter(CollectorBlock*);
+        void rebuildBlockFilter();
+        void markCellIfLive(MarkStack&, CollectorBlock*, uintptr_t cellAddress);
+
         void recordExtraCost(size_t);
         void markProtectedObjects(MarkStack&);
         void markCurrentThreadConservatively(MarkStack&);
@@ -153,6 +173,23 @@ namespace TI {
 
         HashSet<MarkedArgumentBuffer*>* m_markListSet;
 
+        // The blocks of both heaps, sorted by address, so a possible pointer
+        // can be checked against the heap with a binary search.
+        Vector<CollectorBlock*> m_blockTable;
+
+        // Rules out most words before m_blockTable is searched: the range of
+        // block addresses, and one bit per block address modulo the filter
+        // size. The filter has at least blockFilterBitsPerBlock bits per block,
+        // a power of two, and is resized as the heap grows so that it stays
+        // sparse. Freed blocks keep their bits until the next collection
+        // rebuilds the filter.
+        static const size_t minBlockFilterWords = 32;
+        static const size_t blockFilterBitsPerBlock = 16;
+        CollectorBlock* m_minBlock;
+        CollectorBlock* m_maxBlock;
+        size_t m_blockFilterMask;
+        Vector<uint32_t> m_blockFilter;
+
 #if ENABLE(JSC_MULTIPLE_THREADS)
         void makeUsableFromMultipleThreads();
 
@@ -48,19 +48,41 @@ namespace TI {
 
 class InterruptedExecutionError : public TiObject {
 public:
-    InterruptedExecutionError(TiGlobalData* globalData)
+    InterruptedExecutionError(TiGlobalData* globalData, const char* message)
         : TiObject(globalData->interruptedExecutionErrorStructure)
+        , m_message(message)
     {
     }
 
     virtual bool isWatchdogException() const { return true; }
 
-    virtual UString toString(TiExcState*) const { return "Ti execution exceeded timeout."; }
+    virtual UString toString(TiExcState*) const { return m_message; }
+
+private:
+    const char* m_message;
 };
 
+static const char* interruptedExecutionMessage(ResourceLimits::Resource reason)
+{
+    switch (reason) {
+    case ResourceLimits::NoResource:
+        return "Ti execution was terminated.";
+    case ResourceLimits::ExecutionTime:
+        return "Ti execution exceeded timeout.";
+    case ResourceLimits::CPUTime:
+        return "Ti execution exceeded its CPU time limit.";
+    case ResourceLimits::HeapSize:
+        return "Ti execution exceeded its heap size limit.";
+    case ResourceLimits::ExecutableMemory:
+        return "Ti execution exceeded its executable memory limit.";
+    }
+    ASSERT_NOT_REACHED();
+    return "Ti execution was terminated.";
+}
+
 TiValue createInterruptedExecutionException(TiGlobalData* globalData)
 {
-    return new (globalData) InterruptedExecutionError(globalData);
+    return new (globalData) InterruptedExecutionError(globalData, interruptedExecutionMessage(globalData->resourceLimits.terminationReason()));
 }
 
 static TiValue createError(TiExcState* exec, ErrorType e, const char* msg)
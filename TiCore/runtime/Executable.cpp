@@ -63,6 +63,8 @@ ProgramExecutable::~ProgramExecutable()
 
 FunctionExecutable::~FunctionExecutable()
 {
+    if (m_codeBlock)
+        m_globalData->functionExecutablesWithCode.remove(this);
     delete m_codeBlock;
 }
 
@@ -137,6 +139,7 @@ void FunctionExecutable::compile(TiExcState*, ScopeChainNode* scopeChainNode)
     m_numParameters = m_codeBlock->m_numParameters;
     ASSERT(m_numParameters);
     m_numVariables = m_codeBlock->m_numVars;
+    m_globalData->functionExecutablesWithCode.add(this);
 
     body->destroyData();
 }
@@ -238,14 +241,46 @@ ExceptionInfo* EvalExecutable::reparseExceptionInfo(TiGlobalData* globalData, Sc
 
 void FunctionExecutable::recompile(TiExcState*)
 {
+    discardCode();
+}
+
+void FunctionExecutable::discardCode()
+{
+    if (m_codeBlock)
+        m_globalData->functionExecutablesWithCode.remove(this);
     delete m_codeBlock;
     m_codeBlock = 0;
+    m_codeAge = 0;
     m_numParameters = NUM_PARAMETERS_NOT_COMPILED;
 #if ENABLE(JIT)
     m_jitCode = JITCode();
 #endif
 }
 
+CodeMemoryUsage EvalExecutable::memoryUsage()
+{
+    CodeMemoryUsage usage;
+    if (m_evalCodeBlock)
+        m_evalCodeBlock->addMemoryUsage(usage);
+#if ENABLE(JIT)
+    if (!!m_jitCode)
+        usage.jitCodeBytes += m_jitCode.size();
+#endif
+    return usage;
+}
+
+CodeMemoryUsage FunctionExecutable::memoryUsage()
+{
+    CodeMemoryUsage usage;
+    if (m_codeBlock)
+        m_codeBlock->addMemoryUsage(usage);
+#if ENABLE(JIT)
+    if (!!m_jitCode)
+        usage.jitCodeBytes += m_jitCode.size();
+#endif
+    return usage;
+}
+
 PassRefPtr<FunctionExecutable> FunctionExecutable::fromGlobalCode(const Identifier& functionName, TiExcState* exec, Debugger* debugger, const SourceCode& source, int* errLine, UString* errMsg)
 {
     RefPtr<ProgramNode> program = exec->globalData().parser->parse<ProgramNode>(&exec->globalData(), debugger, exec, source, errLine, errMsg);
@@ -48,6 +48,28 @@ namespace TI {
 
     struct ExceptionInfo;
 
+    // Memory held by the compiled form of an executable: the instruction
+    // stream, everything else its CodeBlock owns, and JIT generated code.
+    struct CodeMemoryUsage {
+        CodeMemoryUsage()
+            : bytecodeBytes(0)
+            , metadataBytes(0)
+            , jitCodeBytes(0)
+        {
+        }
+
+        void add(const CodeMemoryUsage& other)
+        {
+            bytecodeBytes += other.bytecodeBytes;
+            metadataBytes += other.metadataBytes;
+            jitCodeBytes += other.jitCodeBytes;
+        }
+
+        size_t bytecodeBytes;
+        size_t metadataBytes;
+        size_t jitCodeBytes;
+    };
+
     class ExecutableBase : public RefCounted<ExecutableBase> {
         friend class JIT;
 
@@ -143,6 +165,7 @@ namespace TI {
         int lineNo() const { return m_firstLine; }
         int lastLine() const { return m_lastLine; }
 
+        CodeFeatures features() const { return m_features; }
         bool usesEval() const { return m_features & EvalFeature; }
         bool usesArguments() const { return m_features & ArgumentsFeature; }
         bool needsActivation() const { return m_features & (EvalFeature | ClosureFeature | WithFeature | CatchFeature); }
@@ -182,6 +205,8 @@ namespace TI {
         ExceptionInfo* reparseExceptionInfo(TiGlobalData*, ScopeChainNode*, CodeBlock*);
         static PassRefPtr<EvalExecutable> create(TiExcState* exec, const SourceCode& source) { return adoptRef(new EvalExecutable(exec, source)); }
 
+        CodeMemoryUsage memoryUsage();
+
     private:
         EvalExecutable(TiExcState* exec, const SourceCode& source)
             : ScriptExecutable(exec, source)
@@ -290,21 +315,44 @@ namespace TI {
         }
 
         const Identifier& name() { return m_name; }
+        FunctionParameters& parameters() { return *m_parameters; }
         size_t parameterCount() const { return m_parameters->size(); }
+        bool forceUsesArguments() const { return m_forceUsesArguments; }
         size_t variableCount() const { return m_numVariables; }
         UString paramString() const;
 
+        // Gives a function restored from a snapshot the features and variable
+        // count of its code, so its activations can be made before it is compiled.
+        void restoreLayout(CodeFeatures features, size_t numVariables)
+        {
+            ASSERT(!m_codeBlock);
+            m_features = features;
+            m_numVariables = numVariables;
+        }
+
         void recompile(TiExcState*);
         ExceptionInfo* reparseExceptionInfo(TiGlobalData*, ScopeChainNode*, CodeBlock*);
         void markAggregate(MarkStack& markStack);
         static PassRefPtr<FunctionExecutable> fromGlobalCode(const Identifier&, TiExcState*, Debugger*, const SourceCode&, int* errLine = 0, UString* errMsg = 0);
 
+        // Code flushing support. The age counts the garbage collections since the
+        // function was last called; discarding the code makes the next call
+        // regenerate it. Calls reset the age on entry, except calls the JIT has
+        // linked, which reset it only when they are linked.
+        void resetCodeAge() { m_codeAge = 0; }
+        unsigned incrementCodeAge() { return ++m_codeAge; }
+        void discardCode();
+
+        CodeMemoryUsage memoryUsage();
+
     private:
         FunctionExecutable(TiGlobalData* globalData, const Identifier& name, const SourceCode& source, bool forceUsesArguments, FunctionParameters* parameters, int firstLine, int lastLine)
             : ScriptExecutable(globalData, source)
+            , m_globalData(globalData)
             , m_forceUsesArguments(forceUsesArguments)
             , m_parameters(parameters)
             , m_codeBlock(0)
+            , m_codeAge(0)
             , m_name(name)
             , m_numVariables(0)
         {
@@ -314,9 +362,11 @@ namespace TI {
 
         FunctionExecutable(TiExcState* exec, const Identifier& name, const SourceCode& source, bool forceUsesArguments, FunctionParameters* parameters, int firstLine, int lastLine)
             : ScriptExecutable(exec, source)
+            , m_globalData(&exec->globalData())
             , m_forceUsesArguments(forceUsesArguments)
             , m_parameters(parameters)
             , m_codeBlock(0)
+            , m_codeAge(0)
             , m_name(name)
             , m_numVariables(0)
         {
@@ -326,9 +376,11 @@ namespace TI {
 
         void compile(TiExcState*, ScopeChainNode*);
 
+        TiGlobalData* m_globalData;
         bool m_forceUsesArguments;
         RefPtr<FunctionParameters> m_parameters;
         CodeBlock* m_codeBlock;
+        unsigned m_codeAge;
         Identifier m_name;
         size_t m_numVariables;
 
@@ -91,14 +91,26 @@ TiObject* constructFunction(TiExcState* exec, const ArgList& args, const Identif
         program += ") { " + args.at(args.size() - 1).toString(exec) + "\n})";
     }
 
-    int errLine;
-    UString errMsg;
-    SourceCode source = makeSource(program, sourceURL, lineNumber);
-    RefPtr<FunctionExecutable> function = FunctionExecutable::fromGlobalCode(functionName, exec, exec->dynamicGlobalObject()->debugger(), source, &errLine, &errMsg);
-    if (!function)
-        return throwError(exec, SyntaxError, errMsg, errLine, source.provider()->asID(), source.provider()->url());
-
     TiGlobalObject* globalObject = exec->lexicalGlobalObject();
+    Debugger* debugger = exec->dynamicGlobalObject()->debugger();
+
+    // Functions built from the same program text with the default name and
+    // source position are indistinguishable, so they can share an executable
+    // and its code. A debugger needs to see every source that is parsed.
+    bool isCacheable = !debugger && !globalObject->debugger() && sourceURL.isNull() && lineNumber == 1 && functionName.ustring() == "anonymous";
+
+    RefPtr<FunctionExecutable> function = isCacheable ? exec->globalData().evalCodeCache.getFunction(program, globalObject) : PassRefPtr<FunctionExecutable>();
+    if (!function) {
+        int errLine;
+        UString errMsg;
+        SourceCode source = makeSource(program, sourceURL, lineNumber);
+        function = FunctionExecutable::fromGlobalCode(functionName, exec, debugger, source, &errLine, &errMsg);
+        if (!function)
+            return throwError(exec, SyntaxError, errMsg, errLine, source.provider()->asID(), source.provider()->url());
+        if (isCacheable)
+            exec->globalData().evalCodeCache.addFunction(program, globalObject, function);
+    }
+
     ScopeChain scopeChain(globalObject, globalObject->globalData(), globalObject, exec->globalThisValue());
     return new (exec) TiFunction(exec, function, scopeChain.node());
 }
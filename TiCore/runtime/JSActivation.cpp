@@ -51,6 +51,18 @@ JSActivation::JSActivation(CallFrame* callFrame, NonNullPassRefPtr<FunctionExecu
 {
 }
 
+JSActivation::JSActivation(TiGlobalData* globalData, NonNullPassRefPtr<FunctionExecutable> functionExecutable, SharedSymbolTable* symbolTable)
+    : Base(globalData->activationStructure, new JSActivationData(functionExecutable, symbolTable, 0))
+{
+    size_t registerOffset = d()->functionExecutable->parameterCount() + RegisterFile::CallFrameHeaderSize;
+    size_t registerArraySize = registerOffset + d()->functionExecutable->variableCount();
+
+    Register* registerArray = new Register[registerArraySize];
+    for (size_t i = 0; i < registerArraySize; ++i)
+        registerArray[i] = jsUndefined();
+    setRegisters(registerArray + registerOffset, registerArray);
+}
+
 JSActivation::~JSActivation()
 {
     delete d();
@@ -51,6 +51,9 @@ namespace TI {
         typedef JSVariableObject Base;
     public:
         JSActivation(CallFrame*, NonNullPassRefPtr<FunctionExecutable>);
+        // A torn off activation, with all its variables undefined, for a function
+        // that is not running. The symbol table gives the variables' registers.
+        JSActivation(TiGlobalData*, NonNullPassRefPtr<FunctionExecutable>, SharedSymbolTable*);
         virtual ~JSActivation();
 
         virtual void markChildren(MarkStack&);
@@ -69,6 +72,8 @@ namespace TI {
         virtual TiObject* toThisObject(TiExcState*) const;
 
         void copyRegisters(Arguments* arguments);
+
+        FunctionExecutable* functionExecutable() const { return d()->functionExecutable.get(); }
         
         virtual const ClassInfo* classInfo() const { return &info; }
         static const ClassInfo info;
@@ -88,6 +93,12 @@ namespace TI {
                 // doesn't know about SharedSymbolTable
                 functionExecutable->generatedBytecode().sharedSymbolTable()->ref();
             }
+            JSActivationData(NonNullPassRefPtr<FunctionExecutable> _functionExecutable, SharedSymbolTable* symbolTable, Register* registers)
+                : JSVariableObjectData(symbolTable, registers)
+                , functionExecutable(_functionExecutable)
+            {
+                symbolTable->ref();
+            }
             ~JSActivationData()
             {
                 static_cast<SharedSymbolTable*>(symbolTable)->deref();
@@ -876,4 +876,12 @@ TiValue JSC_HOST_CALL JSONProtoFuncStringify(TiExcState* exec, TiObject*, TiValu
     return Stringifier(exec, replacer, space).stringify(value);
 }
 
+UString JSONStringify(TiExcState* exec, TiValue value, unsigned indent)
+{
+    TiValue result = Stringifier(exec, jsNull(), jsNumber(exec, indent)).stringify(value);
+    if (result.isUndefinedOrNull())
+        return UString();
+    return result.getString();
+}
+
 } // namespace TI
@@ -64,6 +64,9 @@ namespace TI {
         static const ClassInfo info;
     };
 
+    // Returns the JSON text for value, or the null string if value has none.
+    UString JSONStringify(TiExcState*, TiValue, unsigned indent);
+
 } // namespace TI
 
 #endif // JSONObject_h
@@ -106,6 +106,15 @@ PassRefPtr<RegExp> RegExp::create(TiGlobalData* globalData, const UString& patte
     return adoptRef(new RegExp(globalData, pattern, flags));
 }
 
+size_t RegExp::codeSize() const
+{
+#if ENABLE(YARR_JIT)
+    return m_regExpJITCode.size();
+#else
+    return 0;
+#endif
+}
+
 #if ENABLE(YARR)
 
 void RegExp::compile(TiGlobalData* globalData)
@@ -133,7 +142,7 @@ int RegExp::match(const UString& s, int startOffset, Vector<int, 32>* ovector)
 #else
     if (m_regExpBytecode) {
 #endif
-        int offsetVectorSize = (m_numSubpatterns + 1) * 3; // FIXME: should be 2 - but adding temporary fallback to pcre.
+        int offsetVectorSize = (m_numSubpatterns + 1) * 2;
         int* offsetVector;
         Vector<int, 32> nonReturnedOvector;
         if (ovector) {
@@ -150,7 +159,7 @@ int RegExp::match(const UString& s, int startOffset, Vector<int, 32>* ovector)
 
 
 #if ENABLE(YARR_JIT)
-        int result = Yarr::executeRegex(m_regExpJITCode, s.data(), startOffset, s.size(), offsetVector, offsetVectorSize);
+        int result = Yarr::executeRegex(m_regExpJITCode, s.data(), startOffset, s.size(), offsetVector);
 #else
         int result = Yarr::interpretRegex(m_regExpBytecode.get(), s.data(), startOffset, s.size(), offsetVector);
 #endif
@@ -64,6 +64,9 @@ namespace TI {
         int match(const UString&, int startOffset, Vector<int, 32>* ovector = 0);
         unsigned numSubpatterns() const { return m_numSubpatterns; }
 
+        // The size of the generated code, when the pattern was compiled to machine code.
+        size_t codeSize() const;
+
     private:
         RegExp(TiGlobalData* globalData, const UString& pattern);
         RegExp(TiGlobalData* globalData, const UString& pattern, const UString& flags);
@@ -0,0 +1,196 @@
+/**
+ * Appcelerator Titanium License
+ * This source code and all modifications done by Appcelerator
+ * are licensed under the Apache Public License (version 2) and
+ * are Copyright (c) 2009 by Appcelerator, Inc.
+ */
+
+/*
+ * Copyright (C) 2009 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1.  Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ * 2.  Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ * 3.  Neither the name of Apple Computer, Inc. ("Apple") nor the names of
+ *     its contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE AND ITS CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL APPLE OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "RegExpCache.h"
+
+#include "RegExp.h"
+
+namespace TI {
+
+// Scripts tend to use a few dozen distinct patterns, each a few hundred bytes
+// once compiled.
+static const size_t defaultCapacity = 256 * 1024;
+
+struct RegExpCache::Entry : FastAllocBase {
+    Entry(PassRefPtr<RegExp> regExp)
+        : regExp(regExp)
+        , cost(0)
+        , previous(0)
+        , next(0)
+        , nextWithSamePattern(0)
+    {
+    }
+
+    RefPtr<RegExp> regExp;
+    size_t cost;
+
+    Entry* previous;
+    Entry* next;
+    Entry* nextWithSamePattern;
+};
+
+RegExpCache::RegExpCache(TiGlobalData* globalData)
+    : m_globalData(globalData)
+    , m_head(0)
+    , m_tail(0)
+    , m_capacity(defaultCapacity)
+    , m_size(0)
+    , m_hits(0)
+    , m_misses(0)
+    , m_evictions(0)
+{
+}
+
+RegExpCache::~RegExpCache()
+{
+    clear();
+}
+
+PassRefPtr<RegExp> RegExpCache::lookupOrCreate(const UString& pattern)
+{
+    return lookupOrCreate(pattern, UString());
+}
+
+PassRefPtr<RegExp> RegExpCache::lookupOrCreate(const UString& pattern, const UString& flags)
+{
+    for (Entry* entry = m_entries.get(pattern.rep()); entry; entry = entry->nextWithSamePattern) {
+        if (entry->regExp->flags() == flags) {
+            ++m_hits;
+            moveToHead(entry);
+            return entry->regExp;
+        }
+    }
+    ++m_misses;
+
+    RefPtr<RegExp> regExp = flags.isNull() ? RegExp::create(m_globalData, pattern) : RegExp::create(m_globalData, pattern, flags);
+    add(regExp);
+    return regExp.release();
+}
+
+void RegExpCache::clear()
+{
+    while (m_head)
+        remove(m_head);
+}
+
+void RegExpCache::setCapacity(size_t capacity)
+{
+    m_capacity = capacity;
+    evictToCapacity();
+}
+
+void RegExpCache::add(PassRefPtr<RegExp> prpRegExp)
+{
+    RefPtr<RegExp> regExp = prpRegExp;
+    size_t cost = sizeof(Entry) + sizeof(RegExp) + (regExp->pattern().size() + regExp->flags().size()) * sizeof(UChar) + regExp->codeSize();
+    if (cost > m_capacity)
+        return;
+
+    Entry* entry = new Entry(regExp);
+    entry->cost = cost;
+
+    pair<EntryMap::iterator, bool> result = m_entries.add(regExp->pattern().rep(), entry);
+    if (!result.second) {
+        entry->nextWithSamePattern = result.first->second;
+        result.first->second = entry;
+    }
+
+    entry->next = m_head;
+    if (m_head)
+        m_head->previous = entry;
+    else
+        m_tail = entry;
+    m_head = entry;
+
+    m_size += entry->cost;
+    evictToCapacity();
+}
+
+void RegExpCache::remove(Entry* entry)
+{
+    EntryMap::iterator it = m_entries.find(entry->regExp->pattern().rep());
+    ASSERT(it != m_entries.end());
+    if (it->second == entry) {
+        if (entry->nextWithSamePattern)
+            it->second = entry->nextWithSamePattern;
+        else
+            m_entries.remove(it);
+    } else {
+        Entry* previous = it->second;
+        while (previous->nextWithSamePattern != entry)
+            previous = previous->nextWithSamePattern;
+        previous->nextWithSamePattern = entry->nextWithSamePattern;
+    }
+
+    if (entry->previous)
+        entry->previous->next = entry->next;
+    else
+        m_head = entry->next;
+    if (entry->next)
+        entry->next->previous = entry->previous;
+    else
+        m_tail = entry->previous;
+
+    m_size -= entry->cost;
+    delete entry;
+}
+
+void RegExpCache::moveToHead(Entry* entry)
+{
+    if (entry == m_head)
+        return;
+
+    entry->previous->next = entry->next;
+    if (entry->next)
+        entry->next->previous = entry->previous;
+    else
+        m_tail = entry->previous;
+
+    entry->previous = 0;
+    entry->next = m_head;
+    m_head->previous = entry;
+    m_head = entry;
+}
+
+void RegExpCache::evictToCapacity()
+{
+    while (m_size > m_capacity) {
+        ++m_evictions;
+        remove(m_tail);
+    }
+}
+
+} // namespace TI
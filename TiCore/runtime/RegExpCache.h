@@ -0,0 +1,101 @@
+/**
+ * Appcelerator Titanium License
+ * This source code and all modifications done by Appcelerator
+ * are licensed under the Apache Public License (version 2) and
+ * are Copyright (c) 2009 by Appcelerator, Inc.
+ */
+
+/*
+ * Copyright (C) 2009 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1.  Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ * 2.  Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ * 3.  Neither the name of Apple Computer, Inc. ("Apple") nor the names of
+ *     its contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE AND ITS CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL APPLE OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RegExpCache_h
+#define RegExpCache_h
+
+#include "UString.h"
+#include <wtf/HashMap.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/RefPtr.h>
+
+namespace TI {
+
+    class RegExp;
+    class TiGlobalData;
+
+    // Compiled regular expressions, shared by every RegExp object, literal and
+    // string function in a TiGlobalData that uses the same pattern and flags.
+    // A RegExp holds no per-use state, so sharing one is safe. Entries are
+    // evicted least recently used first once the memory they hold exceeds the
+    // cache's capacity.
+    class RegExpCache : public Noncopyable {
+    public:
+        RegExpCache(TiGlobalData*);
+        ~RegExpCache();
+
+        PassRefPtr<RegExp> lookupOrCreate(const UString& pattern);
+        PassRefPtr<RegExp> lookupOrCreate(const UString& pattern, const UString& flags);
+
+        void clear();
+
+        size_t capacity() const { return m_capacity; }
+        void setCapacity(size_t);
+        size_t size() const { return m_size; }
+        bool isEmpty() const { return !m_size; }
+
+        unsigned hits() const { return m_hits; }
+        unsigned misses() const { return m_misses; }
+        unsigned evictions() const { return m_evictions; }
+
+    private:
+        struct Entry;
+
+        void add(PassRefPtr<RegExp>);
+        void remove(Entry*);
+        void moveToHead(Entry*);
+        void evictToCapacity();
+
+        TiGlobalData* m_globalData;
+
+        typedef HashMap<RefPtr<UString::Rep>, Entry*> EntryMap;
+        EntryMap m_entries;
+
+        // Least recently used entries are at the tail of the list.
+        Entry* m_head;
+        Entry* m_tail;
+
+        size_t m_capacity;
+        size_t m_size;
+
+        unsigned m_hits;
+        unsigned m_misses;
+        unsigned m_evictions;
+    };
+
+} // namespace TI
+
+#endif // RegExpCache_h
@@ -76,6 +76,7 @@ namespace TI {
         static const ClassInfo info;
 
         void performMatch(RegExp*, const UString&, int startOffset, int& position, int& length, int** ovector = 0);
+        void setLastMatch(RegExp*, const UString&, const Vector<int, 32>& ovector);
         TiObject* arrayOfMatches(TiExcState*) const;
 
         void setInput(const UString&);
@@ -135,6 +136,19 @@ namespace TI {
         }
     }
 
+    // Records a match made by calling RegExp::match directly as though it had been made
+    // through performMatch, for callers whose intermediate matches cannot be observed.
+    inline void RegExpConstructor::setLastMatch(RegExp* r, const UString& s, const Vector<int, 32>& ovector)
+    {
+        ASSERT(!ovector.isEmpty());
+
+        d->tempOvector() = ovector;
+        d->input = s;
+        d->lastInput = s;
+        d->changeLastOvector();
+        d->lastNumSubPatterns = r->numSubpatterns();
+    }
+
 } // namespace TI
 
 #endif // RegExpConstructor_h
@@ -94,7 +94,7 @@ TiValue JSC_HOST_CALL regExpProtoFuncCompile(TiExcState* exec, TiObject*, TiValu
     } else {
         UString pattern = args.isEmpty() ? UString("") : arg0.toString(exec);
         UString flags = arg1.isUndefined() ? UString("") : arg1.toString(exec);
-        regExp = RegExp::create(&exec->globalData(), pattern, flags);
+        regExp = exec->globalData().regExpCache.lookupOrCreate(pattern, flags);
     }
 
     if (!regExp->isValid())
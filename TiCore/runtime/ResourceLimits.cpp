@@ -0,0 +1,424 @@
+/**
+ * Appcelerator Titanium License
+ * This source code and all modifications done by Appcelerator
+ * are licensed under the Apache Public License (version 2) and
+ * are Copyright (c) 2009 by Appcelerator, Inc.
+ */
+
+/*
+ * Copyright (C) 2009 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1.  Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ * 2.  Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ * 3.  Neither the name of Apple Computer, Inc. ("Apple") nor the names of
+ *     its contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE AND ITS CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL APPLE OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ResourceLimits.h"
+
+#include "TiGlobalData.h"
+#include <limits>
+#include <wtf/CurrentTime.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+#if PLATFORM(DARWIN)
+#include <mach/mach.h>
+#elif PLATFORM(WIN_OS)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace TI {
+
+#if PLATFORM(DARWIN) || PLATFORM(WIN_OS) || (defined(_POSIX_THREAD_CPUTIME) && _POSIX_THREAD_CPUTIME >= 0)
+#define HAVE_THREAD_CPU_TIME 1
+#endif
+
+// Returns a handle through which threadCPUTime() can read, from any thread,
+// the CPU time of the calling thread, or 0 if there is no way to do that.
+static intptr_t currentThreadClock()
+{
+#if PLATFORM(DARWIN)
+    return mach_thread_self();
+#elif PLATFORM(WIN_OS)
+    HANDLE thread;
+    if (!DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &thread, 0, FALSE, DUPLICATE_SAME_ACCESS))
+        return 0;
+    return reinterpret_cast<intptr_t>(thread);
+#elif defined(HAVE_THREAD_CPU_TIME)
+    clockid_t clock;
+    if (pthread_getcpuclockid(pthread_self(), &clock))
+        return 0;
+    return clock;
+#else
+    return 0;
+#endif
+}
+
+static void releaseThreadClock(intptr_t clock)
+{
+#if PLATFORM(DARWIN)
+    mach_port_deallocate(mach_task_self(), static_cast<mach_port_t>(clock));
+#elif PLATFORM(WIN_OS)
+    CloseHandle(reinterpret_cast<HANDLE>(clock));
+#else
+    UNUSED_PARAM(clock);
+#endif
+}
+
+// Returns the CPU time, in seconds, used by the thread behind clock. Falls
+// back to wall clock time when that can not be read, which overestimates CPU
+// time and so can only stop a script early.
+static double threadCPUTime(intptr_t clock)
+{
+    if (!clock)
+        return currentTime();
+
+#if PLATFORM(DARWIN)
+    mach_msg_type_number_t infoCount = THREAD_BASIC_INFO_COUNT;
+    thread_basic_info_data_t info;
+    if (thread_info(static_cast<mach_port_t>(clock), THREAD_BASIC_INFO, reinterpret_cast<thread_info_t>(&info), &infoCount) != KERN_SUCCESS)
+        return currentTime();
+    return info.user_time.seconds + info.system_time.seconds + (info.user_time.microseconds + info.system_time.microseconds) / 1E6;
+#elif PLATFORM(WIN_OS)
+    union {
+        FILETIME fileTime;
+        unsigned long long fileTimeAsLong;
+    } userTime, kernelTime;
+    FILETIME creationTime, exitTime;
+    if (!GetThreadTimes(reinterpret_cast<HANDLE>(clock), &creationTime, &exitTime, &kernelTime.fileTime, &userTime.fileTime))
+        return currentTime();
+    return (userTime.fileTimeAsLong + kernelTime.fileTimeAsLong) / 1E7;
+#elif defined(HAVE_THREAD_CPU_TIME)
+    timespec time;
+    if (clock_gettime(static_cast<clockid_t>(clock), &time))
+        return currentTime();
+    return time.tv_sec + time.tv_nsec / 1E9;
+#else
+    return currentTime();
+#endif
+}
+
+static const double noDeadline = numeric_limits<double>::infinity();
+
+// One thread, shared by every TiGlobalData with a time limit, that sleeps
+// until the earliest deadline among the scripts it is watching and requests
+// termination of those whose time has run out.
+class Watchdog : public Noncopyable {
+public:
+    static Watchdog& shared()
+    {
+        AtomicallyInitializedStatic(Watchdog&, watchdog = *new Watchdog);
+        return watchdog;
+    }
+
+    Watchdog();
+
+    Mutex& lock() { return m_lock; }
+
+    // These must be called with the lock held.
+    void add(ResourceLimits*);
+    void remove(ResourceLimits*);
+
+private:
+
+    static void* threadEntryPoint(void*);
+    void run();
+
+    Mutex m_lock;
+    ThreadCondition m_condition;
+    Vector<ResourceLimits*> m_watched;
+    bool m_threadStarted;
+};
+
+Watchdog::Watchdog()
+    : m_threadStarted(false)
+{
+}
+
+void Watchdog::add(ResourceLimits* limits)
+{
+    ASSERT(!limits->m_armed);
+    limits->m_armed = true;
+    m_watched.append(limits);
+
+    if (!m_threadStarted) {
+        detachThread(createThread(threadEntryPoint, this, "TiCore: Watchdog"));
+        m_threadStarted = true;
+    }
+    m_condition.signal();
+}
+
+void Watchdog::remove(ResourceLimits* limits)
+{
+    if (!limits->m_armed)
+        return;
+    limits->m_armed = false;
+    for (size_t i = 0; i < m_watched.size(); ++i) {
+        if (m_watched[i] == limits) {
+            m_watched.remove(i);
+            return;
+        }
+    }
+    ASSERT_NOT_REACHED();
+}
+
+void* Watchdog::threadEntryPoint(void* watchdog)
+{
+    static_cast<Watchdog*>(watchdog)->run();
+    return 0;
+}
+
+void Watchdog::run()
+{
+    MutexLocker locker(m_lock);
+    while (true) {
+        double now = currentTime();
+        double wakeTime = noDeadline;
+
+        for (size_t i = 0; i < m_watched.size(); ) {
+            ResourceLimits* limits = m_watched[i];
+            ResourceLimits::Resource exceeded = ResourceLimits::NoResource;
+
+            if (now >= limits->m_deadline)
+                exceeded = ResourceLimits::ExecutionTime;
+            else if (now >= limits->m_nextCPUTimeCheck) {
+                double used = threadCPUTime(limits->m_threadClock) - limits->m_cpuTimeAtEntry;
+                if (used >= limits->m_cpuTimeLimit)
+                    exceeded = ResourceLimits::CPUTime;
+                else {
+                    // A thread can not use CPU time faster than the wall clock
+                    // advances, so there is no need to look again before then.
+                    limits->m_nextCPUTimeCheck = now + limits->m_cpuTimeLimit - used;
+                }
+            }
+
+            if (exceeded) {
+                limits->m_exceeded = exceeded;
+                limits->m_armed = false;
+                m_watched.remove(i);
+                limits->m_globalData->terminationRequested = 1;
+                continue;
+            }
+
+            wakeTime = min(wakeTime, min(limits->m_deadline, limits->m_nextCPUTimeCheck));
+            ++i;
+        }
+
+        m_condition.timedWait(m_lock, wakeTime);
+    }
+}
+
+ResourceLimits::ResourceLimits(TiGlobalData* globalData)
+    : m_globalData(globalData)
+    , m_executionTimeLimit(0)
+    , m_cpuTimeLimit(0)
+    , m_heapSizeLimit(0)
+    , m_executableMemoryLimit(0)
+    , m_heapSizeLimitReported(false)
+    , m_collectedAtHeapSizeLimit(false)
+    , m_executableMemoryLimitReported(false)
+    , m_memoryLimitExceeded(NoResource)
+    , m_terminationReason(NoResource)
+    , m_inScript(false)
+    , m_watching(false)
+    , m_armed(false)
+    , m_deadline(noDeadline)
+    , m_cpuTimeAtEntry(0)
+    , m_nextCPUTimeCheck(noDeadline)
+    , m_threadClock(0)
+    , m_exceeded(NoResource)
+{
+}
+
+ResourceLimits::~ResourceLimits()
+{
+    // A TiGlobalData can not be destroyed while it is running script.
+    ASSERT(!m_watching);
+}
+
+void ResourceLimits::setLimits(double executionTime, double cpuTime, size_t heapSize, size_t executableMemory)
+{
+    m_executionTimeLimit = executionTime;
+    m_cpuTimeLimit = cpuTime;
+    m_heapSizeLimit = heapSize;
+    m_executableMemoryLimit = executableMemory;
+
+    m_heapSizeLimitReported = false;
+    m_collectedAtHeapSizeLimit = false;
+    m_executableMemoryLimitReported = false;
+
+#if ENABLE(ASSEMBLER)
+    m_globalData->executableAllocator.setMemoryLimit(executableMemory);
+#endif
+}
+
+void ResourceLimits::arm()
+{
+    ASSERT(!m_watching);
+    m_watching = true;
+
+    Watchdog& watchdog = Watchdog::shared();
+    MutexLocker locker(watchdog.lock());
+
+    double now = currentTime();
+    m_deadline = m_executionTimeLimit ? now + m_executionTimeLimit : noDeadline;
+    if (m_cpuTimeLimit) {
+        m_threadClock = currentThreadClock();
+        m_cpuTimeAtEntry = threadCPUTime(m_threadClock);
+        m_nextCPUTimeCheck = now + m_cpuTimeLimit;
+    } else
+        m_nextCPUTimeCheck = noDeadline;
+    m_exceeded = NoResource;
+
+    watchdog.add(this);
+}
+
+void ResourceLimits::disarm()
+{
+    ASSERT(m_watching);
+    m_watching = false;
+
+    Watchdog& watchdog = Watchdog::shared();
+    MutexLocker locker(watchdog.lock());
+
+    watchdog.remove(this);
+    if (m_threadClock) {
+        releaseThreadClock(m_threadClock);
+        m_threadClock = 0;
+    }
+
+    // A limit that ran out after the script's last check must not stop the
+    // next script.
+    if (m_exceeded) {
+        m_exceeded = NoResource;
+        m_globalData->terminationRequested = 0;
+    }
+}
+
+void ResourceLimits::didEnterScript()
+{
+    m_inScript = true;
+    if (hasTimeLimit())
+        arm();
+}
+
+void ResourceLimits::didExitScript()
+{
+    m_inScript = false;
+    if (m_watching)
+        disarm();
+
+    m_heapSizeLimitReported = false;
+    m_collectedAtHeapSizeLimit = false;
+    m_executableMemoryLimitReported = false;
+
+    // As with time limits, a memory limit the script did not get to see must
+    // not stop the next script.
+    if (m_memoryLimitExceeded) {
+        m_memoryLimitExceeded = NoResource;
+        m_globalData->terminationRequested = 0;
+    }
+}
+
+bool ResourceLimits::notifyClient(Resource resource)
+{
+    return !m_client || m_client->limitExceeded(m_globalData, resource);
+}
+
+bool ResourceLimits::shouldTerminate()
+{
+    Resource exceeded = NoResource;
+    if (m_watching) {
+        MutexLocker locker(Watchdog::shared().lock());
+        exceeded = m_exceeded;
+        m_exceeded = NoResource;
+    }
+
+    Resource memoryExceeded = m_memoryLimitExceeded;
+    m_memoryLimitExceeded = NoResource;
+
+    // Termination was requested through the API.
+    if (!exceeded && !memoryExceeded) {
+        m_terminationReason = NoResource;
+        return true;
+    }
+
+    if (memoryExceeded && notifyClient(memoryExceeded)) {
+        m_terminationReason = memoryExceeded;
+        return true;
+    }
+
+    if (exceeded) {
+        if (notifyClient(exceeded)) {
+            m_terminationReason = exceeded;
+            return true;
+        }
+
+        // The client let the script go on; give it a fresh allowance.
+        disarm();
+        arm();
+    }
+    return false;
+}
+
+// The client is told at the running script's next check for termination,
+// not here in the middle of an allocation.
+void ResourceLimits::memoryLimitExceeded(Resource resource, bool& reported)
+{
+    // Allocations made while no script is running, for example through the
+    // API, are not limited: there is no script to stop.
+    if (!m_inScript || reported)
+        return;
+    reported = true;
+
+    if (!m_memoryLimitExceeded)
+        m_memoryLimitExceeded = resource;
+    m_globalData->terminationRequested = 1;
+}
+
+bool ResourceLimits::shouldCollectAtHeapSizeLimit()
+{
+    if (!m_inScript || m_heapSizeLimitReported || m_collectedAtHeapSizeLimit)
+        return false;
+    m_collectedAtHeapSizeLimit = true;
+    return true;
+}
+
+void ResourceLimits::heapSizeLimitExceeded()
+{
+    memoryLimitExceeded(HeapSize, m_heapSizeLimitReported);
+}
+
+void ResourceLimits::executableMemoryLimitExceeded()
+{
+    memoryLimitExceeded(ExecutableMemory, m_executableMemoryLimitReported);
+}
+
+} // namespace TI
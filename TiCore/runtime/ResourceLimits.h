@@ -0,0 +1,137 @@
+/**
+ * Appcelerator Titanium License
+ * This source code and all modifications done by Appcelerator
+ * are licensed under the Apache Public License (version 2) and
+ * are Copyright (c) 2009 by Appcelerator, Inc.
+ */
+
+/*
+ * Copyright (C) 2009 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1.  Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ * 2.  Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ * 3.  Neither the name of Apple Computer, Inc. ("Apple") nor the names of
+ *     its contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE AND ITS CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL APPLE OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ResourceLimits_h
+#define ResourceLimits_h
+
+#include <stdint.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/OwnPtr.h>
+
+namespace TI {
+
+    class TiGlobalData;
+
+    // Limits on the time, heap and executable memory that the scripts in one
+    // TiGlobalData may use. Time limits are measured from the outermost entry
+    // into script, by a shared watchdog thread that sets the TiGlobalData's
+    // terminationRequested flag when a limit runs out, so running script pays
+    // nothing for them beyond the check it already makes at loop back-edges.
+    // Memory limits are checked only when the heap or the executable allocator
+    // has to grow, and only apply while script is running. All limits are
+    // soft: the allocation that crosses a limit still succeeds, and the client
+    // is told at the running script's next check, which stops the script
+    // unless the client decides otherwise.
+    class ResourceLimits : public Noncopyable {
+    public:
+        enum Resource { NoResource, ExecutionTime, CPUTime, HeapSize, ExecutableMemory };
+
+        class Client {
+        public:
+            virtual ~Client() { }
+            // Called on the thread running script, from the script's next check
+            // for termination. Returns whether the running script should be
+            // stopped.
+            virtual bool limitExceeded(TiGlobalData*, Resource) = 0;
+        };
+
+        ResourceLimits(TiGlobalData*);
+        ~ResourceLimits();
+
+        // Times are in seconds and sizes in bytes; zero means no limit. Time
+        // limits take effect from the next outermost entry into script.
+        void setLimits(double executionTime, double cpuTime, size_t heapSize, size_t executableMemory);
+        void setClient(Client* client) { m_client.set(client); }
+
+        size_t heapSizeLimit() const { return m_heapSizeLimit; }
+        size_t executableMemoryLimit() const { return m_executableMemoryLimit; }
+
+        // Called on the outermost entry into and exit from script.
+        bool hasTimeLimit() const { return m_executionTimeLimit || m_cpuTimeLimit; }
+        void didEnterScript();
+        void didExitScript();
+
+        // Called by the running script once it has seen terminationRequested.
+        bool shouldTerminate();
+        // The limit that stopped the last stopped script, or NoResource if it
+        // was stopped through the API.
+        Resource terminationReason() const { return m_terminationReason; }
+
+        // Called by the allocators, possibly in the middle of an allocation.
+        // When the heap must grow past its limit it collects first, but only
+        // while the limit can still be reported, and only once each time the
+        // heap reaches the limit; after that the usual collection schedule
+        // applies, so a heap at its limit does not collect for every block.
+        bool shouldCollectAtHeapSizeLimit();
+        void heapIsBelowHeapSizeLimit() { m_collectedAtHeapSizeLimit = false; }
+        void heapSizeLimitExceeded();
+        void executableMemoryLimitExceeded();
+
+    private:
+        friend class Watchdog;
+
+        bool notifyClient(Resource);
+        void memoryLimitExceeded(Resource, bool& reported);
+        void arm();
+        void disarm();
+
+        TiGlobalData* m_globalData;
+        OwnPtr<Client> m_client;
+
+        double m_executionTimeLimit;
+        double m_cpuTimeLimit;
+        size_t m_heapSizeLimit;
+        size_t m_executableMemoryLimit;
+
+        bool m_heapSizeLimitReported;
+        bool m_collectedAtHeapSizeLimit;
+        bool m_executableMemoryLimitReported;
+        Resource m_memoryLimitExceeded; // Waiting for the script's next check.
+        Resource m_terminationReason;
+        bool m_inScript;
+        bool m_watching;
+
+        // Watchdog state, guarded by the watchdog's lock.
+        bool m_armed;
+        double m_deadline;
+        double m_cpuTimeAtEntry;
+        double m_nextCPUTimeCheck;
+        intptr_t m_threadClock; // Reads the CPU time of the thread running script.
+        Resource m_exceeded;
+    };
+
+} // namespace TI
+
+#endif // ResourceLimits_h
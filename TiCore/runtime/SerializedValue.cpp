@@ -0,0 +1,656 @@
+/**
+ * Appcelerator Titanium License
+ * This source code and all modifications done by Appcelerator
+ * are licensed under the Apache Public License (version 2) and
+ * are Copyright (c) 2009 by Appcelerator, Inc.
+ */
+
+/*
+ * Copyright (C) 2009 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1.  Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ * 2.  Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ * 3.  Neither the name of Apple Computer, Inc. ("Apple") nor the names of
+ *     its contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE AND ITS CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL APPLE OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SerializedValue.h"
+
+#include "BooleanObject.h"
+#include "DateInstance.h"
+#include "Error.h"
+#include "NumberObject.h"
+#include "PropertyNameArray.h"
+#include "RegExpObject.h"
+#include "StringObject.h"
+#include "TiArray.h"
+#include "TiArrayArray.h"
+#include "TiGlobalObject.h"
+#include <wtf/HashMap.h>
+
+using namespace WTI;
+
+namespace TI {
+
+// Serialized values are only read back by the same version of TiCore, on a
+// machine with the same byte order, so numbers are written in native byte
+// order. Bytes handed in from outside are checked as they are read.
+enum SerializationTag {
+    UndefinedTag = 1,
+    NullTag,
+    FalseTag,
+    TrueTag,
+    IntTag,
+    DoubleTag,
+    StringTag,
+    ObjectTag,
+    ArrayTag,
+    SparseArrayTag,
+    DateTag,
+    RegExpTag,
+    BooleanObjectTag,
+    NumberObjectTag,
+    StringObjectTag,
+    ByteArrayTag,
+    TransferredByteArrayTag,
+    ObjectReferenceTag,
+    HoleTag
+};
+
+enum RegExpFlags { RegExpGlobal = 1, RegExpIgnoreCase = 2, RegExpMultiline = 4 };
+
+// Properties are written as name and value pairs, ending with terminatorName.
+// Names written before are written again as nameReferenceFlag | their index.
+static const uint32_t terminatorName = 0xFFFFFFFF;
+static const uint32_t nameReferenceFlag = 0x80000000;
+
+// Dense arrays are written element by element, with a HoleTag for each missing
+// one, followed by their other properties. Arrays with more holes than this
+// allows are written as named properties only.
+static inline bool isDense(unsigned length, size_t propertyCount)
+{
+    return length <= 2 * propertyCount + 8;
+}
+
+class Serializer : public Noncopyable {
+public:
+    Serializer(TiExcState* exec, Vector<unsigned char>& data, const Vector<TiArrayArray*>& transferList)
+        : m_exec(exec)
+        , m_data(data)
+        , m_transferList(transferList)
+    {
+    }
+
+    bool serialize(TiValue);
+
+    const Vector<TiArrayArray*>& transferredByteArrays() const { return m_transferredByteArrays; }
+
+private:
+    struct Object {
+        TiObject* object;
+        RefPtr<PropertyNameArrayData> propertyNames;
+        size_t propertyIndex;
+        unsigned index;
+        unsigned length;
+    };
+
+    void writeTag(SerializationTag tag) { m_data.append(static_cast<unsigned char>(tag)); }
+    template<typename T> void write(T value) { m_data.append(reinterpret_cast<const unsigned char*>(&value), sizeof(T)); }
+    void writeString(const UString&);
+    void writePropertyName(const Identifier&);
+    bool writeValue(TiValue);
+    bool startObject(TiObject*, bool isArray);
+    bool fail(const UString& message);
+
+    TiExcState* m_exec;
+    Vector<unsigned char>& m_data;
+    const Vector<TiArrayArray*>& m_transferList;
+    Vector<TiArrayArray*> m_transferredByteArrays;
+    HashMap<TiObject*, uint32_t> m_objects;
+    HashMap<RefPtr<UString::Rep>, uint32_t, IdentifierRepHash> m_propertyNames;
+    Vector<Object, 16> m_stack;
+};
+
+bool Serializer::fail(const UString& message)
+{
+    throwError(m_exec, TypeError, message);
+    return false;
+}
+
+void Serializer::writeString(const UString& string)
+{
+    write<uint32_t>(string.size());
+    // Characters are aligned, so that they can be read in place.
+    if (m_data.size() & 1)
+        m_data.append(0);
+    m_data.append(reinterpret_cast<const unsigned char*>(string.data()), string.size() * sizeof(UChar));
+}
+
+void Serializer::writePropertyName(const Identifier& name)
+{
+    std::pair<HashMap<RefPtr<UString::Rep>, uint32_t, IdentifierRepHash>::iterator, bool> result = m_propertyNames.add(name.ustring().rep(), m_propertyNames.size());
+    if (!result.second) {
+        write<uint32_t>(result.first->second | nameReferenceFlag);
+        return;
+    }
+    writeString(name.ustring());
+}
+
+bool Serializer::startObject(TiObject* object, bool isArray)
+{
+    PropertyNameArray propertyNames(m_exec);
+    object->getOwnPropertyNames(m_exec, propertyNames);
+    if (m_exec->hadException())
+        return false;
+
+    Object entry;
+    entry.object = object;
+    entry.propertyIndex = 0;
+    entry.index = 0;
+    entry.length = 0;
+
+    if (isArray) {
+        unsigned length = asArray(object)->length();
+        if (isDense(length, propertyNames.size())) {
+            writeTag(ArrayTag);
+            entry.length = length;
+        } else
+            writeTag(SparseArrayTag);
+        write<uint32_t>(length);
+    } else
+        writeTag(ObjectTag);
+
+    entry.propertyNames = propertyNames.releaseData();
+    m_stack.append(entry);
+    return true;
+}
+
+bool Serializer::writeValue(TiValue value)
+{
+    if (value.isUndefined()) {
+        writeTag(UndefinedTag);
+        return true;
+    }
+    if (value.isNull()) {
+        writeTag(NullTag);
+        return true;
+    }
+    if (value.isBoolean()) {
+        writeTag(value.isTrue() ? TrueTag : FalseTag);
+        return true;
+    }
+    if (value.isInt32()) {
+        writeTag(IntTag);
+        write<int32_t>(value.asInt32());
+        return true;
+    }
+    if (value.isNumber()) {
+        writeTag(DoubleTag);
+        write<double>(value.uncheckedGetNumber());
+        return true;
+    }
+    if (value.isString()) {
+        writeTag(StringTag);
+        writeString(asString(value)->value());
+        return true;
+    }
+    if (!value.isObject())
+        return fail("Cannot serialize value");
+
+    TiObject* object = asObject(value);
+    std::pair<HashMap<TiObject*, uint32_t>::iterator, bool> result = m_objects.add(object, m_objects.size());
+    if (!result.second) {
+        writeTag(ObjectReferenceTag);
+        write<uint32_t>(result.first->second);
+        return true;
+    }
+
+    if (!object->classInfo())
+        return startObject(object, false);
+
+    if (object->inherits(&TiArray::info))
+        return startObject(object, true);
+
+    if (isTiArrayArray(&m_exec->globalData(), object)) {
+        TiArrayArray* byteArray = asByteArray(object);
+        // Storage that something else still refers to is copied rather than moved.
+        if (m_transferList.find(byteArray) != notFound && byteArray->storage()->hasOneRef()) {
+            writeTag(TransferredByteArrayTag);
+            write<uint32_t>(m_transferredByteArrays.size());
+            m_transferredByteArrays.append(byteArray);
+            return true;
+        }
+        writeTag(ByteArrayTag);
+        write<uint32_t>(byteArray->length());
+        m_data.append(byteArray->storage()->data(), byteArray->length());
+        return true;
+    }
+
+    if (object->inherits(&DateInstance::info)) {
+        writeTag(DateTag);
+        write<double>(asDateInstance(object)->internalNumber());
+        return true;
+    }
+
+    if (object->inherits(&RegExpObject::info)) {
+        RegExp* regExp = asRegExpObject(object)->regExp();
+        writeTag(RegExpTag);
+        writeString(regExp->pattern());
+        write<uint8_t>((regExp->global() ? RegExpGlobal : 0) | (regExp->ignoreCase() ? RegExpIgnoreCase : 0) | (regExp->multiline() ? RegExpMultiline : 0));
+        return true;
+    }
+
+    if (object->inherits(&BooleanObject::info)) {
+        writeTag(BooleanObjectTag);
+        write<uint8_t>(asBooleanObject(object)->internalValue().isTrue());
+        return true;
+    }
+
+    if (object->inherits(&NumberObject::info)) {
+        writeTag(NumberObjectTag);
+        write<double>(static_cast<NumberObject*>(object)->internalValue().uncheckedGetNumber());
+        return true;
+    }
+
+    if (object->inherits(&StringObject::info)) {
+        writeTag(StringObjectTag);
+        writeString(asStringObject(object)->internalValue()->value());
+        return true;
+    }
+
+    return fail("Cannot serialize " + object->className() + " objects");
+}
+
+bool Serializer::serialize(TiValue value)
+{
+    if (!writeValue(value))
+        return false;
+
+    while (!m_stack.isEmpty()) {
+        Object& top = m_stack.last();
+        TiObject* object = top.object;
+        TiValue propertyValue;
+
+        if (top.index < top.length) {
+            unsigned index = top.index++;
+            PropertySlot slot(object);
+            if (!object->getOwnPropertySlot(m_exec, index, slot)) {
+                writeTag(HoleTag);
+                continue;
+            }
+            propertyValue = slot.getValue(m_exec, index);
+        } else {
+            PropertyNameArrayData::PropertyNameVector& propertyNames = top.propertyNames->propertyNameVector();
+            // The elements of dense arrays have already been written.
+            for (; top.length && top.propertyIndex < propertyNames.size(); ++top.propertyIndex) {
+                bool isIndex;
+                unsigned index = propertyNames[top.propertyIndex].toArrayIndex(&isIndex);
+                if (!isIndex || index >= top.length)
+                    break;
+            }
+
+            if (top.propertyIndex == propertyNames.size()) {
+                write<uint32_t>(terminatorName);
+                m_stack.removeLast();
+                continue;
+            }
+
+            const Identifier& propertyName = propertyNames[top.propertyIndex++];
+            writePropertyName(propertyName);
+            propertyValue = object->get(m_exec, propertyName);
+        }
+
+        if (m_exec->hadException())
+            return false;
+        if (!writeValue(propertyValue))
+            return false;
+    }
+
+    return true;
+}
+
+class Deserializer : public Noncopyable {
+public:
+    Deserializer(TiExcState* exec, const Vector<unsigned char>& data, const Vector<RefPtr<ByteArray> >& transferredByteArrays)
+        : m_exec(exec)
+        , m_globalObject(exec->lexicalGlobalObject())
+        , m_start(data.data())
+        , m_position(data.data())
+        , m_end(data.data() + data.size())
+        , m_transferredByteArrays(transferredByteArrays)
+    {
+    }
+
+    bool deserialize(TiValue&);
+
+private:
+    struct Object {
+        TiObject* object;
+        unsigned index;
+        unsigned length;
+        bool isArray;
+    };
+
+    template<typename T> bool read(T& value)
+    {
+        if (static_cast<size_t>(m_end - m_position) < sizeof(T))
+            return false;
+        memcpy(&value, m_position, sizeof(T));
+        m_position += sizeof(T);
+        return true;
+    }
+    const UChar* readCharacters(uint32_t length);
+    bool readString(UString&);
+    bool readPropertyName(uint32_t, Identifier&);
+    bool readValue(TiValue&);
+    TiObject* addObject(TiObject*);
+    TiObject* startObject(TiObject*, bool isArray, unsigned length);
+
+    TiExcState* m_exec;
+    TiGlobalObject* m_globalObject;
+    const unsigned char* m_start;
+    const unsigned char* m_position;
+    const unsigned char* m_end;
+    const Vector<RefPtr<ByteArray> >& m_transferredByteArrays;
+    MarkedArgumentBuffer m_objects;
+    Vector<Identifier> m_propertyNames;
+    Vector<Object, 16> m_stack;
+};
+
+const UChar* Deserializer::readCharacters(uint32_t length)
+{
+    if (((m_position - m_start) & 1) && m_position < m_end)
+        ++m_position;
+    if (static_cast<size_t>(m_end - m_position) / sizeof(UChar) < length)
+        return 0;
+    const UChar* characters = reinterpret_cast<const UChar*>(m_position);
+    m_position += length * sizeof(UChar);
+    return characters;
+}
+
+bool Deserializer::readString(UString& string)
+{
+    uint32_t length;
+    if (!read(length))
+        return false;
+    const UChar* characters = readCharacters(length);
+    if (!characters)
+        return false;
+    string = UString(characters, length);
+    return true;
+}
+
+bool Deserializer::readPropertyName(uint32_t value, Identifier& propertyName)
+{
+    if (value & nameReferenceFlag) {
+        value &= ~nameReferenceFlag;
+        if (value >= m_propertyNames.size())
+            return false;
+        propertyName = m_propertyNames[value];
+        return true;
+    }
+
+    const UChar* characters = readCharacters(value);
+    if (!characters)
+        return false;
+    propertyName = Identifier(m_exec, characters, value);
+    m_propertyNames.append(propertyName);
+    return true;
+}
+
+TiObject* Deserializer::addObject(TiObject* object)
+{
+    m_objects.append(object);
+    return object;
+}
+
+TiObject* Deserializer::startObject(TiObject* object, bool isArray, unsigned length)
+{
+    Object entry;
+    entry.object = object;
+    entry.index = 0;
+    entry.length = length;
+    entry.isArray = isArray;
+    m_stack.append(entry);
+    return addObject(object);
+}
+
+bool Deserializer::readValue(TiValue& value)
+{
+    uint8_t tag;
+    if (!read(tag))
+        return false;
+
+    switch (tag) {
+    case UndefinedTag:
+        value = jsUndefined();
+        return true;
+    case NullTag:
+        value = jsNull();
+        return true;
+    case FalseTag:
+        value = jsBoolean(false);
+        return true;
+    case TrueTag:
+        value = jsBoolean(true);
+        return true;
+    case IntTag: {
+        int32_t number;
+        if (!read(number))
+            return false;
+        value = jsNumber(m_exec, number);
+        return true;
+    }
+    case DoubleTag: {
+        double number;
+        if (!read(number))
+            return false;
+        value = jsNumber(m_exec, number);
+        return true;
+    }
+    case StringTag: {
+        UString string;
+        if (!readString(string))
+            return false;
+        value = jsString(m_exec, string);
+        return true;
+    }
+    case ObjectTag:
+        value = startObject(new (m_exec) TiObject(m_globalObject->emptyObjectStructure()), false, 0);
+        return true;
+    case ArrayTag:
+    case SparseArrayTag: {
+        uint32_t length;
+        if (!read(length))
+            return false;
+        if (tag == ArrayTag) {
+            // Each element takes at least a byte.
+            if (static_cast<size_t>(m_end - m_position) < length)
+                return false;
+            value = startObject(new (m_exec) TiArray(m_globalObject->arrayStructure(), length), true, length);
+            return true;
+        }
+        TiArray* array = new (m_exec) TiArray(m_globalObject->arrayStructure());
+        array->setLength(length);
+        value = startObject(array, true, 0);
+        return true;
+    }
+    case DateTag: {
+        double time;
+        if (!read(time))
+            return false;
+        value = addObject(new (m_exec) DateInstance(m_exec, time));
+        return true;
+    }
+    case RegExpTag: {
+        UString pattern;
+        uint8_t flags;
+        if (!readString(pattern) || !read(flags))
+            return false;
+        UString flagString = "";
+        if (flags & RegExpGlobal)
+            flagString.append("g");
+        if (flags & RegExpIgnoreCase)
+            flagString.append("i");
+        if (flags & RegExpMultiline)
+            flagString.append("m");
+        value = addObject(new (m_exec) RegExpObject(m_globalObject->regExpStructure(), m_exec->globalData().regExpCache.lookupOrCreate(pattern, flagString)));
+        return true;
+    }
+    case BooleanObjectTag: {
+        uint8_t boolean;
+        if (!read(boolean))
+            return false;
+        BooleanObject* object = new (m_exec) BooleanObject(m_globalObject->booleanObjectStructure());
+        object->setInternalValue(jsBoolean(boolean));
+        value = addObject(object);
+        return true;
+    }
+    case NumberObjectTag: {
+        double number;
+        if (!read(number))
+            return false;
+        NumberObject* object = new (m_exec) NumberObject(m_globalObject->numberObjectStructure());
+        object->setInternalValue(jsNumber(m_exec, number));
+        value = addObject(object);
+        return true;
+    }
+    case StringObjectTag: {
+        UString string;
+        if (!readString(string))
+            return false;
+        value = addObject(new (m_exec) StringObject(m_exec, m_globalObject->stringObjectStructure(), string));
+        return true;
+    }
+    case ByteArrayTag: {
+        uint32_t length;
+        if (!read(length) || static_cast<size_t>(m_end - m_position) < length)
+            return false;
+        RefPtr<ByteArray> storage = ByteArray::create(length);
+        memcpy(storage->data(), m_position, length);
+        m_position += length;
+        value = addObject(new (m_exec) TiArrayArray(m_exec, m_globalObject->byteArrayStructure(), storage.get()));
+        return true;
+    }
+    case TransferredByteArrayTag: {
+        uint32_t index;
+        if (!read(index))
+            return false;
+        RefPtr<ByteArray> storage = index < m_transferredByteArrays.size() ? m_transferredByteArrays[index] : RefPtr<ByteArray>(ByteArray::create(0));
+        value = addObject(new (m_exec) TiArrayArray(m_exec, m_globalObject->byteArrayStructure(), storage.get()));
+        return true;
+    }
+    case ObjectReferenceTag: {
+        uint32_t index;
+        if (!read(index) || index >= m_objects.size())
+            return false;
+        value = m_objects.at(index);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+bool Deserializer::deserialize(TiValue& result)
+{
+    if (!readValue(result))
+        return false;
+
+    while (!m_stack.isEmpty()) {
+        Object& top = m_stack.last();
+        TiObject* object = top.object;
+        TiValue value;
+
+        if (top.index < top.length) {
+            unsigned index = top.index++;
+            if (m_position < m_end && *m_position == HoleTag) {
+                ++m_position;
+                continue;
+            }
+            if (!readValue(value))
+                return false;
+            object->put(m_exec, index, value);
+            continue;
+        }
+
+        bool isArray = top.isArray;
+        uint32_t name;
+        if (!read(name))
+            return false;
+        if (name == terminatorName) {
+            m_stack.removeLast();
+            continue;
+        }
+
+        Identifier propertyName;
+        if (!readPropertyName(name, propertyName) || !readValue(value))
+            return false;
+        if (isArray) {
+            PutPropertySlot slot;
+            object->put(m_exec, propertyName, value, slot);
+        } else
+            object->putDirect(propertyName, value);
+    }
+
+    return m_position == m_end;
+}
+
+PassRefPtr<SerializedValue> SerializedValue::create(TiExcState* exec, TiValue value, const Vector<TiArrayArray*>& transferList)
+{
+    RefPtr<SerializedValue> serializedValue = adoptRef(new SerializedValue);
+    Serializer serializer(exec, serializedValue->m_data, transferList);
+    if (!serializer.serialize(value))
+        return 0;
+
+    // Byte arrays are only emptied once nothing can go wrong.
+    const Vector<TiArrayArray*>& transferredByteArrays = serializer.transferredByteArrays();
+    for (size_t i = 0; i < transferredByteArrays.size(); ++i)
+        serializedValue->m_transferredByteArrays.append(transferredByteArrays[i]->transferStorage(exec));
+    serializedValue->m_data.shrinkToFit();
+    return serializedValue.release();
+}
+
+PassRefPtr<SerializedValue> SerializedValue::create(const unsigned char* data, size_t size)
+{
+    RefPtr<SerializedValue> serializedValue = adoptRef(new SerializedValue);
+    serializedValue->m_data.append(data, size);
+    return serializedValue.release();
+}
+
+TiValue SerializedValue::deserialize(TiExcState* exec)
+{
+    Vector<RefPtr<ByteArray> > transferredByteArrays;
+    {
+        MutexLocker locker(m_transferredByteArraysMutex);
+        transferredByteArrays.swap(m_transferredByteArrays);
+    }
+
+    TiValue result;
+    Deserializer deserializer(exec, m_data, transferredByteArrays);
+    if (!deserializer.deserialize(result))
+        return throwError(exec, GeneralError, "Cannot deserialize value");
+    return result;
+}
+
+} // namespace TI
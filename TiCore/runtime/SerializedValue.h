@@ -0,0 +1,87 @@
+/**
+ * Appcelerator Titanium License
+ * This source code and all modifications done by Appcelerator
+ * are licensed under the Apache Public License (version 2) and
+ * are Copyright (c) 2009 by Appcelerator, Inc.
+ */
+
+/*
+ * Copyright (C) 2009 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1.  Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ * 2.  Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ * 3.  Neither the name of Apple Computer, Inc. ("Apple") nor the names of
+ *     its contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE AND ITS CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL APPLE OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SerializedValue_h
+#define SerializedValue_h
+
+#include <wtf/ByteArray.h>
+#include <wtf/RefPtr.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+namespace TI {
+
+    class TiArrayArray;
+    class TiExcState;
+    class TiValue;
+
+    // A value copied out of a context by the structured clone algorithm, in a form
+    // that can be handed to another thread and deserialized in any TiGlobalData.
+    // Undefined, null, booleans, numbers, strings, plain objects, arrays, Dates,
+    // RegExps, primitive wrapper objects and byte arrays can be serialized, as can
+    // cycles and shared references between them.
+    class SerializedValue : public ThreadSafeShared<SerializedValue> {
+    public:
+        // Returns 0, with an exception set on exec, if value holds anything else.
+        // The storage of the byte arrays in transferList moves into the serialized
+        // value instead of being copied, leaving those byte arrays empty.
+        static PassRefPtr<SerializedValue> create(TiExcState*, TiValue, const Vector<TiArrayArray*>& transferList);
+
+        // A value whose bytes came from data() of another one. The bytes are
+        // only checked when the value is deserialized.
+        static PassRefPtr<SerializedValue> create(const unsigned char* data, size_t size);
+
+        // Storage moved into the value moves on into the first copy deserialized
+        // from it; later copies get empty byte arrays in its place.
+        TiValue deserialize(TiExcState*);
+
+        size_t size() const { return m_data.size(); }
+        const unsigned char* data() const { return m_data.data(); }
+
+    private:
+        SerializedValue()
+        {
+        }
+
+        friend class Serializer;
+
+        Vector<unsigned char> m_data;
+        Vector<RefPtr<WTI::ByteArray> > m_transferredByteArrays;
+        Mutex m_transferredByteArraysMutex;
+    };
+
+} // namespace TI
+
+#endif // SerializedValue_h
@@ -155,9 +155,9 @@ bool StringPrototype::getOwnPropertyDescriptor(TiExcState* exec, const Identifie
 
 // ------------------------------ Functions --------------------------
 
-static inline UString substituteBackreferences(const UString& replacement, const UString& source, const int* ovector, RegExp* reg)
+// Appends replacement to result, expanding its $-patterns against the match described by ovector.
+static inline void appendSubstitutedBackreferences(Vector<UChar>& result, const UString& replacement, const UString& source, const int* ovector, RegExp* reg)
 {
-    UString substitutedReplacement;
     int offset = 0;
     int i = -1;
     while ((i = replacement.find('$', i + 1)) != -1) {
@@ -168,7 +168,7 @@ static inline UString substituteBackreferences(const UString& replacement, const
         if (ref == '$') {
             // "$$" -> "$"
             ++i;
-            substitutedReplacement.append(replacement.data() + offset, i - offset);
+            result.append(replacement.data() + offset, i - offset);
             offset = i + 1;
             continue;
         }
@@ -208,19 +208,28 @@ static inline UString substituteBackreferences(const UString& replacement, const
             continue;
 
         if (i - offset)
-            substitutedReplacement.append(replacement.data() + offset, i - offset);
+            result.append(replacement.data() + offset, i - offset);
         i += 1 + advance;
         offset = i + 1;
-        substitutedReplacement.append(source.data() + backrefStart, backrefLength);
+        if (backrefStart >= 0)
+            result.append(source.data() + backrefStart, backrefLength);
     }
 
-    if (!offset)
-        return replacement;
-
     if (replacement.size() - offset)
-        substitutedReplacement.append(replacement.data() + offset, replacement.size() - offset);
+        result.append(replacement.data() + offset, replacement.size() - offset);
+}
+
+static inline UString substituteBackreferences(const UString& replacement, const UString& source, const int* ovector, RegExp* reg)
+{
+    if (replacement.find('$') == -1)
+        return replacement;
 
-    return substitutedReplacement;
+    Vector<UChar> result;
+    appendSubstitutedBackreferences(result, replacement, source, ovector, reg);
+    unsigned size = result.size();
+    if (!size)
+        return "";
+    return UString(result.releaseBuffer(), size, false);
 }
 
 static inline int localeCompare(const UString& a, const UString& b)
@@ -250,12 +259,46 @@ TiValue JSC_HOST_CALL stringProtoFuncReplace(TiExcState* exec, TiObject*, TiValu
 
         int lastIndex = 0;
         int startPosition = 0;
+        bool matched = false;
 
-        Vector<UString::Range, 16> sourceRanges;
-        Vector<UString, 16> replacements;
+        // The result is built in one buffer: the source between matches, and each match's replacement.
+        Vector<UChar> result;
 
         // This is either a loop (if global is set) or a one-way (if not).
-        if (global && callType == CallTypeJS) {
+        if (callType == CallTypeNone) {
+            // Nothing can observe the constructor's last-match state until the replace
+            // is done, so match into local vectors and record only the final match.
+            Vector<int, 32> ovectors[2];
+            unsigned current = 0;
+            do {
+                int matchIndex = reg->match(source, startPosition, &ovectors[current]);
+                if (matchIndex < 0)
+                    break;
+                const int* ovector = ovectors[current].data();
+                int matchLen = ovector[1] - ovector[0];
+                current = current ? 0 : 1;
+
+                if (!matched) {
+                    result.reserveCapacity(source.size());
+                    matched = true;
+                }
+                result.append(source.data() + lastIndex, matchIndex - lastIndex);
+                appendSubstitutedBackreferences(result, replacementString, source, ovector, reg);
+
+                lastIndex = matchIndex + matchLen;
+                startPosition = lastIndex;
+
+                // special case of empty match
+                if (matchLen == 0) {
+                    startPosition++;
+                    if (startPosition > source.size())
+                        break;
+                }
+            } while (global);
+
+            if (matched)
+                regExpConstructor->setLastMatch(reg, source, ovectors[current ? 0 : 1]);
+        } else if (global && callType == CallTypeJS) {
             // reg->numSubpatterns() + 1 for pattern args, + 2 for match start and sourceValue
             int argCount = reg->numSubpatterns() + 1 + 2;
             TiFunction* func = asFunction(replacement);
@@ -269,8 +312,9 @@ TiValue JSC_HOST_CALL stringProtoFuncReplace(TiExcState* exec, TiObject*, TiValu
                 regExpConstructor->performMatch(reg, source, startPosition, matchIndex, matchLen, &ovector);
                 if (matchIndex < 0)
                     break;
-                
-                sourceRanges.append(UString::Range(lastIndex, matchIndex - lastIndex));
+
+                matched = true;
+                result.append(source.data() + lastIndex, matchIndex - lastIndex);
 
                 int completeMatchStart = ovector[0];
                 unsigned i = 0;
@@ -288,9 +332,10 @@ TiValue JSC_HOST_CALL stringProtoFuncReplace(TiExcState* exec, TiObject*, TiValu
                 cachedCall.setArgument(i++, sourceVal);
                 
                 cachedCall.setThis(exec->globalThisValue());
-                replacements.append(cachedCall.call().toString(cachedCall.newCallFrame()));
+                UString functionResult = cachedCall.call().toString(cachedCall.newCallFrame());
                 if (exec->hadException())
                     break;
+                result.append(functionResult.data(), functionResult.size());
 
                 lastIndex = matchIndex + matchLen;
                 startPosition = lastIndex;
@@ -311,30 +356,29 @@ TiValue JSC_HOST_CALL stringProtoFuncReplace(TiExcState* exec, TiObject*, TiValu
                 if (matchIndex < 0)
                     break;
 
-                sourceRanges.append(UString::Range(lastIndex, matchIndex - lastIndex));
+                matched = true;
+                result.append(source.data() + lastIndex, matchIndex - lastIndex);
 
-                if (callType != CallTypeNone) {
-                    int completeMatchStart = ovector[0];
-                    MarkedArgumentBuffer args;
+                int completeMatchStart = ovector[0];
+                MarkedArgumentBuffer args;
 
-                    for (unsigned i = 0; i < reg->numSubpatterns() + 1; ++i) {
-                        int matchStart = ovector[i * 2];
-                        int matchLen = ovector[i * 2 + 1] - matchStart;
+                for (unsigned i = 0; i < reg->numSubpatterns() + 1; ++i) {
+                    int matchStart = ovector[i * 2];
+                    int matchLen = ovector[i * 2 + 1] - matchStart;
 
-                        if (matchStart < 0)
-                            args.append(jsUndefined());
-                        else
-                            args.append(jsSubstring(exec, source, matchStart, matchLen));
-                    }
+                    if (matchStart < 0)
+                        args.append(jsUndefined());
+                    else
+                        args.append(jsSubstring(exec, source, matchStart, matchLen));
+                }
 
-                    args.append(jsNumber(exec, completeMatchStart));
-                    args.append(sourceVal);
+                args.append(jsNumber(exec, completeMatchStart));
+                args.append(sourceVal);
 
-                    replacements.append(call(exec, replacement, callType, callData, exec->globalThisValue(), args).toString(exec));
-                    if (exec->hadException())
-                        break;
-                } else
-                    replacements.append(substituteBackreferences(replacementString, source, ovector, reg));
+                UString functionResult = call(exec, replacement, callType, callData, exec->globalThisValue(), args).toString(exec);
+                if (exec->hadException())
+                    break;
+                result.append(functionResult.data(), functionResult.size());
 
                 lastIndex = matchIndex + matchLen;
                 startPosition = lastIndex;
@@ -348,14 +392,16 @@ TiValue JSC_HOST_CALL stringProtoFuncReplace(TiExcState* exec, TiObject*, TiValu
             } while (global);
         }
 
-        if (!lastIndex && replacements.isEmpty())
+        if (!matched)
             return sourceVal;
 
         if (lastIndex < source.size())
-            sourceRanges.append(UString::Range(lastIndex, source.size() - lastIndex));
+            result.append(source.data() + lastIndex, source.size() - lastIndex);
 
-        return jsString(exec, source.spliceSubstringsWithSeparators(sourceRanges.data(), sourceRanges.size(),
-            replacements.data(), replacements.size()));
+        unsigned resultSize = result.size();
+        if (!resultSize)
+            return jsEmptyString(exec);
+        return jsString(exec, UString(result.releaseBuffer(), resultSize, false));
     }
 
     // Not a regular expression, so treat the pattern as a string.
@@ -496,7 +542,7 @@ TiValue JSC_HOST_CALL stringProtoFuncMatch(TiExcState* exec, TiObject*, TiValue
          *  If regexp is not an object whose [[Class]] property is "RegExp", it is
          *  replaced with the result of the expression new RegExp(regexp).
          */
-        reg = RegExp::create(&exec->globalData(), a0.toString(exec));
+        reg = exec->globalData().regExpCache.lookupOrCreate(a0.toString(exec));
     }
     RegExpConstructor* regExpConstructor = exec->lexicalGlobalObject()->regExpConstructor();
     int pos;
@@ -546,7 +592,7 @@ TiValue JSC_HOST_CALL stringProtoFuncSearch(TiExcState* exec, TiObject*, TiValue
          *  If regexp is not an object whose [[Class]] property is "RegExp", it is
          *  replaced with the result of the expression new RegExp(regexp).
          */
-        reg = RegExp::create(&exec->globalData(), a0.toString(exec));
+        reg = exec->globalData().regExpCache.lookupOrCreate(a0.toString(exec));
     }
     RegExpConstructor* regExpConstructor = exec->lexicalGlobalObject()->regExpConstructor();
     int pos;
@@ -586,7 +632,8 @@ TiValue JSC_HOST_CALL stringProtoFuncSplit(TiExcState* exec, TiObject*, TiValue
     TiValue a0 = args.at(0);
     TiValue a1 = args.at(1);
 
-    TiArray* result = constructEmptyArray(exec);
+    // The pieces are collected first so the array is allocated once, at its final length.
+    MarkedArgumentBuffer result;
     unsigned i = 0;
     int p0 = 0;
     unsigned limit = a1.isUndefined() ? 0xFFFFFFFFU : a1.toUInt32(exec);
@@ -594,26 +641,28 @@ TiValue JSC_HOST_CALL stringProtoFuncSplit(TiExcState* exec, TiObject*, TiValue
         RegExp* reg = asRegExpObject(a0)->regExp();
         if (s.isEmpty() && reg->match(s, 0) >= 0) {
             // empty string matched by regexp -> empty array
-            return result;
+            return constructEmptyArray(exec);
         }
         int pos = 0;
+        Vector<int, 32> ovector;
         while (i != limit && pos < s.size()) {
-            Vector<int, 32> ovector;
             int mpos = reg->match(s, pos, &ovector);
             if (mpos < 0)
                 break;
             int mlen = ovector[1] - ovector[0];
             pos = mpos + (mlen == 0 ? 1 : mlen);
             if (mpos != p0 || mlen) {
-                result->put(exec, i++, jsSubstring(exec, s, p0, mpos - p0));
+                result.append(jsSubstring(exec, s, p0, mpos - p0));
+                ++i;
                 p0 = mpos + mlen;
             }
             for (unsigned si = 1; si <= reg->numSubpatterns(); ++si) {
                 int spos = ovector[si * 2];
                 if (spos < 0)
-                    result->put(exec, i++, jsUndefined());
+                    result.append(jsUndefined());
                 else
-                    result->put(exec, i++, jsSubstring(exec, s, spos, ovector[si * 2 + 1] - spos));
+                    result.append(jsSubstring(exec, s, spos, ovector[si * 2 + 1] - spos));
+                ++i;
             }
         }
     } else {
@@ -621,14 +670,17 @@ TiValue JSC_HOST_CALL stringProtoFuncSplit(TiExcState* exec, TiObject*, TiValue
         if (u2.isEmpty()) {
             if (s.isEmpty()) {
                 // empty separator matches empty string -> empty array
-                return result;
+                return constructEmptyArray(exec);
+            }
+            while (i != limit && p0 < s.size() - 1) {
+                result.append(jsSingleCharacterSubstring(exec, s, p0++));
+                ++i;
             }
-            while (i != limit && p0 < s.size() - 1)
-                result->put(exec, i++, jsSingleCharacterSubstring(exec, s, p0++));
         } else {
             int pos;
             while (i != limit && (pos = s.find(u2, p0)) >= 0) {
-                result->put(exec, i++, jsSubstring(exec, s, p0, pos - p0));
+                result.append(jsSubstring(exec, s, p0, pos - p0));
+                ++i;
                 p0 = pos + u2.size();
             }
         }
@@ -636,9 +688,9 @@ TiValue JSC_HOST_CALL stringProtoFuncSplit(TiExcState* exec, TiObject*, TiValue
 
     // add remaining string
     if (i != limit)
-        result->put(exec, i++, jsSubstring(exec, s, p0, s.size() - p0));
+        result.append(jsSubstring(exec, s, p0, s.size() - p0));
 
-    return result;
+    return constructArray(exec, result);
 }
 
 TiValue JSC_HOST_CALL stringProtoFuncSubstr(TiExcState* exec, TiObject*, TiValue thisValue, const ArgList& args)
@@ -1109,6 +1109,28 @@ void Structure::getEnumerablePropertyNames(PropertyNameArray& propertyNames)
     }
 }
 
+void Structure::getAllPropertyNames(PropertyNameArray& propertyNames)
+{
+    materializePropertyMapIfNecessary();
+    if (!m_propertyTable)
+        return;
+
+    Vector<PropertyMapEntry*, smallMapThreshold> sortedEntries(m_propertyTable->keyCount);
+
+    PropertyMapEntry** p = sortedEntries.data();
+    unsigned entryCount = m_propertyTable->keyCount + m_propertyTable->deletedSentinelCount;
+    for (unsigned i = 1; i <= entryCount; i++) {
+        if (m_propertyTable->entries()[i].key)
+            *p++ = &m_propertyTable->entries()[i];
+    }
+
+    ASSERT(p == sortedEntries.data() + m_propertyTable->keyCount);
+    qsort(sortedEntries.data(), sortedEntries.size(), sizeof(PropertyMapEntry*), comparePropertyMapEntryIndices);
+
+    for (size_t i = 0; i < sortedEntries.size(); ++i)
+        propertyNames.add(sortedEntries[i]->key);
+}
+
 #if DO_PROPERTYMAP_CONSTENCY_CHECK
 
 void Structure::checkConsistency()
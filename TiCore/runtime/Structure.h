@@ -139,6 +139,7 @@ namespace TI {
         void setEnumerationCache(TiPropertyNameIterator* enumerationCache); // Defined in TiPropertyNameIterator.h.
         TiPropertyNameIterator* enumerationCache() { return m_enumerationCache.get(); }
         void getEnumerablePropertyNames(PropertyNameArray&);
+        void getAllPropertyNames(PropertyNameArray&); // Includes DontEnum properties, in the order they were added.
 
     private:
         Structure(TiValue prototype, const TypeInfo&);
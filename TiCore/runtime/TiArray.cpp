@@ -35,9 +35,9 @@
 #include "Error.h"
 #include "Executable.h"
 #include "PropertyNameArray.h"
-#include <wtf/AVLTree.h>
 #include <wtf/Assertions.h>
 #include <wtf/OwnPtr.h>
+#include <wtf/TimSort.h>
 #include <Operations.h>
 
 #define CHECK_ARRAY_CONSISTENCY 0
@@ -109,6 +109,25 @@ static inline size_t storageSize(unsigned vectorLength)
     return size;
 }
 
+// The storage allocation starts indexBias values before the storage itself.
+static inline TiValue* storageAllocation(ArrayStorage* storage, unsigned indexBias)
+{
+    return reinterpret_cast<TiValue*>(storage) - indexBias;
+}
+
+static inline bool reallocateStorage(ArrayStorage*& storage, unsigned indexBias, unsigned newVectorLength)
+{
+    if (newVectorLength > MAX_STORAGE_VECTOR_LENGTH - indexBias)
+        return false;
+
+    void* allocation = storageAllocation(storage, indexBias);
+    if (!tryFastRealloc(allocation, storageSize(newVectorLength + indexBias)).getValue(allocation))
+        return false;
+
+    storage = reinterpret_cast<ArrayStorage*>(static_cast<TiValue*>(allocation) + indexBias);
+    return true;
+}
+
 static inline unsigned increasedVectorLength(unsigned newLength)
 {
     ASSERT(newLength <= MAX_STORAGE_VECTOR_LENGTH);
@@ -144,6 +163,7 @@ TiArray::TiArray(NonNullPassRefPtr<Structure> structure)
 
     m_storage = static_cast<ArrayStorage*>(fastZeroedMalloc(storageSize(initialCapacity)));
     m_vectorLength = initialCapacity;
+    m_indexBias = 0;
 
     checkConsistency();
 }
@@ -156,6 +176,7 @@ TiArray::TiArray(NonNullPassRefPtr<Structure> structure, unsigned initialLength)
     m_storage = static_cast<ArrayStorage*>(fastMalloc(storageSize(initialCapacity)));
     m_storage->m_length = initialLength;
     m_vectorLength = initialCapacity;
+    m_indexBias = 0;
     m_storage->m_numValuesInVector = 0;
     m_storage->m_sparseValueMap = 0;
     m_storage->lazyCreationData = 0;
@@ -177,6 +198,7 @@ TiArray::TiArray(NonNullPassRefPtr<Structure> structure, const ArgList& list)
     m_storage = static_cast<ArrayStorage*>(fastMalloc(storageSize(initialCapacity)));
     m_storage->m_length = initialCapacity;
     m_vectorLength = initialCapacity;
+    m_indexBias = 0;
     m_storage->m_numValuesInVector = initialCapacity;
     m_storage->m_sparseValueMap = 0;
 
@@ -195,7 +217,7 @@ TiArray::~TiArray()
     checkConsistency(DestructorConsistencyCheck);
 
     delete m_storage->m_sparseValueMap;
-    fastFree(m_storage);
+    fastFree(storageAllocation(m_storage, m_indexBias));
 }
 
 bool TiArray::getOwnPropertySlot(TiExcState* exec, unsigned i, PropertySlot& slot)
@@ -380,7 +402,7 @@ NEVER_INLINE void TiArray::putSlowCase(TiExcState* exec, unsigned i, TiValue val
         }
     }
 
-    if (!tryFastRealloc(storage, storageSize(newVectorLength)).getValue(storage)) {
+    if (!reallocateStorage(storage, m_indexBias, newVectorLength)) {
         throwOutOfMemoryError(exec);
         return;
     }
@@ -494,9 +516,28 @@ bool TiArray::increaseVectorLength(unsigned newLength)
     unsigned vectorLength = m_vectorLength;
     ASSERT(newLength > vectorLength);
     ASSERT(newLength <= MAX_STORAGE_VECTOR_INDEX);
+
+    // Give the room left by shiftCount back to the vector when there is enough
+    // of it, so that an array used as a queue does not grow without bound.
+    if (m_indexBias && m_indexBias >= (newLength >> 1)) {
+        ArrayStorage* newStorage = reinterpret_cast<ArrayStorage*>(storageAllocation(storage, m_indexBias));
+        memmove(newStorage, storage, storageSize(vectorLength));
+        unsigned reclaimedVectorLength = vectorLength + m_indexBias;
+        for (unsigned i = vectorLength; i < reclaimedVectorLength; ++i)
+            newStorage->m_vector[i] = TiValue();
+
+        storage = newStorage;
+        vectorLength = reclaimedVectorLength;
+        m_storage = storage;
+        m_vectorLength = vectorLength;
+        m_indexBias = 0;
+        if (newLength <= vectorLength)
+            return true;
+    }
+
     unsigned newVectorLength = increasedVectorLength(newLength);
 
-    if (!tryFastRealloc(storage, storageSize(newVectorLength)).getValue(storage))
+    if (!reallocateStorage(storage, m_indexBias, newVectorLength))
         return false;
 
     Heap::heap(this)->reportExtraMemoryCost(storageSize(newVectorLength) - storageSize(vectorLength));
@@ -587,6 +628,133 @@ TiValue TiArray::pop()
     return result;
 }
 
+bool TiArray::shiftCount(unsigned count)
+{
+    checkConsistency();
+
+    ArrayStorage* storage = m_storage;
+    unsigned length = storage->m_length;
+    if (!isDense() || count > length)
+        return false;
+
+    // Slide the storage header forward over the shifted values instead of moving the rest of the vector.
+    ASSERT(!(storageSize(0) % sizeof(TiValue)));
+    ArrayStorage* newStorage = reinterpret_cast<ArrayStorage*>(reinterpret_cast<TiValue*>(storage) + count);
+    memmove(newStorage, storage, storageSize(0));
+
+    newStorage->m_length = length - count;
+    newStorage->m_numValuesInVector = length - count;
+    m_storage = newStorage;
+    m_indexBias += count;
+    m_vectorLength -= count;
+
+    checkConsistency();
+    return true;
+}
+
+bool TiArray::unshiftCount(unsigned count)
+{
+    checkConsistency();
+
+    ArrayStorage* storage = m_storage;
+    unsigned length = storage->m_length;
+    if (!isDense() || count > MAX_STORAGE_VECTOR_LENGTH - length)
+        return false;
+
+    if (count <= m_indexBias) {
+        ArrayStorage* newStorage = reinterpret_cast<ArrayStorage*>(reinterpret_cast<TiValue*>(storage) - count);
+        memmove(newStorage, storage, storageSize(0));
+        m_storage = newStorage;
+        m_indexBias -= count;
+        m_vectorLength += count;
+    } else {
+        // Leave room at the front for as many values again, so that a run of
+        // unshifts reallocates only a logarithmic number of times.
+        unsigned newLength = length + count;
+        unsigned newIndexBias = min(newLength >> 1, MAX_STORAGE_VECTOR_LENGTH - newLength);
+        unsigned newVectorLength = max(newLength, m_vectorLength - length + newLength);
+        if (newVectorLength > MAX_STORAGE_VECTOR_LENGTH - newIndexBias)
+            newVectorLength = newLength;
+
+        void* newAllocation;
+        if (!tryFastMalloc(storageSize(newVectorLength + newIndexBias)).getValue(newAllocation))
+            return false;
+
+        ArrayStorage* newStorage = reinterpret_cast<ArrayStorage*>(static_cast<TiValue*>(newAllocation) + newIndexBias);
+        memcpy(newStorage, storage, storageSize(0));
+        memcpy(newStorage->m_vector + count, storage->m_vector, length * sizeof(TiValue));
+        for (unsigned i = newLength; i < newVectorLength; ++i)
+            newStorage->m_vector[i] = TiValue();
+
+        fastFree(storageAllocation(storage, m_indexBias));
+        Heap::heap(this)->reportExtraMemoryCost(storageSize(newVectorLength + newIndexBias) - storageSize(m_vectorLength + m_indexBias));
+
+        m_storage = newStorage;
+        m_indexBias = newIndexBias;
+        m_vectorLength = newVectorLength;
+    }
+
+    for (unsigned i = 0; i < count; ++i)
+        m_storage->m_vector[i] = TiValue();
+    m_storage->m_length = length + count;
+
+    return true;
+}
+
+bool TiArray::appendDenseValues(const TiValue* values, unsigned count)
+{
+    checkConsistency();
+
+    unsigned length = m_storage->m_length;
+    if (!isDense() || count > MAX_STORAGE_VECTOR_INDEX - length)
+        return false;
+    if (!count)
+        return true;
+
+    unsigned newLength = length + count;
+    if (newLength > m_vectorLength && !increaseVectorLength(newLength))
+        return false;
+
+    memcpy(m_storage->m_vector + length, values, count * sizeof(TiValue));
+    m_storage->m_length = newLength;
+    m_storage->m_numValuesInVector = newLength;
+
+    checkConsistency();
+    return true;
+}
+
+bool TiArray::spliceDense(unsigned begin, unsigned deleteCount, const TiValue* items, unsigned itemCount)
+{
+    checkConsistency();
+
+    unsigned length = m_storage->m_length;
+    if (!isDense() || begin > length || deleteCount > length - begin || itemCount > MAX_STORAGE_VECTOR_INDEX - length)
+        return false;
+
+    unsigned newLength = length - deleteCount + itemCount;
+    if (!begin && itemCount != deleteCount) {
+        if (itemCount < deleteCount)
+            shiftCount(deleteCount - itemCount);
+        else if (!unshiftCount(itemCount - deleteCount))
+            return false;
+    } else {
+        if (newLength > m_vectorLength && !increaseVectorLength(newLength))
+            return false;
+
+        TiValue* vector = m_storage->m_vector;
+        memmove(vector + begin + itemCount, vector + begin + deleteCount, (length - begin - deleteCount) * sizeof(TiValue));
+        for (unsigned i = newLength; i < length; ++i)
+            vector[i] = TiValue();
+    }
+
+    memcpy(m_storage->m_vector + begin, items, itemCount * sizeof(TiValue));
+    m_storage->m_length = newLength;
+    m_storage->m_numValuesInVector = newLength;
+
+    checkConsistency();
+    return true;
+}
+
 void TiArray::push(TiExcState* exec, TiValue value)
 {
     checkConsistency();
@@ -632,11 +800,106 @@ static int compareNumbersForQSort(const void* a, const void* b)
 
 typedef std::pair<TiValue, UString> ValueStringPair;
 
-static int compareByStringPairForQSort(const void* a, const void* b)
+// A value with the characters of its string, which a ValueStringPair keeps
+// alive, so that sorting moves neither TiValues nor UStrings' reference counts.
+struct StringSortKey {
+    const UChar* characters;
+    unsigned length;
+    TiValue value;
+};
+
+// Compares the strings from the character at offset on, for keys known to
+// share the characters before it.
+struct StringSortKeyLessThan {
+    StringSortKeyLessThan(unsigned offset)
+        : m_offset(offset)
+    {
+    }
+
+    bool operator()(const StringSortKey& a, const StringSortKey& b)
+    {
+        unsigned length = min(a.length, b.length);
+        for (unsigned i = m_offset; i < length; ++i) {
+            if (a.characters[i] != b.characters[i])
+                return a.characters[i] < b.characters[i];
+        }
+        return a.length < b.length;
+    }
+
+    unsigned m_offset;
+};
+
+struct StringSortRange {
+    size_t begin;
+    size_t count;
+    unsigned digit;
+};
+
+// Stable most significant digit radix sort, taking each UChar as two byte
+// digits, high byte first. A key that has run out of characters sorts
+// before every byte. Ranges too small to be worth distributing are sorted by
+// comparison instead. buffer must have room for count keys.
+static void radixSortStrings(StringSortKey* keys, StringSortKey* buffer, size_t count)
 {
-    const ValueStringPair* va = static_cast<const ValueStringPair*>(a);
-    const ValueStringPair* vb = static_cast<const ValueStringPair*>(b);
-    return compare(va->second, vb->second);
+    static const size_t comparisonSortCutoff = 32;
+    static const unsigned numBuckets = 257;
+
+    Vector<StringSortRange, 64> ranges;
+    StringSortRange whole = { 0, count, 0 };
+    ranges.append(whole);
+
+    size_t bucketSizes[numBuckets];
+    while (!ranges.isEmpty()) {
+        StringSortRange range = ranges.last();
+        ranges.removeLast();
+        StringSortKey* rangeKeys = keys + range.begin;
+        unsigned characterIndex = range.digit >> 1;
+        unsigned shift = range.digit & 1 ? 0 : 8;
+
+        if (range.count < comparisonSortCutoff) {
+            StringSortKeyLessThan lessThan(characterIndex);
+            timSort(rangeKeys, range.count, buffer, lessThan);
+            continue;
+        }
+
+        memset(bucketSizes, 0, sizeof(bucketSizes));
+        for (size_t i = 0; i < range.count; ++i) {
+            const StringSortKey& key = rangeKeys[i];
+            ++bucketSizes[characterIndex < key.length ? ((key.characters[characterIndex] >> shift) & 0xFF) + 1 : 0];
+        }
+
+        // All the keys have this digit in common; move on to the next one.
+        unsigned firstBucket = characterIndex < rangeKeys[0].length ? ((rangeKeys[0].characters[characterIndex] >> shift) & 0xFF) + 1 : 0;
+        if (bucketSizes[firstBucket] == range.count) {
+            if (firstBucket) {
+                StringSortRange next = { range.begin, range.count, range.digit + 1 };
+                ranges.append(next);
+            }
+            continue;
+        }
+
+        size_t bucketStarts[numBuckets];
+        size_t start = 0;
+        for (unsigned bucket = 0; bucket < numBuckets; ++bucket) {
+            bucketStarts[bucket] = start;
+            start += bucketSizes[bucket];
+        }
+        for (size_t i = 0; i < range.count; ++i) {
+            const StringSortKey& key = rangeKeys[i];
+            buffer[bucketStarts[characterIndex < key.length ? ((key.characters[characterIndex] >> shift) & 0xFF) + 1 : 0]++] = key;
+        }
+        memcpy(rangeKeys, buffer, range.count * sizeof(StringSortKey));
+
+        // Keys that ran out of characters are equal, and already in their original order.
+        start = bucketSizes[0];
+        for (unsigned bucket = 1; bucket < numBuckets; ++bucket) {
+            if (bucketSizes[bucket] > 1) {
+                StringSortRange next = { range.begin + start, bucketSizes[bucket], range.digit + 1 };
+                ranges.append(next);
+            }
+            start += bucketSizes[bucket];
+        }
+    }
 }
 
 void TiArray::sortNumeric(TiExcState* exec, TiValue compareFunction, CallType callType, const CallData& callData)
@@ -710,42 +973,32 @@ void TiArray::sort(TiExcState* exec)
     if (exec->hadException())
         return;
 
-    // FIXME: Since we sort by string value, a fast algorithm might be to use a radix sort. That would be O(N) rather
-    // than O(N log N).
-
-#if HAVE(MERGESORT)
-    mergesort(values.begin(), values.size(), sizeof(ValueStringPair), compareByStringPairForQSort);
-#else
-    // FIXME: The qsort library function is likely to not be a stable sort.
     // ECMAScript-262 does not specify a stable sort, but in practice, browsers perform a stable sort.
-    qsort(values.begin(), values.size(), sizeof(ValueStringPair), compareByStringPairForQSort);
-#endif
+    Vector<StringSortKey> keys(lengthNotIncludingUndefined);
+    Vector<StringSortKey> buffer(lengthNotIncludingUndefined);
+    if (!keys.begin() || !buffer.begin()) {
+        throwOutOfMemoryError(exec);
+        return;
+    }
+
+    for (size_t i = 0; i < lengthNotIncludingUndefined; i++) {
+        keys[i].characters = values[i].second.data();
+        keys[i].length = values[i].second.size();
+        keys[i].value = values[i].first;
+    }
+
+    radixSortStrings(keys.begin(), buffer.begin(), lengthNotIncludingUndefined);
 
     // FIXME: If the toString function changed the length of the array, this might be
     // modifying the vector incorrectly.
 
     for (size_t i = 0; i < lengthNotIncludingUndefined; i++)
-        m_storage->m_vector[i] = values[i].first;
+        m_storage->m_vector[i] = keys[i].value;
 
     checkConsistency(SortConsistencyCheck);
 }
 
-struct AVLTreeNodeForArrayCompare {
-    TiValue value;
-
-    // Child pointers.  The high bit of gt is robbed and used as the
-    // balance factor sign.  The high bit of lt is robbed and used as
-    // the magnitude of the balance factor.
-    int32_t gt;
-    int32_t lt;
-};
-
-struct AVLTreeAbstractorForArrayCompare {
-    typedef int32_t handle; // Handle is an index into m_nodes vector.
-    typedef TiValue key;
-    typedef int32_t size;
-
-    Vector<AVLTreeNodeForArrayCompare> m_nodes;
+struct CompareFunctionLessThan {
     TiExcState* m_exec;
     TiValue m_compareFunction;
     CallType m_compareCallType;
@@ -753,39 +1006,13 @@ struct AVLTreeAbstractorForArrayCompare {
     TiValue m_globalThisValue;
     OwnPtr<CachedCall> m_cachedCall;
 
-    handle get_less(handle h) { return m_nodes[h].lt & 0x7FFFFFFF; }
-    void set_less(handle h, handle lh) { m_nodes[h].lt &= 0x80000000; m_nodes[h].lt |= lh; }
-    handle get_greater(handle h) { return m_nodes[h].gt & 0x7FFFFFFF; }
-    void set_greater(handle h, handle gh) { m_nodes[h].gt &= 0x80000000; m_nodes[h].gt |= gh; }
-
-    int get_balance_factor(handle h)
-    {
-        if (m_nodes[h].gt & 0x80000000)
-            return -1;
-        return static_cast<unsigned>(m_nodes[h].lt) >> 31;
-    }
-
-    void set_balance_factor(handle h, int bf)
-    {
-        if (bf == 0) {
-            m_nodes[h].lt &= 0x7FFFFFFF;
-            m_nodes[h].gt &= 0x7FFFFFFF;
-        } else {
-            m_nodes[h].lt |= 0x80000000;
-            if (bf < 0)
-                m_nodes[h].gt |= 0x80000000;
-            else
-                m_nodes[h].gt &= 0x7FFFFFFF;
-        }
-    }
-
-    int compare_key_key(key va, key vb)
+    bool operator()(TiValue va, TiValue vb)
     {
         ASSERT(!va.isUndefined());
         ASSERT(!vb.isUndefined());
 
         if (m_exec->hadException())
-            return 1;
+            return false;
 
         double compareResult;
         if (m_cachedCall) {
@@ -799,13 +1026,8 @@ struct AVLTreeAbstractorForArrayCompare {
             arguments.append(vb);
             compareResult = call(m_exec, m_compareFunction, m_compareCallType, *m_compareCallData, m_globalThisValue, arguments).toNumber(m_exec);
         }
-        return (compareResult < 0) ? -1 : 1; // Not passing equality through, because we need to store all values, even if equivalent.
+        return compareResult < 0;
     }
-
-    int compare_key_node(key k, handle h) { return compare_key_key(k, m_nodes[h].value); }
-    int compare_node_node(handle h1, handle h2) { return compare_key_key(m_nodes[h1].value, m_nodes[h2].value); }
-
-    static handle null() { return 0x7FFFFFFF; }
 };
 
 void TiArray::sort(TiExcState* exec, TiValue compareFunction, CallType callType, const CallData& callData)
@@ -814,105 +1036,83 @@ void TiArray::sort(TiExcState* exec, TiValue compareFunction, CallType callType,
 
     // FIXME: This ignores exceptions raised in the compare function or in toNumber.
 
-    // The maximum tree depth is compiled in - but the caller is clearly up to no good
-    // if a larger array is passed.
-    ASSERT(m_storage->m_length <= static_cast<unsigned>(std::numeric_limits<int>::max()));
-    if (m_storage->m_length > static_cast<unsigned>(std::numeric_limits<int>::max()))
-        return;
-
     if (!m_storage->m_length)
         return;
 
     unsigned usedVectorLength = min(m_storage->m_length, m_vectorLength);
 
-    AVLTree<AVLTreeAbstractorForArrayCompare, 44> tree; // Depth 44 is enough for 2^31 items
-    tree.abstractor().m_exec = exec;
-    tree.abstractor().m_compareFunction = compareFunction;
-    tree.abstractor().m_compareCallType = callType;
-    tree.abstractor().m_compareCallData = &callData;
-    tree.abstractor().m_globalThisValue = exec->globalThisValue();
-    tree.abstractor().m_nodes.resize(usedVectorLength + (m_storage->m_sparseValueMap ? m_storage->m_sparseValueMap->size() : 0));
-
-    if (callType == CallTypeJS)
-        tree.abstractor().m_cachedCall.set(new CachedCall(exec, asFunction(compareFunction), 2, exec->exceptionSlot()));
-
-    if (!tree.abstractor().m_nodes.begin()) {
-        throwOutOfMemoryError(exec);
-        return;
-    }
-
-    // FIXME: If the compare function modifies the array, the vector, map, etc. could be modified
-    // right out from under us while we're building the tree here.
-
-    unsigned numDefined = 0;
+    // The values are sorted in MarkedArgumentBuffers, so they stay marked even if
+    // the compare function takes them out of the array.
+    MarkedArgumentBuffer values;
     unsigned numUndefined = 0;
 
-    // Iterate over the array, ignoring missing values, counting undefined ones, and inserting all other ones into the tree.
-    for (; numDefined < usedVectorLength; ++numDefined) {
-        TiValue v = m_storage->m_vector[numDefined];
-        if (!v || v.isUndefined())
-            break;
-        tree.abstractor().m_nodes[numDefined].value = v;
-        tree.insert(numDefined);
-    }
-    for (unsigned i = numDefined; i < usedVectorLength; ++i) {
+    for (unsigned i = 0; i < usedVectorLength; ++i) {
         TiValue v = m_storage->m_vector[i];
-        if (v) {
-            if (v.isUndefined())
+        if (!v)
+            continue;
+        if (v.isUndefined())
+            ++numUndefined;
+        else
+            values.append(v);
+    }
+    if (SparseArrayValueMap* map = m_storage->m_sparseValueMap) {
+        SparseArrayValueMap::iterator end = map->end();
+        for (SparseArrayValueMap::iterator it = map->begin(); it != end; ++it) {
+            if (it->second.isUndefined())
                 ++numUndefined;
-            else {
-                tree.abstractor().m_nodes[numDefined].value = v;
-                tree.insert(numDefined);
-                ++numDefined;
-            }
+            else
+                values.append(it->second);
         }
     }
 
-    unsigned newUsedVectorLength = numDefined + numUndefined;
+    unsigned numDefined = values.size();
+    MarkedArgumentBuffer buffer;
+    for (unsigned i = 0; i < numDefined / 2; ++i)
+        buffer.append(jsUndefined());
+
+    CompareFunctionLessThan lessThan;
+    lessThan.m_exec = exec;
+    lessThan.m_compareFunction = compareFunction;
+    lessThan.m_compareCallType = callType;
+    lessThan.m_compareCallData = &callData;
+    lessThan.m_globalThisValue = exec->globalThisValue();
+    if (callType == CallTypeJS)
+        lessThan.m_cachedCall.set(new CachedCall(exec, asFunction(compareFunction), 2, exec->exceptionSlot()));
 
-    if (SparseArrayValueMap* map = m_storage->m_sparseValueMap) {
-        newUsedVectorLength += map->size();
-        if (newUsedVectorLength > m_vectorLength) {
-            // Check that it is possible to allocate an array large enough to hold all the entries.
-            if ((newUsedVectorLength > MAX_STORAGE_VECTOR_LENGTH) || !increaseVectorLength(newUsedVectorLength)) {
-                throwOutOfMemoryError(exec);
-                return;
-            }
-        }
+    TiValue* sortedValues = reinterpret_cast<TiValue*>(values.begin());
+    timSort(sortedValues, numDefined, reinterpret_cast<TiValue*>(buffer.begin()), lessThan);
 
-        SparseArrayValueMap::iterator end = map->end();
-        for (SparseArrayValueMap::iterator it = map->begin(); it != end; ++it) {
-            tree.abstractor().m_nodes[numDefined].value = it->second;
-            tree.insert(numDefined);
-            ++numDefined;
+    // FIXME: If the compare function changed the array, the following overwrites its changes.
+    // It stays within the current vector, though, which the compare function may have moved.
+
+    unsigned newUsedVectorLength = numDefined + numUndefined;
+    if (newUsedVectorLength > m_vectorLength) {
+        // Check that it is possible to allocate an array large enough to hold all the entries.
+        if ((newUsedVectorLength > MAX_STORAGE_VECTOR_LENGTH) || !increaseVectorLength(newUsedVectorLength)) {
+            throwOutOfMemoryError(exec);
+            return;
         }
+    }
 
+    if (SparseArrayValueMap* map = m_storage->m_sparseValueMap) {
         delete map;
         m_storage->m_sparseValueMap = 0;
     }
 
-    ASSERT(tree.abstractor().m_nodes.size() >= numDefined);
-
-    // FIXME: If the compare function changed the length of the array, the following might be
-    // modifying the vector incorrectly.
-
-    // Copy the values back into m_storage.
-    AVLTree<AVLTreeAbstractorForArrayCompare, 44>::Iterator iter;
-    iter.start_iter_least(tree);
-    for (unsigned i = 0; i < numDefined; ++i) {
-        m_storage->m_vector[i] = tree.abstractor().m_nodes[*iter].value;
-        ++iter;
-    }
-
-    // Put undefined values back in.
+    // Copy the values back into m_storage, with the undefined values after them.
+    for (unsigned i = 0; i < numDefined; ++i)
+        m_storage->m_vector[i] = sortedValues[i];
     for (unsigned i = numDefined; i < newUsedVectorLength; ++i)
         m_storage->m_vector[i] = jsUndefined();
 
     // Ensure that unused values in the vector are zeroed out.
-    for (unsigned i = newUsedVectorLength; i < usedVectorLength; ++i)
+    unsigned currentUsedVectorLength = min(max(usedVectorLength, m_storage->m_length), m_vectorLength);
+    for (unsigned i = newUsedVectorLength; i < currentUsedVectorLength; ++i)
         m_storage->m_vector[i] = TiValue();
 
     m_storage->m_numValuesInVector = newUsedVectorLength;
+    if (m_storage->m_length < newUsedVectorLength)
+        m_storage->m_length = newUsedVectorLength;
 
     checkConsistency(SortConsistencyCheck);
 }
@@ -69,6 +69,21 @@ namespace TI {
         void push(TiExcState*, TiValue);
         TiValue pop();
 
+        // Fast paths for the Array.prototype functions on dense arrays, whose
+        // values are all in the vector with no holes. They return false, doing
+        // nothing, for other arrays. unshiftCount leaves holes at the front for
+        // the caller to fill.
+        bool isDense() const { return m_storage->m_length <= m_vectorLength && m_storage->m_numValuesInVector == m_storage->m_length; }
+        TiValue* denseValues()
+        {
+            ASSERT(isDense());
+            return m_storage->m_vector;
+        }
+        bool shiftCount(unsigned count);
+        bool unshiftCount(unsigned count);
+        bool appendDenseValues(const TiValue*, unsigned count);
+        bool spliceDense(unsigned begin, unsigned deleteCount, const TiValue* items, unsigned itemCount);
+
         bool canGetIndex(unsigned i) { return i < m_vectorLength && m_storage->m_vector[i]; }
         TiValue getIndex(unsigned i)
         {
@@ -76,6 +91,17 @@ namespace TI {
             return m_storage->m_vector[i];
         }
 
+        // The value stored for an index, or an empty value for a hole. Unlike
+        // get, this never looks at properties or runs getters.
+        TiValue storedValue(unsigned i)
+        {
+            if (i < m_vectorLength)
+                return m_storage->m_vector[i];
+            if (SparseArrayValueMap* map = m_storage->m_sparseValueMap)
+                return map->get(i);
+            return TiValue();
+        }
+
         bool canSetIndex(unsigned i) { return i < m_vectorLength; }
         void setIndex(unsigned i, TiValue v)
         {
@@ -124,6 +150,9 @@ namespace TI {
         void checkConsistency(ConsistencyCheckType = NormalConsistencyCheck);
 
         unsigned m_vectorLength;
+        // The number of values the storage allocation has before m_storage,
+        // left by shiftCount for unshiftCount to reuse.
+        unsigned m_indexBias;
         ArrayStorage* m_storage;
     };
 
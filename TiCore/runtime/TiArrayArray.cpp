@@ -50,6 +50,14 @@ TiArrayArray::TiArrayArray(TiExcState* exec, NonNullPassRefPtr<Structure> struct
     putDirect(exec->globalData().propertyNames->length, jsNumber(exec, m_storage->length()), ReadOnly | DontDelete);
 }
     
+PassRefPtr<ByteArray> TiArrayArray::transferStorage(TiExcState* exec)
+{
+    RefPtr<ByteArray> storage = m_storage.release();
+    m_storage = ByteArray::create(0);
+    putDirect(exec->globalData().propertyNames->length, jsNumber(exec, 0), ReadOnly | DontDelete);
+    return storage.release();
+}
+
 PassRefPtr<Structure> TiArrayArray::createStructure(TiValue prototype)
 {
     PassRefPtr<Structure> result = Structure::create(prototype, TypeInfo(ObjectType, StructureFlags));
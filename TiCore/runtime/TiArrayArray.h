@@ -98,6 +98,9 @@ namespace TI {
 
         WTI::ByteArray* storage() const { return m_storage.get(); }
 
+        // Gives up the storage, leaving this byte array empty.
+        PassRefPtr<WTI::ByteArray> transferStorage(TiExcState*);
+
     protected:
         static const unsigned StructureFlags = OverridesGetOwnPropertySlot | OverridesGetPropertyNames | TiObject::StructureFlags;
 
@@ -39,6 +39,7 @@
 #include "ArgList.h"
 #include "Collector.h"
 #include "CommonIdentifiers.h"
+#include "Executable.h"
 #include "FunctionConstructor.h"
 #include "GetterSetter.h"
 #include "Interpreter.h"
@@ -111,9 +112,19 @@ VPtrSet::VPtrSet()
     fastFree(storage);
 }
 
+#if ENABLE(JIT)
+// Calls between JIT code are linked directly and bypass the executable, so
+// JIT code is only flushed once its callers are; that makes flushing much less
+// effective, so it is left for clients to turn on.
+static const unsigned defaultCodeFlushingAge = 0;
+#else
+static const unsigned defaultCodeFlushingAge = 8;
+#endif
+
 TiGlobalData::TiGlobalData(bool isShared, const VPtrSet& vptrSet)
     : isSharedInstance(isShared)
     , clientData(0)
+    , lockDropDepth(0)
     , arrayTable(fastNew<HashTable>(TI::arrayTable))
     , dateTable(fastNew<HashTable>(TI::dateTable))
     , jsonTable(fastNew<HashTable>(TI::jsonTable))
@@ -141,16 +152,23 @@ TiGlobalData::TiGlobalData(bool isShared, const VPtrSet& vptrSet)
     , identifierTable(createIdentifierTable())
     , propertyNames(new CommonIdentifiers(this))
     , emptyList(new MarkedArgumentBuffer)
+    , regExpCache(this)
+#if ENABLE(ASSEMBLER)
+    , executableAllocator(this)
+#endif
     , lexer(new Lexer(this))
     , parser(new Parser)
     , interpreter(new Interpreter)
 #if ENABLE(JIT)
     , jitStubs(this)
 #endif
+    , terminationRequested(0)
+    , resourceLimits(this)
     , heap(this)
     , initializingLazyNumericCompareFunction(false)
     , head(0)
     , dynamicGlobalObject(0)
+    , codeFlushingAge(defaultCodeFlushingAge)
     , functionCodeBlockBeingReparsed(0)
     , firstStringifierToMark(0)
     , markStack(vptrSet.jsArrayVPtr)
@@ -169,6 +187,18 @@ TiGlobalData::~TiGlobalData()
 {
     // By the time this is destroyed, heap.destroy() must already have been called.
 
+    // Cached eval code and regular expressions hold executable memory, which
+    // must be returned before the executable allocator is destroyed.
+    evalCodeCache.clear();
+    regExpCache.clear();
+
+    // An executable that outlives this TiGlobalData must not reach back into
+    // it, which it only does while it has code.
+    Vector<RefPtr<FunctionExecutable> > executablesWithCode;
+    copyToVector(functionExecutablesWithCode, executablesWithCode);
+    for (size_t i = 0; i < executablesWithCode.size(); ++i)
+        executablesWithCode[i]->discardCode();
+
     delete interpreter;
 #ifndef NDEBUG
     // Zeroing out to make the behavior more predictable when someone attempts to use a deleted instance.
@@ -268,6 +298,45 @@ void TiGlobalData::resetDateCache()
     dateInstanceCache.reset();
 }
 
+void TiGlobalData::flushColdCode()
+{
+    if (!codeFlushingAge)
+        return;
+
+    // Code can only be thrown away while nothing is executing; a CachedCall
+    // keeps a frame in the register file between calls, so check that too.
+    bool canFlush = !dynamicGlobalObject && !interpreter->registerFile().size();
+
+    Vector<RefPtr<FunctionExecutable> > coldExecutables;
+    HashSet<FunctionExecutable*>::iterator end = functionExecutablesWithCode.end();
+    for (HashSet<FunctionExecutable*>::iterator it = functionExecutablesWithCode.begin(); it != end; ++it) {
+        FunctionExecutable* executable = *it;
+        if (executable->incrementCodeAge() < codeFlushingAge || !canFlush)
+            continue;
+#if ENABLE(JIT)
+        // Linked calls do not reset the age, so code with linked callers is
+        // kept for as long as the calling code is.
+        if (executable->generatedBytecode().hasLinkedCallers())
+            continue;
+#endif
+        coldExecutables.append(executable);
+    }
+
+    // Discarding a CodeBlock releases the executables of its nested functions,
+    // which removes them from the set, so the set is not walked while flushing.
+    for (size_t i = 0; i < coldExecutables.size(); ++i)
+        coldExecutables[i]->discardCode();
+}
+
+CodeMemoryUsage TiGlobalData::codeMemoryUsage()
+{
+    CodeMemoryUsage usage;
+    HashSet<FunctionExecutable*>::iterator end = functionExecutablesWithCode.end();
+    for (HashSet<FunctionExecutable*>::iterator it = functionExecutablesWithCode.begin(); it != end; ++it)
+        usage.add((*it)->memoryUsage());
+    return usage;
+}
+
 void TiGlobalData::startSampling()
 {
     interpreter->startSampling();
@@ -38,11 +38,14 @@
 
 #include "Collector.h"
 #include "DateInstanceCache.h"
+#include "EvalCodeCache.h"
 #include "ExecutableAllocator.h"
 #include "JITStubs.h"
 #include "TiValue.h"
 #include "MarkStack.h"
 #include "NumericStrings.h"
+#include "RegExpCache.h"
+#include "ResourceLimits.h"
 #include "SmallStrings.h"
 #include "TimeoutChecker.h"
 #include "WeakRandom.h"
@@ -58,6 +61,7 @@ namespace TI {
     class CodeBlock;
     class CommonIdentifiers;
     class IdentifierTable;
+    class FunctionExecutable;
     class Interpreter;
     class TiGlobalObject;
     class TiObject;
@@ -67,28 +71,30 @@ namespace TI {
     class Structure;
     class UString;
 
+    struct CodeMemoryUsage;
     struct HashTable;
     struct Instruction;    
     struct VPtrSet;
 
+    // Intervals of time, sorted and disjoint, over each of which the DST
+    // offset is known not to change. getDSTOffset answers from here when it
+    // can, and otherwise asks the OS and grows or adds an interval.
     struct DSTOffsetCache {
-        DSTOffsetCache()
-        {
-            reset();
-        }
-        
+        struct Interval {
+            double start;
+            double end;
+            double offset;
+        };
+
+        // Two intervals cover a year, so this spans decades of dates.
+        static const size_t maxIntervals = 64;
+
         void reset()
         {
-            offset = 0.0;
-            start = 0.0;
-            end = -1.0;
-            increment = 0.0;
+            intervals.clear();
         }
 
-        double offset;
-        double start;
-        double end;
-        double increment;
+        Vector<Interval, 8> intervals;
     };
 
     class TiGlobalData : public RefCounted<TiGlobalData> {
@@ -112,6 +118,9 @@ namespace TI {
         bool isSharedInstance;
         ClientData* clientData;
 
+        // Nesting of TiLock::DropAllLocks for this group's callbacks.
+        unsigned lockDropDepth;
+
         const HashTable* arrayTable;
         const HashTable* dateTable;
         const HashTable* jsonTable;
@@ -146,6 +155,8 @@ namespace TI {
         SmallStrings smallStrings;
         NumericStrings numericStrings;
         DateInstanceCache dateInstanceCache;
+        EvalCodeCache evalCodeCache;
+        RegExpCache regExpCache;
         
 #if ENABLE(ASSEMBLER)
         ExecutableAllocator executableAllocator;
@@ -158,6 +169,14 @@ namespace TI {
         JITThunks jitStubs;
 #endif
         TimeoutChecker timeoutChecker;
+
+        // Set from any thread, or from a signal handler, to make the script
+        // running in this group throw an uncatchable exception at its next
+        // loop back-edge or function entry. Cleared when the exception is
+        // thrown.
+        volatile int terminationRequested;
+        ResourceLimits resourceLimits;
+
         Heap heap;
 
         TiValue exception;
@@ -176,6 +195,12 @@ namespace TI {
 
         HashSet<TiObject*> arrayVisitedElements;
 
+        // Function code that has not run for codeFlushingAge garbage collections
+        // is discarded, to be regenerated the next time the function is called.
+        // Zero disables code flushing.
+        unsigned codeFlushingAge;
+        HashSet<FunctionExecutable*> functionExecutablesWithCode;
+
         CodeBlock* functionCodeBlockBeingReparsed;
         Stringifier* firstStringifierToMark;
 
@@ -195,6 +220,16 @@ namespace TI {
 
         void resetDateCache();
 
+        // Called by running script once it has seen terminationRequested set.
+        bool shouldTerminateExecution()
+        {
+            terminationRequested = 0;
+            return resourceLimits.shouldTerminate();
+        }
+
+        void flushColdCode();
+        CodeMemoryUsage codeMemoryUsage();
+
         void startSampling();
         void stopSampling();
         void dumpSampleData(TiExcState* exec);
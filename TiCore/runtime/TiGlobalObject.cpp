@@ -54,6 +54,7 @@
 #include "FunctionConstructor.h"
 #include "FunctionPrototype.h"
 #include "GlobalEvalFunction.h"
+#include "TiArrayArray.h"
 #include "TiFunction.h"
 #include "TiGlobalObjectFunctions.h"
 #include "TiLock.h"
@@ -119,6 +120,8 @@ TiGlobalObject::~TiGlobalObject()
     if (headObject == this)
         headObject = 0;
 
+    globalData()->evalCodeCache.removeEntriesForGlobalObject(this);
+
     HashSet<GlobalCodeBlock*>::const_iterator end = codeBlocks().end();
     for (HashSet<GlobalCodeBlock*>::const_iterator it = codeBlocks().begin(); it != end; ++it)
         (*it)->clearGlobalObject();
@@ -227,6 +230,7 @@ void TiGlobalObject::reset(TiValue prototype)
     d()->argumentsStructure = Arguments::createStructure(d()->objectPrototype);
     d()->callbackConstructorStructure = TiCallbackConstructor::createStructure(d()->objectPrototype);
     d()->callbackObjectStructure = TiCallbackObject<TiObject>::createStructure(d()->objectPrototype);
+    d()->byteArrayStructure = TiArrayArray::createStructure(d()->objectPrototype);
 
     d()->arrayPrototype = new (exec) ArrayPrototype(ArrayPrototype::createStructure(d()->objectPrototype));
     d()->arrayStructure = TiArray::createStructure(d()->arrayPrototype);
@@ -371,6 +375,7 @@ void TiGlobalObject::markChildren(MarkStack& markStack)
     HashSet<GlobalCodeBlock*>::const_iterator end = codeBlocks().end();
     for (HashSet<GlobalCodeBlock*>::const_iterator it = codeBlocks().begin(); it != end; ++it)
         (*it)->markAggregate(markStack);
+    globalData()->evalCodeCache.markFunctions(markStack, this);
 
     RegisterFile& registerFile = globalData()->interpreter->registerFile();
     if (registerFile.globalObject() == this)
@@ -61,6 +61,8 @@ namespace TI {
     typedef Vector<TiExcState*, 16> TiExcStateStack;
     
     class TiGlobalObject : public JSVariableObject {
+        friend class TiGlobalObjectSnapshotReader;
+        friend class TiGlobalObjectSnapshotWriter;
     protected:
         using JSVariableObject::JSVariableObjectData;
 
@@ -141,6 +143,7 @@ namespace TI {
             RefPtr<Structure> argumentsStructure;
             RefPtr<Structure> arrayStructure;
             RefPtr<Structure> booleanObjectStructure;
+            RefPtr<Structure> byteArrayStructure;
             RefPtr<Structure> callbackConstructorStructure;
             RefPtr<Structure> callbackFunctionStructure;
             RefPtr<Structure> callbackObjectStructure;
@@ -225,6 +228,7 @@ namespace TI {
         Structure* argumentsStructure() const { return d()->argumentsStructure.get(); }
         Structure* arrayStructure() const { return d()->arrayStructure.get(); }
         Structure* booleanObjectStructure() const { return d()->booleanObjectStructure.get(); }
+        Structure* byteArrayStructure() const { return d()->byteArrayStructure.get(); }
         Structure* callbackConstructorStructure() const { return d()->callbackConstructorStructure.get(); }
         Structure* callbackFunctionStructure() const { return d()->callbackFunctionStructure.get(); }
         Structure* callbackObjectStructure() const { return d()->callbackObjectStructure.get(); }
@@ -455,17 +459,24 @@ namespace TI {
                 // Reset the date cache between JS invocations to force the VM
                 // to observe time zone changes.
                 callFrame->globalData().resetDateCache();
-            }
+
+                m_resourceLimits = &callFrame->globalData().resourceLimits;
+                m_resourceLimits->didEnterScript();
+            } else
+                m_resourceLimits = 0;
         }
 
         ~DynamicGlobalObjectScope()
         {
             m_dynamicGlobalObjectSlot = m_savedDynamicGlobalObject;
+            if (m_resourceLimits)
+                m_resourceLimits->didExitScript();
         }
 
     private:
         TiGlobalObject*& m_dynamicGlobalObjectSlot;
         TiGlobalObject* m_savedDynamicGlobalObject;
+        ResourceLimits* m_resourceLimits;
     };
 
 } // namespace TI
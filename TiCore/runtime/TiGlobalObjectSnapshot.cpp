@@ -0,0 +1,1422 @@
+/**
+ * Appcelerator Titanium License
+ * This source code and all modifications done by Appcelerator
+ * are licensed under the Apache Public License (version 2) and
+ * are Copyright (c) 2009 by Appcelerator, Inc.
+ */
+
+/*
+ * Copyright (C) 2009 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1.  Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ * 2.  Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ * 3.  Neither the name of Apple Computer, Inc. ("Apple") nor the names of
+ *     its contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE AND ITS CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL APPLE OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "TiGlobalObjectSnapshot.h"
+
+#include "ArrayPrototype.h"
+#include "BooleanObject.h"
+#include "BooleanPrototype.h"
+#include "DateInstance.h"
+#include "DatePrototype.h"
+#include "ErrorConstructor.h"
+#include "ErrorInstance.h"
+#include "Executable.h"
+#include "FunctionPrototype.h"
+#include "GetterSetter.h"
+#include "GlobalEvalFunction.h"
+#include "JSActivation.h"
+#include "NativeErrorConstructor.h"
+#include "NumberObject.h"
+#include "NumberPrototype.h"
+#include "ObjectPrototype.h"
+#include "PropertyNameArray.h"
+#include "PrototypeFunction.h"
+#include "RegExpConstructor.h"
+#include "RegExpObject.h"
+#include "RegExpPrototype.h"
+#include "SourceProvider.h"
+#include "StringObject.h"
+#include "StringPrototype.h"
+#include "TiArray.h"
+#include "TiCallbackFunction.h"
+#include "TiCallbackObject.h"
+#include "TiFunction.h"
+#include "TiGlobalObject.h"
+#include "TiStaticScopeObject.h"
+#include <wtf/StdLibExtras.h>
+
+namespace TI {
+
+// Increment whenever the format changes.
+static const unsigned snapshotVersion = 1;
+static const char snapshotMagic[4] = { 'T', 'i', 'S', 'n' };
+
+static const unsigned nullStringLength = 0xFFFFFFFF;
+
+// Records are read in the order they are written, and each refers only to
+// sources, executables, objects and scope chains created by earlier records.
+// Each kind is numbered in order of creation, from 0, except scope chains,
+// which are numbered from 1, 0 being the global object's. Identifiers are
+// written once, as names, and referred to by number.
+enum SnapshotRecordType {
+    EndRecord,
+    NameRecord,
+    SourceRecord,
+    ExecutableRecord,
+    BuiltinRecord,
+    ObjectRecord,
+    ScopeChainRecord,
+    PrototypeRecord,
+    PropertyRecord,
+    AccessorRecord,
+    DeletedPropertyRecord,
+    ElementRecord,
+    LengthRecord,
+    VariableRecord,
+    GlobalsRecord
+};
+
+enum SnapshotBuiltinPath {
+    RootPath,
+    GlobalVariablePath,
+    PropertyPath
+};
+
+enum SnapshotObjectType {
+    PlainObject,
+    ArrayObject,
+    FunctionObject,
+    ActivationObject,
+    StaticScopeObject,
+    BooleanWrapperObject,
+    NumberWrapperObject,
+    StringWrapperObject,
+    DateObject,
+    RegExpObjectType,
+    ErrorObject,
+    // Native references.
+    HostFunctionObject,
+    InternalHostFunctionObject,
+    CallbackFunctionObject,
+    CallbackObjectObject
+};
+
+enum SnapshotValueType {
+    EmptyValue,
+    UndefinedValue,
+    NullValue,
+    FalseValue,
+    TrueValue,
+    NumberValue,
+    StringValue,
+    ObjectValue
+};
+
+// The built-in objects that are not found under a name in the global object
+// or another built-in object.
+static TiObject* rootObject(TiGlobalObject* globalObject, unsigned index)
+{
+    switch (index) {
+    case 0:
+        return globalObject;
+    case 1:
+        return globalObject->globalExec()->globalThisValue();
+    case 2:
+        return globalObject->prototype().isObject() ? asObject(globalObject->prototype()) : 0;
+    case 3:
+        return globalObject->objectPrototype();
+    case 4:
+        return globalObject->functionPrototype();
+    case 5:
+        return globalObject->arrayPrototype();
+    case 6:
+        return globalObject->booleanPrototype();
+    case 7:
+        return globalObject->stringPrototype();
+    case 8:
+        return globalObject->numberPrototype();
+    case 9:
+        return globalObject->datePrototype();
+    case 10:
+        return globalObject->regExpPrototype();
+    case 11:
+        return globalObject->regExpConstructor();
+    case 12:
+        return globalObject->errorConstructor();
+    case 13:
+        return globalObject->evalErrorConstructor();
+    case 14:
+        return globalObject->rangeErrorConstructor();
+    case 15:
+        return globalObject->referenceErrorConstructor();
+    case 16:
+        return globalObject->syntaxErrorConstructor();
+    case 17:
+        return globalObject->typeErrorConstructor();
+    case 18:
+        return globalObject->URIErrorConstructor();
+    case 19:
+        return globalObject->evalFunction();
+    }
+    return 0;
+}
+
+static const unsigned rootObjectCount = 20;
+
+TiGlobalObjectSnapshotWriter::TiGlobalObjectSnapshotWriter(TiGlobalObject* globalObject, TiGlobalObject* pristineGlobalObject, bool allowNativeReferences)
+    : m_exec(globalObject->globalExec())
+    , m_pristineExec(pristineGlobalObject->globalExec())
+    , m_globalObject(globalObject)
+    , m_pristineGlobalObject(pristineGlobalObject)
+    , m_allowNativeReferences(allowNativeReferences)
+    , m_unsupportedObject(0)
+    , m_snapshot(0)
+{
+    ASSERT(globalObject->globalData() == pristineGlobalObject->globalData());
+}
+
+TiGlobalObjectSnapshotWriter::~TiGlobalObjectSnapshotWriter()
+{
+}
+
+bool TiGlobalObjectSnapshotWriter::write(Vector<char>& snapshot)
+{
+    m_snapshot = &snapshot;
+    m_snapshot->append(snapshotMagic, sizeof(snapshotMagic));
+    writeUInt32(snapshotVersion);
+    writeUInt8(m_allowNativeReferences);
+
+    matchBuiltins();
+
+    for (size_t i = 0; i < m_builtins.size() && !m_unsupportedObject; ++i) {
+        // Objects shared by the whole group, such as the prototypes of API
+        // classes, are left as they are.
+        if (m_builtins[i].first == m_builtins[i].second)
+            continue;
+        writePrototype(m_builtins[i].first);
+        writeProperties(m_builtins[i].first, m_builtins[i].second);
+    }
+
+    if (!m_unsupportedObject)
+        writeGlobals();
+
+    while (!m_pendingObjects.isEmpty() && !m_unsupportedObject) {
+        TiObject* object = m_pendingObjects.last();
+        m_pendingObjects.removeLast();
+        // Plain objects are created with their prototype.
+        if (object->classInfo() || object->isVariableObject())
+            writePrototype(object);
+        writeElements(object);
+        writeProperties(object, 0);
+        writeVariables(object);
+    }
+
+    writeUInt8(EndRecord);
+    return !m_unsupportedObject;
+}
+
+bool TiGlobalObjectSnapshotWriter::addBuiltin(TiObject* object, TiObject* pristine)
+{
+    if (m_objects.contains(object) || m_pristineBuiltins.contains(pristine))
+        return false;
+    m_objects.set(object, m_objects.size());
+    m_pristineBuiltins.add(pristine);
+    m_builtins.append(std::make_pair(object, pristine));
+
+    // The class name lets the reader check that it found the same object.
+    writeUInt8(BuiltinRecord);
+    writeString(object->className());
+    return true;
+}
+
+static bool isSameBuiltin(TiObject* object, TiObject* pristine)
+{
+    if (object->classInfo() != pristine->classInfo())
+        return false;
+
+    // Scripts can not create host functions, but they can move them around,
+    // so host functions only match when they run the same native code.
+    CallData callData;
+    CallData pristineCallData;
+    CallType callType = object->getCallData(callData);
+    if (callType != pristine->getCallData(pristineCallData))
+        return false;
+    if (callType == CallTypeJS)
+        return false;
+    return callType != CallTypeHost || callData.native.function == pristineCallData.native.function;
+}
+
+void TiGlobalObjectSnapshotWriter::matchBuiltins()
+{
+    for (unsigned i = 0; i < rootObjectCount; ++i) {
+        TiObject* object = rootObject(m_globalObject, i);
+        TiObject* pristine = rootObject(m_pristineGlobalObject, i);
+        if (object && pristine && addBuiltin(object, pristine)) {
+            writeUInt8(RootPath);
+            writeUInt32(i);
+        }
+    }
+
+    // The rest of the built-in objects, such as Math and the functions of the
+    // prototypes, are found under the same names in both global objects.
+    // Looking them up in the pristine global object creates any that are made
+    // lazily, as the reader's lookups will.
+    SymbolTable::iterator end = m_globalObject->symbolTable().end();
+    for (SymbolTable::iterator it = m_globalObject->symbolTable().begin(); it != end; ++it) {
+        TiValue value = m_globalObject->registerAt(it->second.getIndex()).jsValue();
+        SymbolTableEntry entry = m_pristineGlobalObject->symbolTable().get(it->first.get());
+        if (entry.isNull() || !value || !value.isObject())
+            continue;
+        TiValue builtin = m_pristineGlobalObject->registerAt(entry.getIndex()).jsValue();
+        if (!builtin || !builtin.isObject() || !isSameBuiltin(asObject(value), asObject(builtin)))
+            continue;
+        unsigned name = addName(it->first.get());
+        if (addBuiltin(asObject(value), asObject(builtin))) {
+            writeUInt8(GlobalVariablePath);
+            writeUInt32(name);
+        }
+    }
+
+    for (size_t i = 0; i < m_builtins.size(); ++i) {
+        TiObject* object = m_builtins[i].first;
+        TiObject* pristine = m_builtins[i].second;
+
+        PropertyNameArray propertyNames(m_exec);
+        object->structure()->getAllPropertyNames(propertyNames);
+        PropertyNameArray::const_iterator end = propertyNames.end();
+        for (PropertyNameArray::const_iterator it = propertyNames.begin(); it != end; ++it) {
+            TiValue value = object->getDirect(*it);
+            if (!value.isObject())
+                continue;
+            PropertySlot slot;
+            if (!pristine->getOwnPropertySlot(m_pristineExec, *it, slot))
+                continue;
+            TiValue builtin = pristine->getDirect(*it);
+            if (!builtin || !builtin.isObject() || !isSameBuiltin(asObject(value), asObject(builtin)))
+                continue;
+            unsigned name = addName(it->ustring().rep());
+            if (addBuiltin(asObject(value), asObject(builtin))) {
+                writeUInt8(PropertyPath);
+                writeUInt32(m_objects.get(object));
+                writeUInt32(name);
+            }
+        }
+    }
+}
+
+void TiGlobalObjectSnapshotWriter::addValue(TiValue value)
+{
+    // Strings and numbers are written out in full wherever they are used, so
+    // only objects need records of their own.
+    if (!value || !value.isObject())
+        return;
+    TiObject* object = asObject(value);
+    if (!addObject(object) && !m_unsupportedObject)
+        m_unsupportedObject = object;
+}
+
+bool TiGlobalObjectSnapshotWriter::addObject(TiObject* object)
+{
+    if (m_objects.contains(object))
+        return true;
+    if (m_unsupportedObject || !writeObject(object))
+        return false;
+
+    // The object's properties are written later, so that deep structures do
+    // not recurse deeply.
+    m_objects.set(object, m_objects.size());
+    m_pendingObjects.append(object);
+    return true;
+}
+
+bool TiGlobalObjectSnapshotWriter::writeObject(TiObject* object)
+{
+    // Other global objects, from other contexts in the group, stay behind.
+    if (object->isGlobalObject())
+        return false;
+
+    TiValue prototype = object->prototype();
+    addValue(prototype);
+    if (m_unsupportedObject)
+        return false;
+
+    if (object->isVariableObject()) {
+        if (object->inherits(&JSActivation::info)) {
+            // The activation's variable layout is written with it, so that the
+            // reader need not compile its function.
+            JSActivation* activation = asActivation(object);
+            FunctionExecutable* functionExecutable = activation->functionExecutable();
+            unsigned executable = addExecutable(functionExecutable);
+            SymbolTable& symbolTable = activation->symbolTable();
+            Vector<unsigned> names;
+            SymbolTable::iterator end = symbolTable.end();
+            for (SymbolTable::iterator it = symbolTable.begin(); it != end; ++it)
+                names.append(addName(it->first.get()));
+
+            writeUInt8(ObjectRecord);
+            writeUInt8(ActivationObject);
+            writeUInt32(executable);
+            writeUInt32(functionExecutable->features());
+            writeUInt32(functionExecutable->variableCount());
+            writeUInt32(names.size());
+            size_t i = 0;
+            for (SymbolTable::iterator it = symbolTable.begin(); it != end; ++it, ++i) {
+                writeUInt32(names[i]);
+                writeUInt32(static_cast<unsigned>(it->second.getIndex()));
+                writeUInt32(it->second.getAttributes());
+            }
+            return true;
+        }
+
+        // The scope holding the name of a named function expression, or the
+        // exception in a catch block.
+        SymbolTable& symbolTable = static_cast<JSVariableObject*>(object)->symbolTable();
+        ASSERT(symbolTable.size() == 1);
+        SymbolTable::iterator it = symbolTable.begin();
+        unsigned name = addName(it->first.get());
+        writeUInt8(ObjectRecord);
+        writeUInt8(StaticScopeObject);
+        writeUInt32(name);
+        writeUInt32(it->second.getAttributes());
+        return true;
+    }
+
+    const ClassInfo* info = object->classInfo();
+    if (!info) {
+        writeUInt8(ObjectRecord);
+        writeUInt8(PlainObject);
+        writeValue(prototype);
+        return true;
+    }
+
+    TiGlobalData* globalData = &m_exec->globalData();
+
+    if (info == &TiArray::info) {
+        writeUInt8(ObjectRecord);
+        writeUInt8(ArrayObject);
+        return true;
+    }
+
+    if (info == &TiFunction::info) {
+        TiFunction* function = asFunction(object);
+        if (function->isHostFunction()) {
+            if (!m_allowNativeReferences)
+                return false;
+            NativeFunction nativeFunction = function->nativeFunction();
+            writeUInt8(ObjectRecord);
+            writeUInt8(HostFunctionObject);
+            writePointer(&nativeFunction, sizeof(nativeFunction));
+            writeString(function->name(globalData));
+            return true;
+        }
+
+        unsigned executable = addExecutable(function->jsExecutable());
+        unsigned scopeChain = addScopeChain(function->scope().node());
+        if (m_unsupportedObject)
+            return false;
+        writeUInt8(ObjectRecord);
+        writeUInt8(FunctionObject);
+        writeUInt32(executable);
+        writeUInt32(scopeChain);
+        return true;
+    }
+
+    if (info == &InternalFunction::info) {
+        // Other internal functions, such as the constructors, are built in.
+        CallData callData;
+        ConstructData constructData;
+        if (!m_allowNativeReferences || object->getCallData(callData) != CallTypeHost || object->getConstructData(constructData) != ConstructTypeNone)
+            return false;
+        writeUInt8(ObjectRecord);
+        writeUInt8(InternalHostFunctionObject);
+        writePointer(&callData.native.function, sizeof(callData.native.function));
+        writeString(static_cast<InternalFunction*>(object)->name(globalData));
+        return true;
+    }
+
+    if (info == &TiCallbackFunction::info) {
+        if (!m_allowNativeReferences)
+            return false;
+        TiCallbackFunction* function = static_cast<TiCallbackFunction*>(object);
+        TiObjectCallAsFunctionCallback callback = function->callback();
+        writeUInt8(ObjectRecord);
+        writeUInt8(CallbackFunctionObject);
+        writePointer(&callback, sizeof(callback));
+        writeString(function->name(globalData));
+        return true;
+    }
+
+    if (info == &TiCallbackObject<TiObject>::info) {
+        // Private data belongs to the embedder, and can not be shared.
+        TiCallbackObject<TiObject>* callbackObject = static_cast<TiCallbackObject<TiObject>*>(object);
+        if (!m_allowNativeReferences || callbackObject->getPrivate())
+            return false;
+        TiClassRef classRef = callbackObject->classRef();
+        writeUInt8(ObjectRecord);
+        writeUInt8(CallbackObjectObject);
+        writePointer(&classRef, sizeof(classRef));
+        return true;
+    }
+
+    if (info == &BooleanObject::info || info == &NumberObject::info) {
+        writeUInt8(ObjectRecord);
+        writeUInt8(info == &BooleanObject::info ? BooleanWrapperObject : NumberWrapperObject);
+        writeValue(static_cast<JSWrapperObject*>(object)->internalValue());
+        return true;
+    }
+
+    if (info == &StringObject::info) {
+        writeUInt8(ObjectRecord);
+        writeUInt8(StringWrapperObject);
+        writeString(asStringObject(object)->internalValue()->value());
+        return true;
+    }
+
+    if (info == &DateInstance::info) {
+        writeUInt8(ObjectRecord);
+        writeUInt8(DateObject);
+        writeValue(asDateInstance(object)->internalValue());
+        return true;
+    }
+
+    if (info == &RegExpObject::info) {
+        RegExpObject* regExpObject = asRegExpObject(object);
+        writeUInt8(ObjectRecord);
+        writeUInt8(RegExpObjectType);
+        writeString(regExpObject->regExp()->pattern());
+        writeString(regExpObject->regExp()->flags());
+        writeDouble(regExpObject->lastIndex());
+        return true;
+    }
+
+    if (info == &ErrorInstance::info) {
+        writeUInt8(ObjectRecord);
+        writeUInt8(ErrorObject);
+        return true;
+    }
+
+    return false;
+}
+
+unsigned TiGlobalObjectSnapshotWriter::addScopeChain(ScopeChainNode* node)
+{
+    Vector<ScopeChainNode*, 8> nodes;
+    unsigned scopeChain;
+    for (;; node = node->next) {
+        if (!node->next) {
+            if (node->object != m_globalObject) {
+                m_unsupportedObject = node->object;
+                return 0;
+            }
+            scopeChain = 0;
+            break;
+        }
+        HashMap<ScopeChainNode*, unsigned>::iterator it = m_scopeChains.find(node);
+        if (it != m_scopeChains.end()) {
+            scopeChain = it->second;
+            break;
+        }
+        nodes.append(node);
+    }
+
+    for (size_t i = nodes.size(); i-- > 0; ) {
+        if (!addObject(nodes[i]->object)) {
+            if (!m_unsupportedObject)
+                m_unsupportedObject = nodes[i]->object;
+            return 0;
+        }
+        writeUInt8(ScopeChainRecord);
+        writeObjectReference(nodes[i]->object);
+        writeUInt32(scopeChain);
+        scopeChain = m_scopeChains.size() + 1;
+        m_scopeChains.set(nodes[i], scopeChain);
+    }
+    return scopeChain;
+}
+
+unsigned TiGlobalObjectSnapshotWriter::addExecutable(FunctionExecutable* executable)
+{
+    HashMap<FunctionExecutable*, unsigned>::iterator it = m_executables.find(executable);
+    if (it != m_executables.end())
+        return it->second;
+
+    const SourceCode& source = executable->source();
+    unsigned sourceProvider = addSource(source.provider());
+    unsigned name = addName(executable->name().ustring().rep());
+    FunctionParameters& parameters = executable->parameters();
+    Vector<unsigned, 8> parameterNames;
+    for (size_t i = 0; i < parameters.size(); ++i)
+        parameterNames.append(addName(parameters[i].ustring().rep()));
+
+    writeUInt8(ExecutableRecord);
+    writeUInt32(sourceProvider);
+    writeUInt32(source.startOffset());
+    writeUInt32(source.endOffset());
+    writeUInt32(source.firstLine());
+    writeUInt32(executable->lineNo());
+    writeUInt32(executable->lastLine());
+    writeUInt32(name);
+    writeUInt8(executable->forceUsesArguments());
+    writeUInt32(parameterNames.size());
+    for (size_t i = 0; i < parameterNames.size(); ++i)
+        writeUInt32(parameterNames[i]);
+
+    unsigned id = m_executables.size();
+    m_executables.set(executable, id);
+    return id;
+}
+
+unsigned TiGlobalObjectSnapshotWriter::addSource(SourceProvider* sourceProvider)
+{
+    // Functions keep all of the script they were defined in, which lets the
+    // functions of one script share it.
+    HashMap<SourceProvider*, unsigned>::iterator it = m_sources.find(sourceProvider);
+    if (it != m_sources.end())
+        return it->second;
+
+    writeUInt8(SourceRecord);
+    writeString(sourceProvider->url());
+    writeString(sourceProvider->data(), static_cast<unsigned>(sourceProvider->length()));
+
+    unsigned id = m_sources.size();
+    m_sources.set(sourceProvider, id);
+    return id;
+}
+
+unsigned TiGlobalObjectSnapshotWriter::addName(UString::Rep* name)
+{
+    std::pair<HashMap<RefPtr<UString::Rep>, unsigned>::iterator, bool> result = m_names.add(name, m_names.size());
+    if (result.second) {
+        writeUInt8(NameRecord);
+        writeString(UString(name));
+    }
+    return result.first->second;
+}
+
+void TiGlobalObjectSnapshotWriter::writePrototype(TiObject* object)
+{
+    TiValue prototype = object->prototype();
+    addValue(prototype);
+    if (m_unsupportedObject)
+        return;
+    writeUInt8(PrototypeRecord);
+    writeObjectReference(object);
+    writeValue(prototype);
+}
+
+void TiGlobalObjectSnapshotWriter::writeElements(TiObject* object)
+{
+    if (!object->inherits(&TiArray::info))
+        return;
+
+    // Enumerating a regular expression match array fills it in. Elements
+    // are read from the array's storage, so that no getter runs while the
+    // snapshot is written; indices held as properties are written with the
+    // other properties.
+    PropertyNameArray propertyNames(m_exec);
+    object->getOwnPropertyNames(m_exec, propertyNames);
+    PropertyNameArray::const_iterator end = propertyNames.end();
+    for (PropertyNameArray::const_iterator it = propertyNames.begin(); it != end; ++it) {
+        bool isArrayIndex;
+        unsigned index = it->toArrayIndex(&isArrayIndex);
+        if (!isArrayIndex)
+            continue;
+        TiValue value = asArray(object)->storedValue(index);
+        if (!value)
+            continue;
+        addValue(value);
+        if (m_unsupportedObject)
+            return;
+        writeUInt8(ElementRecord);
+        writeObjectReference(object);
+        writeUInt32(index);
+        writeValue(value);
+    }
+
+    writeUInt8(LengthRecord);
+    writeObjectReference(object);
+    writeUInt32(asArray(object)->length());
+}
+
+void TiGlobalObjectSnapshotWriter::writeProperties(TiObject* object, TiObject* pristine)
+{
+    PropertyNameArray propertyNames(m_exec);
+    object->structure()->getAllPropertyNames(propertyNames);
+    PropertyNameArray::const_iterator end = propertyNames.end();
+    for (PropertyNameArray::const_iterator it = propertyNames.begin(); it != end; ++it) {
+        unsigned attributes;
+        TiCell* specificValue;
+        object->structure()->get(*it, attributes, specificValue);
+        TiValue value = object->getDirect(*it);
+
+        if (value.isGetterSetter()) {
+            GetterSetter* getterSetter = asGetterSetter(value);
+            addValue(getterSetter->getter());
+            addValue(getterSetter->setter());
+            if (m_unsupportedObject)
+                return;
+            unsigned name = addName(it->ustring().rep());
+            writeUInt8(AccessorRecord);
+            writeObjectReference(object);
+            writeUInt32(name);
+            writeUInt32(attributes & ~(Getter | Setter));
+            writeValue(getterSetter->getter());
+            writeValue(getterSetter->setter());
+            continue;
+        }
+
+        addValue(value);
+        if (m_unsupportedObject)
+            return;
+        unsigned name = addName(it->ustring().rep());
+        writeUInt8(PropertyRecord);
+        writeObjectReference(object);
+        writeUInt32(name);
+        writeUInt32(attributes);
+        writeValue(value);
+    }
+
+    if (!pristine)
+        return;
+
+    // Record the built-in properties that scripts deleted.
+    PropertyNameArray builtinPropertyNames(m_pristineExec);
+    pristine->structure()->getAllPropertyNames(builtinPropertyNames);
+    end = builtinPropertyNames.end();
+    for (PropertyNameArray::const_iterator it = builtinPropertyNames.begin(); it != end; ++it) {
+        PropertySlot slot;
+        if (object->structure()->get(*it) != WTI::notFound || object->getOwnPropertySlot(m_exec, *it, slot))
+            continue;
+        unsigned name = addName(it->ustring().rep());
+        writeUInt8(DeletedPropertyRecord);
+        writeObjectReference(object);
+        writeUInt32(name);
+    }
+}
+
+void TiGlobalObjectSnapshotWriter::writeVariables(TiObject* object)
+{
+    if (!object->isVariableObject())
+        return;
+
+    // Variables are written by name, and found in the symbol table the
+    // object was read with.
+    JSVariableObject* variables = static_cast<JSVariableObject*>(object);
+    SymbolTable::iterator end = variables->symbolTable().end();
+    for (SymbolTable::iterator it = variables->symbolTable().begin(); it != end; ++it) {
+        TiValue value = variables->registerAt(it->second.getIndex()).jsValue();
+        addValue(value);
+        if (m_unsupportedObject)
+            return;
+        unsigned name = addName(it->first.get());
+        writeUInt8(VariableRecord);
+        writeObjectReference(object);
+        writeUInt32(name);
+        writeValue(value);
+    }
+}
+
+static bool compareSymbolTableIndices(const SymbolTable::iterator& a, const SymbolTable::iterator& b)
+{
+    // Global variables have negative indices, allocated downwards.
+    return a->second.getIndex() > b->second.getIndex();
+}
+
+void TiGlobalObjectSnapshotWriter::writeGlobals()
+{
+    Vector<SymbolTable::iterator> globals;
+    SymbolTable::iterator end = m_globalObject->symbolTable().end();
+    for (SymbolTable::iterator it = m_globalObject->symbolTable().begin(); it != end; ++it)
+        globals.append(it);
+    std::sort(globals.begin(), globals.end(), compareSymbolTableIndices);
+
+    Vector<unsigned> names;
+    for (size_t i = 0; i < globals.size(); ++i) {
+        addValue(m_globalObject->registerAt(globals[i]->second.getIndex()).jsValue());
+        if (m_unsupportedObject)
+            return;
+        names.append(addName(globals[i]->first.get()));
+    }
+
+    writeUInt8(GlobalsRecord);
+    writeUInt32(globals.size());
+    for (size_t i = 0; i < globals.size(); ++i) {
+        writeUInt32(names[i]);
+        writeUInt32(globals[i]->second.getAttributes());
+        writeValue(m_globalObject->registerAt(globals[i]->second.getIndex()).jsValue());
+    }
+}
+
+void TiGlobalObjectSnapshotWriter::writeUInt8(unsigned value)
+{
+    ASSERT(value <= 0xFF);
+    m_snapshot->append(static_cast<char>(value));
+}
+
+void TiGlobalObjectSnapshotWriter::writeUInt32(unsigned value)
+{
+    uint32_t data = value;
+    m_snapshot->append(reinterpret_cast<const char*>(&data), sizeof(data));
+}
+
+void TiGlobalObjectSnapshotWriter::writeDouble(double value)
+{
+    m_snapshot->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void TiGlobalObjectSnapshotWriter::writeString(const UString& string)
+{
+    if (string.isNull()) {
+        writeUInt32(nullStringLength);
+        return;
+    }
+    writeString(string.data(), static_cast<unsigned>(string.size()));
+}
+
+void TiGlobalObjectSnapshotWriter::writeString(const UChar* characters, unsigned length)
+{
+    writeUInt32(length);
+    m_snapshot->append(reinterpret_cast<const char*>(characters), length * sizeof(UChar));
+}
+
+void TiGlobalObjectSnapshotWriter::writePointer(const void* pointer, size_t size)
+{
+    ASSERT(m_allowNativeReferences);
+    m_snapshot->append(static_cast<const char*>(pointer), size);
+}
+
+void TiGlobalObjectSnapshotWriter::writeObjectReference(TiObject* object)
+{
+    ASSERT(m_objects.contains(object));
+    writeUInt32(m_objects.get(object));
+}
+
+void TiGlobalObjectSnapshotWriter::writeValue(TiValue value)
+{
+    if (!value)
+        writeUInt8(EmptyValue);
+    else if (value.isUndefined())
+        writeUInt8(UndefinedValue);
+    else if (value.isNull())
+        writeUInt8(NullValue);
+    else if (value.isBoolean())
+        writeUInt8(value.isTrue() ? TrueValue : FalseValue);
+    else if (value.isNumber()) {
+        writeUInt8(NumberValue);
+        writeDouble(value.uncheckedGetNumber());
+    } else if (value.isString()) {
+        writeUInt8(StringValue);
+        writeString(asString(value)->value());
+    } else {
+        writeUInt8(ObjectValue);
+        writeObjectReference(asObject(value));
+    }
+}
+
+TiGlobalObjectSnapshotReader::TiGlobalObjectSnapshotReader(TiGlobalObject* globalObject, bool allowNativeReferences)
+    : m_exec(globalObject->globalExec())
+    , m_globalObject(globalObject)
+    , m_allowNativeReferences(allowNativeReferences)
+    , m_position(0)
+    , m_end(0)
+    , m_failed(false)
+{
+}
+
+TiGlobalObjectSnapshotReader::~TiGlobalObjectSnapshotReader()
+{
+}
+
+bool TiGlobalObjectSnapshotReader::read(const char* snapshot, size_t size)
+{
+    m_position = snapshot;
+    m_end = snapshot + size;
+
+    if (size < sizeof(snapshotMagic) || memcmp(snapshot, snapshotMagic, sizeof(snapshotMagic)))
+        return false;
+    m_position += sizeof(snapshotMagic);
+    if (readUInt32() != snapshotVersion)
+        return false;
+    bool hasNativeReferences = readUInt8();
+    if (m_failed || (hasNativeReferences && !m_allowNativeReferences))
+        return false;
+
+    while (!m_failed) {
+        switch (readUInt8()) {
+        case EndRecord:
+            return !m_failed && m_position == m_end;
+        case NameRecord:
+            m_names.append(readIdentifier());
+            break;
+        case SourceRecord:
+            readSource();
+            break;
+        case ExecutableRecord:
+            readExecutable();
+            break;
+        case BuiltinRecord:
+            readBuiltin();
+            break;
+        case ObjectRecord:
+            readObject();
+            break;
+        case ScopeChainRecord:
+            readScopeChain();
+            break;
+        case PrototypeRecord:
+            readPrototype();
+            break;
+        case PropertyRecord:
+            readProperty();
+            break;
+        case AccessorRecord:
+            readAccessor();
+            break;
+        case DeletedPropertyRecord:
+            readDeletedProperty();
+            break;
+        case ElementRecord:
+            readElement();
+            break;
+        case LengthRecord:
+            readLength();
+            break;
+        case VariableRecord:
+            readVariable();
+            break;
+        case GlobalsRecord:
+            readGlobals();
+            break;
+        default:
+            m_failed = true;
+            break;
+        }
+    }
+    return false;
+}
+
+void TiGlobalObjectSnapshotReader::readSource()
+{
+    UString url = readString();
+    UString source = readString();
+    if (!m_failed)
+        m_sources.append(UStringSourceProvider::create(source, url));
+}
+
+void TiGlobalObjectSnapshotReader::readExecutable()
+{
+    unsigned sourceProvider = readUInt32();
+    unsigned startOffset = readUInt32();
+    unsigned endOffset = readUInt32();
+    unsigned sourceFirstLine = readUInt32();
+    unsigned firstLine = readUInt32();
+    unsigned lastLine = readUInt32();
+    Identifier name = readName();
+    bool forceUsesArguments = readUInt8();
+    RefPtr<FunctionParameters> parameters = FunctionParameters::create(0);
+    for (unsigned count = readUInt32(); count && !m_failed; --count)
+        parameters->append(readName());
+
+    if (m_failed || sourceProvider >= m_sources.size() || startOffset > endOffset || endOffset > static_cast<unsigned>(m_sources[sourceProvider]->length())) {
+        m_failed = true;
+        return;
+    }
+    SourceCode source(m_sources[sourceProvider], startOffset, endOffset, sourceFirstLine);
+    m_executables.append(FunctionExecutable::create(&m_exec->globalData(), name, source, forceUsesArguments, parameters.get(), firstLine, lastLine));
+}
+
+void TiGlobalObjectSnapshotReader::readBuiltin()
+{
+    UString className = readString();
+
+    TiObject* builtin = 0;
+    switch (readUInt8()) {
+    case RootPath:
+        builtin = rootObject(m_globalObject, readUInt32());
+        break;
+    case GlobalVariablePath: {
+        Identifier name = readName();
+        SymbolTableEntry entry = m_globalObject->symbolTable().get(name.ustring().rep());
+        if (m_failed || entry.isNull())
+            break;
+        TiValue value = m_globalObject->registerAt(entry.getIndex()).jsValue();
+        if (value && value.isObject())
+            builtin = asObject(value);
+        break;
+    }
+    case PropertyPath: {
+        TiObject* object = readObjectReference();
+        Identifier name = readName();
+        PropertySlot slot;
+        if (m_failed || !object->getOwnPropertySlot(m_exec, name, slot))
+            break;
+        // Looking the property up creates it if it is made lazily.
+        TiValue value = object->getDirect(name);
+        if (value && value.isObject())
+            builtin = asObject(value);
+        break;
+    }
+    }
+
+    if (m_failed || !builtin || builtin->className() != className) {
+        m_failed = true;
+        return;
+    }
+    m_objects.append(builtin);
+}
+
+void TiGlobalObjectSnapshotReader::readObject()
+{
+    TiObject* object = 0;
+    switch (readUInt8()) {
+    case PlainObject: {
+        TiValue prototype = readValue();
+        if (prototype.isObject())
+            object = new (m_exec) TiObject(asObject(prototype)->inheritorID());
+        else if (prototype.isNull())
+            object = new (m_exec) TiObject(TiObject::createStructure(prototype));
+        break;
+    }
+    case ArrayObject:
+        object = new (m_exec) TiArray(m_globalObject->arrayStructure());
+        break;
+    case FunctionObject: {
+        FunctionExecutable* executable = readExecutableReference();
+        ScopeChainNode* scopeChain = readScopeChainReference();
+        if (!m_failed)
+            object = new (m_exec) TiFunction(m_exec, executable, scopeChain);
+        break;
+    }
+    case ActivationObject: {
+        FunctionExecutable* executable = readExecutableReference();
+        CodeFeatures features = readUInt32();
+        unsigned variableCount = readUInt32();
+        if (m_failed)
+            break;
+        // Each activation gets a symbol table of its own. Parameters have the
+        // registers below the call frame header, and variables those above it.
+        RefPtr<SharedSymbolTable> symbolTable = adoptRef(new SharedSymbolTable);
+        int firstIndex = -static_cast<int>(executable->parameterCount() + RegisterFile::CallFrameHeaderSize);
+        for (unsigned count = readUInt32(); count && !m_failed; --count) {
+            Identifier name = readName();
+            int index = static_cast<int>(readUInt32());
+            unsigned attributes = readUInt32();
+            if (m_failed || index < firstIndex || index >= static_cast<int>(variableCount)
+                || !symbolTable->add(name.ustring().rep(), SymbolTableEntry(index, attributes)).second)
+                m_failed = true;
+        }
+        if (m_failed)
+            break;
+        if (executable->isGenerated()) {
+            if (executable->features() != features || executable->variableCount() != variableCount) {
+                m_failed = true;
+                break;
+            }
+        } else
+            executable->restoreLayout(features, variableCount);
+        object = new (m_exec) JSActivation(&m_exec->globalData(), executable, symbolTable.get());
+        break;
+    }
+    case StaticScopeObject: {
+        Identifier name = readName();
+        unsigned attributes = readUInt32();
+        if (!m_failed)
+            object = new (m_exec) TiStaticScopeObject(m_exec, name, jsUndefined(), attributes);
+        break;
+    }
+    case BooleanWrapperObject: {
+        TiValue value = readValue();
+        if (value.isBoolean()) {
+            BooleanObject* booleanObject = new (m_exec) BooleanObject(m_globalObject->booleanObjectStructure());
+            booleanObject->setInternalValue(value);
+            object = booleanObject;
+        }
+        break;
+    }
+    case NumberWrapperObject: {
+        TiValue value = readValue();
+        if (value.isNumber()) {
+            NumberObject* numberObject = new (m_exec) NumberObject(m_globalObject->numberObjectStructure());
+            numberObject->setInternalValue(value);
+            object = numberObject;
+        }
+        break;
+    }
+    case StringWrapperObject: {
+        UString string = readString();
+        if (!m_failed)
+            object = new (m_exec) StringObject(m_exec, m_globalObject->stringObjectStructure(), string);
+        break;
+    }
+    case DateObject: {
+        TiValue value = readValue();
+        if (value.isNumber()) {
+            DateInstance* date = new (m_exec) DateInstance(m_exec, m_globalObject->dateStructure());
+            date->setInternalValue(value);
+            object = date;
+        }
+        break;
+    }
+    case RegExpObjectType: {
+        UString pattern = readString();
+        UString flags = readString();
+        double lastIndex = readDouble();
+        if (m_failed)
+            break;
+        RegExpObject* regExpObject = new (m_exec) RegExpObject(m_globalObject->regExpStructure(), RegExp::create(&m_exec->globalData(), pattern, flags));
+        regExpObject->setLastIndex(lastIndex);
+        object = regExpObject;
+        break;
+    }
+    case ErrorObject:
+        object = new (m_exec) ErrorInstance(m_globalObject->errorStructure());
+        break;
+    case HostFunctionObject: {
+        NativeFunction function;
+        readPointer(&function, sizeof(function));
+        Identifier name = readIdentifier();
+        if (!m_failed)
+            object = new (m_exec) TiFunction(m_exec, m_globalObject->prototypeFunctionStructure(), 0, name, function);
+        break;
+    }
+    case InternalHostFunctionObject: {
+        NativeFunction function;
+        readPointer(&function, sizeof(function));
+        Identifier name = readIdentifier();
+        if (!m_failed)
+            object = new (m_exec) PrototypeFunction(m_exec, m_globalObject->prototypeFunctionStructure(), 0, name, function);
+        break;
+    }
+    case CallbackFunctionObject: {
+        TiObjectCallAsFunctionCallback callback;
+        readPointer(&callback, sizeof(callback));
+        Identifier name = readIdentifier();
+        if (!m_failed)
+            object = new (m_exec) TiCallbackFunction(m_exec, callback, name);
+        break;
+    }
+    case CallbackObjectObject: {
+        TiClassRef classRef;
+        readPointer(&classRef, sizeof(classRef));
+        if (!m_failed)
+            object = new (m_exec) TiCallbackObject<TiObject>(m_exec, m_globalObject->callbackObjectStructure(), classRef, 0);
+        break;
+    }
+    }
+
+    if (!object) {
+        m_failed = true;
+        return;
+    }
+    m_objects.append(object);
+}
+
+void TiGlobalObjectSnapshotReader::readScopeChain()
+{
+    TiObject* object = readObjectReference();
+    ScopeChainNode* next = readScopeChainReference();
+    if (m_failed)
+        return;
+    ScopeChain scopeChain(next);
+    scopeChain.push(object);
+    m_scopeChains.append(scopeChain);
+}
+
+void TiGlobalObjectSnapshotReader::readPrototype()
+{
+    TiObject* object = readObjectReference();
+    TiValue prototype = readValue();
+    if (m_failed || !(prototype.isObject() || prototype.isNull())) {
+        m_failed = true;
+        return;
+    }
+    // Like __proto__, refuse a prototype chain that would loop.
+    for (TiValue chain = prototype; chain.isObject(); chain = asObject(chain)->prototype()) {
+        if (asObject(chain) == object) {
+            m_failed = true;
+            return;
+        }
+    }
+    if (object->prototype() != prototype)
+        object->setPrototype(prototype);
+}
+
+void TiGlobalObjectSnapshotReader::readProperty()
+{
+    TiObject* object = readObjectReference();
+    Identifier name = readName();
+    unsigned attributes = readUInt32();
+    TiValue value = readValue();
+    if (m_failed || !value || (attributes & (Getter | Setter))) {
+        m_failed = true;
+        return;
+    }
+
+    unsigned currentAttributes;
+    TiCell* specificValue;
+    size_t offset = object->structure()->get(name, currentAttributes, specificValue);
+    if (offset != WTI::notFound && currentAttributes != attributes)
+        object->removeDirect(name);
+    object->putDirect(name, value, attributes);
+}
+
+void TiGlobalObjectSnapshotReader::readAccessor()
+{
+    TiObject* object = readObjectReference();
+    Identifier name = readName();
+    unsigned attributes = readUInt32();
+    TiValue getter = readValue();
+    TiValue setter = readValue();
+    if (m_failed || (getter && !getter.isObject()) || (setter && !setter.isObject()) || (attributes & (Getter | Setter))) {
+        m_failed = true;
+        return;
+    }
+
+    unsigned currentAttributes;
+    TiCell* specificValue;
+    size_t offset = object->structure()->get(name, currentAttributes, specificValue);
+    if (offset != WTI::notFound && !object->getDirectOffset(offset).isGetterSetter())
+        object->removeDirect(name);
+    if (getter)
+        object->defineGetter(m_exec, name, asObject(getter), attributes);
+    if (setter)
+        object->defineSetter(m_exec, name, asObject(setter), attributes);
+}
+
+void TiGlobalObjectSnapshotReader::readDeletedProperty()
+{
+    TiObject* object = readObjectReference();
+    Identifier name = readName();
+    if (!m_failed && object->structure()->get(name) != WTI::notFound)
+        object->removeDirect(name);
+}
+
+void TiGlobalObjectSnapshotReader::readElement()
+{
+    TiObject* object = readObjectReference();
+    unsigned index = readUInt32();
+    TiValue value = readValue();
+    if (m_failed || !value || !object->inherits(&TiArray::info)) {
+        m_failed = true;
+        return;
+    }
+    object->put(m_exec, index, value);
+}
+
+void TiGlobalObjectSnapshotReader::readLength()
+{
+    TiObject* object = readObjectReference();
+    unsigned length = readUInt32();
+    if (m_failed || !object->inherits(&TiArray::info)) {
+        m_failed = true;
+        return;
+    }
+    asArray(object)->setLength(length);
+}
+
+void TiGlobalObjectSnapshotReader::readVariable()
+{
+    TiObject* object = readObjectReference();
+    Identifier name = readName();
+    TiValue value = readValue();
+    if (m_failed || !object->isVariableObject() || object->isGlobalObject()) {
+        m_failed = true;
+        return;
+    }
+
+    JSVariableObject* variables = static_cast<JSVariableObject*>(object);
+    SymbolTableEntry entry = variables->symbolTable().get(name.ustring().rep());
+    if (entry.isNull()) {
+        m_failed = true;
+        return;
+    }
+    variables->registerAt(entry.getIndex()) = value;
+}
+
+void TiGlobalObjectSnapshotReader::readGlobals()
+{
+    // The values of the new globals are kept in a marked list until they are
+    // added together.
+    Vector<TiGlobalObject::GlobalPropertyInfo> newGlobals;
+    MarkedArgumentBuffer newGlobalValues;
+    for (unsigned count = readUInt32(); count && !m_failed; --count) {
+        Identifier name = readName();
+        unsigned attributes = readUInt32();
+        TiValue value = readValue();
+        if (m_failed)
+            return;
+
+        SymbolTableEntry entry = m_globalObject->symbolTable().get(name.ustring().rep());
+        if (!entry.isNull())
+            m_globalObject->registerAt(entry.getIndex()) = value;
+        else {
+            newGlobalValues.append(value);
+            newGlobals.append(TiGlobalObject::GlobalPropertyInfo(name, value, attributes | DontDelete));
+        }
+    }
+
+    if (!m_failed && !newGlobals.isEmpty())
+        m_globalObject->addStaticGlobals(newGlobals.data(), newGlobals.size());
+}
+
+unsigned TiGlobalObjectSnapshotReader::readUInt8()
+{
+    if (m_position == m_end) {
+        m_failed = true;
+        return 0;
+    }
+    return static_cast<unsigned char>(*m_position++);
+}
+
+unsigned TiGlobalObjectSnapshotReader::readUInt32()
+{
+    uint32_t value = 0;
+    if (static_cast<size_t>(m_end - m_position) < sizeof(value)) {
+        m_failed = true;
+        return 0;
+    }
+    memcpy(&value, m_position, sizeof(value));
+    m_position += sizeof(value);
+    return value;
+}
+
+double TiGlobalObjectSnapshotReader::readDouble()
+{
+    double value = 0;
+    if (static_cast<size_t>(m_end - m_position) < sizeof(value)) {
+        m_failed = true;
+        return 0;
+    }
+    memcpy(&value, m_position, sizeof(value));
+    m_position += sizeof(value);
+    return value;
+}
+
+UString TiGlobalObjectSnapshotReader::readString()
+{
+    unsigned length = readUInt32();
+    if (m_failed || length == nullStringLength)
+        return UString();
+    if (static_cast<size_t>(m_end - m_position) / sizeof(UChar) < length) {
+        m_failed = true;
+        return UString();
+    }
+
+    // The characters may not be aligned.
+    Vector<UChar> characters(length);
+    memcpy(characters.data(), m_position, length * sizeof(UChar));
+    m_position += length * sizeof(UChar);
+    return UString(characters);
+}
+
+Identifier TiGlobalObjectSnapshotReader::readName()
+{
+    unsigned id = readUInt32();
+    if (m_failed || id >= m_names.size()) {
+        m_failed = true;
+        return m_exec->propertyNames().nullIdentifier;
+    }
+    return m_names[id];
+}
+
+Identifier TiGlobalObjectSnapshotReader::readIdentifier()
+{
+    UString string = readString();
+    if (string.isNull())
+        return m_exec->propertyNames().nullIdentifier;
+    return Identifier(m_exec, string);
+}
+
+void TiGlobalObjectSnapshotReader::readPointer(void* pointer, size_t size)
+{
+    // The header's flag only says whether the snapshot claims to hold native
+    // references, so a file that clears it is still checked here.
+    if (!m_allowNativeReferences || static_cast<size_t>(m_end - m_position) < size) {
+        m_failed = true;
+        memset(pointer, 0, size);
+        return;
+    }
+    memcpy(pointer, m_position, size);
+    m_position += size;
+}
+
+TiObject* TiGlobalObjectSnapshotReader::readObjectReference()
+{
+    unsigned id = readUInt32();
+    if (m_failed || id >= m_objects.size()) {
+        m_failed = true;
+        return 0;
+    }
+    return asObject(m_objects.at(id));
+}
+
+ScopeChainNode* TiGlobalObjectSnapshotReader::readScopeChainReference()
+{
+    unsigned id = readUInt32();
+    if (m_failed || id > m_scopeChains.size()) {
+        m_failed = true;
+        return 0;
+    }
+    return id ? m_scopeChains[id - 1].node() : m_globalObject->globalScopeChain().node();
+}
+
+FunctionExecutable* TiGlobalObjectSnapshotReader::readExecutableReference()
+{
+    unsigned id = readUInt32();
+    if (m_failed || id >= m_executables.size()) {
+        m_failed = true;
+        return 0;
+    }
+    return m_executables[id].get();
+}
+
+TiValue TiGlobalObjectSnapshotReader::readValue()
+{
+    switch (readUInt8()) {
+    case EmptyValue:
+        return TiValue();
+    case UndefinedValue:
+        return jsUndefined();
+    case NullValue:
+        return jsNull();
+    case FalseValue:
+        return jsBoolean(false);
+    case TrueValue:
+        return jsBoolean(true);
+    case NumberValue:
+        return jsNumber(m_exec, readDouble());
+    case StringValue:
+        return jsString(m_exec, readString());
+    case ObjectValue:
+        if (TiObject* object = readObjectReference())
+            return object;
+        return TiValue();
+    }
+    m_failed = true;
+    return TiValue();
+}
+
+} // namespace TI
@@ -0,0 +1,182 @@
+/**
+ * Appcelerator Titanium License
+ * This source code and all modifications done by Appcelerator
+ * are licensed under the Apache Public License (version 2) and
+ * are Copyright (c) 2009 by Appcelerator, Inc.
+ */
+
+/*
+ * Copyright (C) 2009 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1.  Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ * 2.  Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ * 3.  Neither the name of Apple Computer, Inc. ("Apple") nor the names of
+ *     its contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE AND ITS CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL APPLE OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TiGlobalObjectSnapshot_h
+#define TiGlobalObjectSnapshot_h
+
+#include "ArgList.h"
+#include "ScopeChain.h"
+#include "UString.h"
+#include <wtf/HashMap.h>
+#include <wtf/HashSet.h>
+#include <wtf/RefPtr.h>
+#include <wtf/Vector.h>
+
+namespace TI {
+
+    class FunctionExecutable;
+    class Identifier;
+    class SourceProvider;
+    class TiGlobalObject;
+    class TiObject;
+    class TiExcState;
+    class TiValue;
+
+    // A snapshot holds the state scripts have built up in a global object, so
+    // that a new global object, in this process or another one, can start from
+    // it instead of running the scripts again. Built-in objects are stored as
+    // paths to the same objects in a new global object, and everything else
+    // reachable from the global object, including closures and their scopes,
+    // as records that the reader creates the objects from. Functions are
+    // stored as source, and compiled for the new global object when they are
+    // first called.
+    //
+    // A snapshot with native references also holds the addresses of API
+    // callbacks and classes, so it can only be read by the process that wrote
+    // it.
+    class TiGlobalObjectSnapshotWriter : public Noncopyable {
+    public:
+        // The pristine global object is one of the same class that no script
+        // has run in, against which the built-in objects are matched.
+        TiGlobalObjectSnapshotWriter(TiGlobalObject*, TiGlobalObject* pristineGlobalObject, bool allowNativeReferences);
+        ~TiGlobalObjectSnapshotWriter();
+
+        // Returns false if the global object holds an object that can not be
+        // written, such as an arguments object or an API object with private
+        // data.
+        bool write(Vector<char>& snapshot);
+        TiObject* unsupportedObject() const { return m_unsupportedObject; }
+
+    private:
+        bool addBuiltin(TiObject*, TiObject* pristine);
+        void matchBuiltins();
+
+        void addValue(TiValue);
+        bool addObject(TiObject*);
+        bool writeObject(TiObject*);
+        unsigned addScopeChain(ScopeChainNode*);
+        unsigned addExecutable(FunctionExecutable*);
+        unsigned addSource(SourceProvider*);
+        unsigned addName(UString::Rep*);
+
+        void writePrototype(TiObject*);
+        void writeElements(TiObject*);
+        void writeProperties(TiObject*, TiObject* pristine);
+        void writeVariables(TiObject*);
+        void writeGlobals();
+
+        void writeUInt8(unsigned);
+        void writeUInt32(unsigned);
+        void writeDouble(double);
+        void writeString(const UString&);
+        void writeString(const UChar*, unsigned length);
+        void writePointer(const void*, size_t);
+        void writeObjectReference(TiObject*);
+        void writeValue(TiValue);
+
+        TiExcState* m_exec;
+        TiExcState* m_pristineExec;
+        TiGlobalObject* m_globalObject;
+        TiGlobalObject* m_pristineGlobalObject;
+        bool m_allowNativeReferences;
+        TiObject* m_unsupportedObject;
+        Vector<char>* m_snapshot;
+
+        HashMap<TiObject*, unsigned> m_objects;
+        HashSet<TiObject*> m_pristineBuiltins;
+        Vector<std::pair<TiObject*, TiObject*> > m_builtins;
+        Vector<TiObject*> m_pendingObjects;
+
+        HashMap<ScopeChainNode*, unsigned> m_scopeChains;
+        HashMap<FunctionExecutable*, unsigned> m_executables;
+        HashMap<SourceProvider*, unsigned> m_sources;
+        HashMap<RefPtr<UString::Rep>, unsigned> m_names;
+    };
+
+    class TiGlobalObjectSnapshotReader : public Noncopyable {
+    public:
+        // The global object must be new, with no script run in it, and of the
+        // same class as the one the snapshot was written from.
+        TiGlobalObjectSnapshotReader(TiGlobalObject*, bool allowNativeReferences);
+        ~TiGlobalObjectSnapshotReader();
+
+        // Returns false, leaving the global object partly restored, if the
+        // snapshot is malformed or does not match the global object.
+        bool read(const char* snapshot, size_t size);
+
+    private:
+        void readSource();
+        void readExecutable();
+        void readBuiltin();
+        void readObject();
+        void readScopeChain();
+        void readPrototype();
+        void readProperty();
+        void readAccessor();
+        void readDeletedProperty();
+        void readElement();
+        void readLength();
+        void readVariable();
+        void readGlobals();
+
+        unsigned readUInt8();
+        unsigned readUInt32();
+        double readDouble();
+        UString readString();
+        Identifier readIdentifier();
+        Identifier readName();
+        void readPointer(void*, size_t);
+        TiObject* readObjectReference();
+        ScopeChainNode* readScopeChainReference();
+        FunctionExecutable* readExecutableReference();
+        TiValue readValue();
+
+        TiExcState* m_exec;
+        TiGlobalObject* m_globalObject;
+        bool m_allowNativeReferences;
+        const char* m_position;
+        const char* m_end;
+        bool m_failed;
+
+        MarkedArgumentBuffer m_objects;
+        Vector<ScopeChain> m_scopeChains;
+        Vector<RefPtr<FunctionExecutable> > m_executables;
+        Vector<RefPtr<SourceProvider> > m_sources;
+        Vector<Identifier> m_names;
+    };
+
+} // namespace TI
+
+#endif // TiGlobalObjectSnapshot_h
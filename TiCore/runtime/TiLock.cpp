@@ -30,6 +30,7 @@
 
 #include "Collector.h"
 #include "CallFrame.h"
+#include "TiGlobalData.h"
 
 #if ENABLE(JSC_MULTIPLE_THREADS)
 #include <pthread.h>
@@ -39,8 +40,9 @@ namespace TI {
 
 #if ENABLE(JSC_MULTIPLE_THREADS)
 
-// Acquire this mutex before accessing lock-related data.
-static pthread_mutex_t JSMutex = PTHREAD_MUTEX_INITIALIZER;
+// Only the shared TiGlobalData is locked for real, so this mutex belongs to it.
+// Other context groups never take it, and run in parallel with each other.
+static pthread_mutex_t sharedInstanceMutex = PTHREAD_MUTEX_INITIALIZER;
 
 // Thread-specific key that tells whether a thread holds the JSMutex, and how many times it was taken recursively.
 pthread_key_t TiLockCount;
@@ -72,6 +74,12 @@ TiLock::TiLock(TiExcState* exec)
     lock(m_lockBehavior);
 }
 
+TiLock::TiLock(TiGlobalData* globalData)
+    : m_lockBehavior(globalData->isSharedInstance ? LockForReal : SilenceAssertionsOnly)
+{
+    lock(m_lockBehavior);
+}
+
 void TiLock::lock(TiLockBehavior lockBehavior)
 {
 #ifdef NDEBUG
@@ -85,7 +93,7 @@ void TiLock::lock(TiLockBehavior lockBehavior)
     intptr_t currentLockCount = lockCount();
     if (!currentLockCount && lockBehavior == LockForReal) {
         int result;
-        result = pthread_mutex_lock(&JSMutex);
+        result = pthread_mutex_lock(&sharedInstanceMutex);
         ASSERT(!result);
     }
     setLockCount(currentLockCount + 1);
@@ -104,7 +112,7 @@ void TiLock::unlock(TiLockBehavior lockBehavior)
     intptr_t newLockCount = lockCount() - 1;
     if (!newLockCount && lockBehavior == LockForReal) {
         int result;
-        result = pthread_mutex_unlock(&JSMutex);
+        result = pthread_mutex_unlock(&sharedInstanceMutex);
         ASSERT(!result);
     }
     setLockCount(newLockCount);
@@ -166,29 +174,31 @@ bool TiLock::currentThreadIsHoldingLock()
 // order in which they were made - though implementing the less restrictive policy
 // would likely increase complexity and overhead.
 //
-static unsigned lockDropDepth = 0;
+// The depth is kept per TiGlobalData, so that a callback in one context group
+// has no effect on whether another group's locks are dropped. Drops made
+// without a TiGlobalData can only be for the shared instance (the one locked
+// for real) or for assertion-only locks, so they use the shared depth.
+static unsigned sharedLockDropDepth = 0;
 
 TiLock::DropAllLocks::DropAllLocks(TiExcState* exec)
     : m_lockBehavior(exec->globalData().isSharedInstance ? LockForReal : SilenceAssertionsOnly)
+    , m_lockDropDepth(exec->globalData().isSharedInstance ? &sharedLockDropDepth : &exec->globalData().lockDropDepth)
 {
-    pthread_once(&createTiLockCountOnce, createTiLockCount);
-
-    if (lockDropDepth++) {
-        m_lockCount = 0;
-        return;
-    }
-
-    m_lockCount = TiLock::lockCount();
-    for (intptr_t i = 0; i < m_lockCount; i++)
-        TiLock::unlock(m_lockBehavior);
+    dropAllLocks();
 }
 
 TiLock::DropAllLocks::DropAllLocks(TiLockBehavior TiLockBehavior)
     : m_lockBehavior(TiLockBehavior)
+    , m_lockDropDepth(&sharedLockDropDepth)
+{
+    dropAllLocks();
+}
+
+void TiLock::DropAllLocks::dropAllLocks()
 {
     pthread_once(&createTiLockCountOnce, createTiLockCount);
 
-    if (lockDropDepth++) {
+    if ((*m_lockDropDepth)++) {
         m_lockCount = 0;
         return;
     }
@@ -206,7 +216,7 @@ TiLock::DropAllLocks::~DropAllLocks()
     for (intptr_t i = 0; i < m_lockCount; i++)
         TiLock::lock(m_lockBehavior);
 
-    --lockDropDepth;
+    --*m_lockDropDepth;
 }
 
 #else
@@ -216,6 +226,11 @@ TiLock::TiLock(TiExcState*)
 {
 }
 
+TiLock::TiLock(TiGlobalData*)
+    : m_lockBehavior(SilenceAssertionsOnly)
+{
+}
+
 // If threading support is off, set the lock count to a constant value of 1 so ssertions
 // that the lock is held don't fail
 intptr_t TiLock::lockCount()
@@ -54,14 +54,18 @@ namespace TI {
     // For contexts other than the single shared one, implicit locking is not done,
     // but we still need to perform all the counting in order to keep debug
     // assertions working, so that clients that use the shared context don't break.
+    // Lock state is kept per TiGlobalData, so threads running in different
+    // context groups never contend on a lock.
 
     class TiExcState;
+    class TiGlobalData;
 
     enum TiLockBehavior { SilenceAssertionsOnly, LockForReal };
 
     class TiLock : public Noncopyable {
     public:
         TiLock(TiExcState*);
+        TiLock(TiGlobalData*);
 
         TiLock(TiLockBehavior lockBehavior)
             : m_lockBehavior(lockBehavior)
@@ -101,8 +105,11 @@ namespace TI {
             ~DropAllLocks();
             
         private:
+            void dropAllLocks();
+
             intptr_t m_lockCount;
             TiLockBehavior m_lockBehavior;
+            unsigned* m_lockDropDepth;
         };
     };
 
@@ -109,6 +109,10 @@ void TimeoutChecker::reset()
 
 bool TimeoutChecker::didTimeOut(TiExcState* exec)
 {
+    TiGlobalData& globalData = exec->globalData();
+    if (globalData.terminationRequested)
+        return globalData.shouldTerminateExecution();
+
     unsigned currentTime = getCPUTime();
     
     if (!m_timeAtLastCheck) {
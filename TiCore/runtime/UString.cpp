@@ -405,7 +405,7 @@ void UString::Rep::checkConsistency() const
 UString::SharedUChar* UString::BaseString::sharedBuffer()
 {
     if (!m_sharedBuffer)
-        setSharedBuffer(SharedUChar::create(new OwnFastMallocPtr<UChar>(buf)));
+        setSharedBuffer(SharedUChar::create(new UStringBuffer(buf)));
     return m_sharedBuffer;
 }
 
@@ -426,7 +426,14 @@ bool UString::BaseString::slowIsBufferReadOnly()
 
     // At this point, we know it that the underlying buffer isn't shared outside of this base class,
     // so get rid of m_sharedBuffer.
-    OwnPtr<OwnFastMallocPtr<UChar> > mallocPtr(m_sharedBuffer->release());
+    OwnPtr<UStringBuffer> mallocPtr(m_sharedBuffer->release());
+
+    // An external buffer belongs to the embedder, so it stays read only.
+    if (mallocPtr->isExternal()) {
+        setSharedBuffer(SharedUChar::create(mallocPtr.release()));
+        return true;
+    }
+
     UChar* unsharedBuf = const_cast<UChar*>(mallocPtr->release());
     setSharedBuffer(0);
     preCapacity += (buf - unsharedBuf);
@@ -35,7 +35,7 @@
 #include <string.h>
 #include <wtf/Assertions.h>
 #include <wtf/CrossThreadRefCounted.h>
-#include <wtf/OwnFastMallocPtr.h>
+#include <wtf/FastMalloc.h>
 #include <wtf/PassRefPtr.h>
 #include <wtf/PtrAndFlags.h>
 #include <wtf/RefPtr.h>
@@ -80,11 +80,58 @@ namespace TI {
 
     typedef Vector<char, 32> CStringBuffer;
 
+    // The characters behind a UString::SharedUChar: either a buffer allocated
+    // with fastMalloc, or an external buffer owned by the embedder, which is
+    // never written to and is handed back through a finalizer once no string
+    // uses it. The finalizer may be called on any thread.
+    class UStringBuffer : public Noncopyable {
+    public:
+        typedef void (*Finalizer)(UChar* characters, size_t length, void* context);
+
+        explicit UStringBuffer(UChar* characters)
+            : m_characters(characters)
+            , m_length(0)
+            , m_isExternal(false)
+            , m_finalizer(0)
+            , m_context(0)
+        {
+        }
+
+        UStringBuffer(UChar* characters, size_t length, Finalizer finalizer, void* context)
+            : m_characters(characters)
+            , m_length(length)
+            , m_isExternal(true)
+            , m_finalizer(finalizer)
+            , m_context(context)
+        {
+        }
+
+        ~UStringBuffer()
+        {
+            if (!m_isExternal)
+                fastFree(m_characters);
+            else if (m_finalizer)
+                m_finalizer(m_characters, m_length, m_context);
+        }
+
+        bool isExternal() const { return m_isExternal; }
+
+        UChar* get() const { return m_characters; }
+        UChar* release() { ASSERT(!m_isExternal); UChar* characters = m_characters; m_characters = 0; return characters; }
+
+    private:
+        UChar* m_characters;
+        size_t m_length;
+        bool m_isExternal;
+        Finalizer m_finalizer;
+        void* m_context;
+    };
+
     class UString {
         friend class JIT;
 
     public:
-        typedef CrossThreadRefCounted<OwnFastMallocPtr<UChar> > SharedUChar;
+        typedef CrossThreadRefCounted<UStringBuffer> SharedUChar;
         struct BaseString;
         struct Rep : Noncopyable {
             friend class JIT;
@@ -0,0 +1,219 @@
+/* ***** BEGIN LICENSE BLOCK *****
+* Version: NPL 1.1/GPL 2.0/LGPL 2.1
+*
+* The contents of this file are subject to the Netscape Public License
+* Version 1.1 (the "License"); you may not use this file except in
+* compliance with the License. You may obtain a copy of the License at
+* http://www.mozilla.org/NPL/
+*
+* Software distributed under the License is distributed on an "AS IS" basis,
+* WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+* for the specific language governing rights and limitations under the
+* License.
+*
+* The Original Code is JavaScript Engine testing utilities.
+*
+* The Initial Developer of the Original Code is Netscape Communications Corp.
+* Portions created by the Initial Developer are Copyright (C) 2009
+* the Initial Developer. All Rights Reserved.
+*
+* Contributor(s):
+*
+* Alternatively, the contents of this file may be used under the terms of
+* either the GNU General Public License Version 2 or later (the "GPL"), or
+* the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+* in which case the provisions of the GPL or the LGPL are applicable instead
+* of those above. If you wish to allow use of your version of this file only
+* under the terms of either the GPL or the LGPL, and not to allow others to
+* use your version of this file under the terms of the NPL, indicate your
+* decision by deleting the provisions above and replace them with the notice
+* and other provisions required by the GPL or the LGPL. If you do not delete
+* the provisions above, a recipient may use your version of this file under
+* the terms of any one of the NPL, the GPL or the LGPL.
+*
+* ***** END LICENSE BLOCK *****
+*
+*
+* Date:    19 October 2009
+* SUMMARY: Back-references and quantified parentheses
+*
+* Per ECMA-262 Edition 3, 15.10.2.9, a back-reference to a subpattern that
+* has not matched, or that encloses the reference, matches the empty string.
+* Per 15.10.2.5, each iteration of a quantified subpattern starts with the
+* subpatterns within it unmatched, and iterations past the minimum may not
+* match the empty string.
+*
+*/
+//-----------------------------------------------------------------------------
+var i = 0;
+var bug = '(none)';
+var summary = 'Back-references and quantified parentheses';
+var status = '';
+var statusmessages = new Array();
+var pattern = '';
+var patterns = new Array();
+var string = '';
+var strings = new Array();
+var actualmatch = '';
+var actualmatches = new Array();
+var expectedmatch = '';
+var expectedmatches = new Array();
+var cnEmptyString = '';
+
+
+pattern = /(a\1)+/;
+  status = inSection(1);
+  string = 'xaay';
+  actualmatch = string.match(pattern);
+  expectedmatch = Array('aa', 'a');
+  addThis();
+
+pattern = /(\1)/i;
+  status = inSection(2);
+  string = 'x';
+  actualmatch = string.match(pattern);
+  expectedmatch = Array(cnEmptyString, cnEmptyString);
+  addThis();
+
+pattern = /(a\1b)/i;
+  status = inSection(3);
+  string = 'xABy';
+  actualmatch = string.match(pattern);
+  expectedmatch = Array('AB', 'AB');
+  addThis();
+
+pattern = /(a?..\1)x?b/;
+  status = inSection(4);
+  string = 'abba';
+  actualmatch = string.match(pattern);
+  expectedmatch = Array('abb', 'ab');
+  addThis();
+
+pattern = /(a)\1/i;
+  status = inSection(5);
+  string = 'aA';
+  actualmatch = string.match(pattern);
+  expectedmatch = Array('aA', 'a');
+  addThis();
+
+pattern = /(\u00e9)\1/i;
+  status = inSection(6);
+  string = '\u00e9\u00c9';
+  actualmatch = string.match(pattern);
+  expectedmatch = Array('\u00e9\u00c9', '\u00e9');
+  addThis();
+
+pattern = /(?:(\w)\1)+/;
+  status = inSection(7);
+  string = 'aabbcd';
+  actualmatch = string.match(pattern);
+  expectedmatch = Array('aabb', 'b');
+  addThis();
+
+pattern = /(?:(a)|b){2}/;
+  status = inSection(8);
+  string = 'ab';
+  actualmatch = string.match(pattern);
+  expectedmatch = Array('ab', undefined);
+  addThis();
+
+pattern = /(?:(a)|b)+c/;
+  status = inSection(9);
+  string = 'abac';
+  actualmatch = string.match(pattern);
+  expectedmatch = Array('abac', 'a');
+  addThis();
+
+pattern = /((a|b)+c)+/;
+  status = inSection(10);
+  string = 'abcbac';
+  actualmatch = string.match(pattern);
+  expectedmatch = Array('abcbac', 'bac', 'a');
+  addThis();
+
+pattern = /(a+?){2,3}?x/;
+  status = inSection(11);
+  string = 'aaaax';
+  actualmatch = string.match(pattern);
+  expectedmatch = Array('aaaax', 'aa');
+  addThis();
+
+pattern = /(a*)*b/;
+  status = inSection(12);
+  string = 'b';
+  actualmatch = string.match(pattern);
+  expectedmatch = Array('b', undefined);
+  addThis();
+
+pattern = /(z)((a+)?(b+)?(c))*/;
+  status = inSection(13);
+  string = 'zaacbbbcac';
+  actualmatch = string.match(pattern);
+  expectedmatch = Array('zaacbbbcac', 'z', 'ac', 'a', undefined, 'c');
+  addThis();
+
+pattern = /(a)??b/;
+  status = inSection(14);
+  string = 'ab';
+  actualmatch = string.match(pattern);
+  expectedmatch = Array('ab', 'a');
+  addThis();
+
+pattern = /a(?=c)c/;
+  status = inSection(15);
+  string = 'ac';
+  actualmatch = string.match(pattern);
+  expectedmatch = Array('ac');
+  addThis();
+
+pattern = /(?:(?=(a))ay|ab)/;
+  status = inSection(16);
+  string = 'ab';
+  actualmatch = string.match(pattern);
+  expectedmatch = Array('ab', undefined);
+  addThis();
+
+pattern = /(.*?)a(?!(a+)b\2c)\2(.*)/;
+  status = inSection(17);
+  string = 'baaabaac';
+  actualmatch = string.match(pattern);
+  expectedmatch = Array('baaabaac', 'ba', undefined, 'abaac');
+  addThis();
+
+// Enough iterations to outgrow the JIT's record of them.
+pattern = /^(?:a(b))+$/;
+  status = inSection(18);
+  string = '';
+  for (var j = 0; j < 3000; j++)
+    string += 'ab';
+  actualmatch = string.match(pattern);
+  expectedmatch = Array(string, 'b');
+  addThis();
+
+
+
+
+//-------------------------------------------------------------------------------------------------
+test();
+//-------------------------------------------------------------------------------------------------
+
+
+function addThis()
+{
+  statusmessages[i] = status;
+  patterns[i] = pattern;
+  strings[i] = string;
+  actualmatches[i] = actualmatch;
+  expectedmatches[i] = expectedmatch;
+  i++;
+}
+
+
+function test()
+{
+  enterFunc ('test');
+  printBugNumber (bug);
+  printStatus (summary);
+  testRegExp(statusmessages, patterns, strings, actualmatches, expectedmatches);
+  exitFunc ('test');
+}
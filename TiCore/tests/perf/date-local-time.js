@@ -0,0 +1,35 @@
+// Converts 100,000 timestamps spread over a year to local time, visiting
+// them out of order the way calendar code does. Run it with jsc under a
+// time zone that observes DST, e.g. TZ=America/New_York jsc date-local-time.js
+
+var count = 100000;
+var start = Date.UTC(2009, 0, 1);
+var step = 365 * 24 * 60 * 60 * 1000 / count;
+
+var times = [];
+for (var i = 0; i < count; ++i)
+    times.push(start + ((i * 7919) % count) * step);
+
+var begin = new Date;
+var hours = 0;
+for (var i = 0; i < count; ++i)
+    hours += new Date(times[i]).getHours();
+var getHoursTime = new Date - begin;
+
+begin = new Date;
+var length = 0;
+for (var i = 0; i < count; i += 10)
+    length += new Date(times[i]).toString().length;
+var toStringTime = new Date - begin;
+
+begin = new Date;
+var total = 0;
+for (var i = 0; i < count; ++i) {
+    var date = new Date(times[i]);
+    total += new Date(date.getFullYear(), date.getMonth(), date.getDate(), 12).getTime() % 1000;
+}
+var constructTime = new Date - begin;
+
+print("getHours: " + getHoursTime + "ms");
+print("toString: " + toStringTime + "ms");
+print("local date construction: " + constructTime + "ms");
@@ -856,6 +856,39 @@ double timeClip(double t)
 #if USE(JSC)
 namespace TI {
 
+typedef Vector<DSTOffsetCache::Interval, 8> DSTIntervals;
+
+// Close the gap between intervals[index - 1] and intervals[index] once it is
+// no longer than a month, and so holds at most one offset change: merge the
+// two if their offsets match, otherwise bisect for the change and extend
+// both intervals to meet there.
+static void settleDSTGap(DSTIntervals& intervals, size_t index, double utcOffset)
+{
+    DSTOffsetCache::Interval& before = intervals[index - 1];
+    DSTOffsetCache::Interval& after = intervals[index];
+    if (after.start - before.end > msPerMonth)
+        return;
+
+    if (before.offset == after.offset) {
+        before.end = after.end;
+        intervals.remove(index);
+        return;
+    }
+
+    // The OS resolves times to whole seconds, so a millisecond is fine enough.
+    double low = before.end;
+    double high = after.start;
+    while (high - low > 1) {
+        double middle = (low + high) / 2;
+        if (calculateDSTOffset(middle, utcOffset) == before.offset)
+            low = middle;
+        else
+            high = middle;
+    }
+    before.end = low;
+    after.start = high;
+}
+
 // Get the DST offset for the time passed in.
 //
 // NOTE: The implementation relies on the fact that no time zones have
@@ -863,58 +896,54 @@ namespace TI {
 // If this function is called with NaN it returns NaN.
 static double getDSTOffset(TiExcState* exec, double ms, double utcOffset)
 {
-    DSTOffsetCache& cache = exec->globalData().dstOffsetCache;
-    double start = cache.start;
-    double end = cache.end;
-
-    if (start <= ms) {
-        // If the time fits in the cached interval, return the cached offset.
-        if (ms <= end) return cache.offset;
-
-        // Compute a possible new interval end.
-        double newEnd = end + cache.increment;
-
-        if (ms <= newEnd) {
-            double endOffset = calculateDSTOffset(newEnd, utcOffset);
-            if (cache.offset == endOffset) {
-                // If the offset at the end of the new interval still matches
-                // the offset in the cache, we grow the cached time interval
-                // and return the offset.
-                cache.end = newEnd;
-                cache.increment = msPerMonth;
-                return endOffset;
-            } else {
-                double offset = calculateDSTOffset(ms, utcOffset);
-                if (offset == endOffset) {
-                    // The offset at the given time is equal to the offset at the
-                    // new end of the interval, so that means that we've just skipped
-                    // the point in time where the DST offset change occurred. Updated
-                    // the interval to reflect this and reset the increment.
-                    cache.start = ms;
-                    cache.end = newEnd;
-                    cache.increment = msPerMonth;
-                } else {
-                    // The interval contains a DST offset change and the given time is
-                    // before it. Adjust the increment to avoid a linear search for
-                    // the offset change point and change the end of the interval.
-                    cache.increment /= 3;
-                    cache.end = ms;
-                }
-                // Update the offset in the cache and return it.
-                cache.offset = offset;
-                return offset;
-            }
-        }
+    if (isnan(ms))
+        return calculateDSTOffset(ms, utcOffset);
+
+    DSTIntervals& intervals = exec->globalData().dstOffsetCache.intervals;
+
+    // Find the first interval that does not end before the time.
+    size_t index = 0;
+    size_t limit = intervals.size();
+    while (index < limit) {
+        size_t middle = (index + limit) / 2;
+        if (intervals[middle].end < ms)
+            index = middle + 1;
+        else
+            limit = middle;
     }
+    if (index < intervals.size() && intervals[index].start <= ms)
+        return intervals[index].offset;
 
-    // Compute the DST offset for the time and shrink the cache interval
-    // to only contain the time. This allows fast repeated DST offset
-    // computations for the same time.
+    // The time falls in the gap before intervals[index]. If a neighbouring
+    // interval with the same offset is within a month, the offset cannot
+    // have changed in between and that interval grows to cover the time.
     double offset = calculateDSTOffset(ms, utcOffset);
-    cache.offset = offset;
-    cache.start = ms;
-    cache.end = ms;
-    cache.increment = msPerMonth;
+    if (index && intervals[index - 1].offset == offset && ms - intervals[index - 1].end <= msPerMonth)
+        intervals[--index].end = ms;
+    else if (index < intervals.size() && intervals[index].offset == offset && intervals[index].start - ms <= msPerMonth)
+        intervals[index].start = ms;
+    else {
+        if (intervals.size() == DSTOffsetCache::maxIntervals) {
+            intervals.clear();
+            index = 0;
+        }
+
+        // For the same reason, a probe a month to either side that agrees
+        // with the time lets a new interval start out two months wide.
+        DSTOffsetCache::Interval interval = { ms, ms, offset };
+        double probe = ms + msPerMonth;
+        if ((index == intervals.size() || probe < intervals[index].start) && calculateDSTOffset(probe, utcOffset) == offset)
+            interval.end = probe;
+        probe = ms - msPerMonth;
+        if ((!index || probe > intervals[index - 1].end) && calculateDSTOffset(probe, utcOffset) == offset)
+            interval.start = probe;
+        intervals.insert(index, interval);
+    }
+
+    if (index + 1 < intervals.size())
+        settleDSTGap(intervals, index + 1, utcOffset);
+    if (index)
+        settleDSTGap(intervals, index, utcOffset);
     return offset;
 }
 
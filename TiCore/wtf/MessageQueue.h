@@ -138,8 +138,9 @@ namespace WTI {
         MutexLocker lock(m_mutex);
         bool timedOut = false;
 
-        DequeConstIterator<DataType*> found = m_queue.end();
-        while (!m_killed && !timedOut && (found = m_queue.findIf(predicate)) == m_queue.end())
+        // Don't hold an iterator across the wait: appending from another thread can
+        // reallocate the queue, which invalidates any live iterators in debug builds.
+        while (!m_killed && !timedOut && m_queue.findIf(predicate) == m_queue.end())
             timedOut = !m_condition.timedWait(m_mutex, absoluteTime);
 
         ASSERT(!timedOut || absoluteTime != infiniteTime());
@@ -154,6 +155,7 @@ namespace WTI {
             return 0;
         }
 
+        DequeConstIterator<DataType*> found = m_queue.findIf(predicate);
         ASSERT(found != m_queue.end());
         DataType* message = *found;
         m_queue.remove(found);
@@ -0,0 +1,339 @@
+/**
+ * Appcelerator Titanium License
+ * This source code and all modifications done by Appcelerator
+ * are licensed under the Apache Public License (version 2) and
+ * are Copyright (c) 2009 by Appcelerator, Inc.
+ */
+
+/*
+ * Copyright (C) 2009 Apple Computer, Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE COMPUTER, INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE COMPUTER, INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+
+#ifndef WTF_TimSort_h
+#define WTF_TimSort_h
+
+#include <algorithm>
+#include <wtf/Assertions.h>
+#include <wtf/Noncopyable.h>
+
+namespace WTI {
+
+    // A stable, adaptive merge sort after Tim Peters' listsort. Ascending and
+    // strictly descending runs already in the input are found and extended to
+    // a minimum length by binary insertion, then merged in an order that keeps
+    // the merges balanced. Sorted or reverse sorted input costs count - 1
+    // comparisons.
+    //
+    // lessThan(a, b) should be a strict weak ordering; if it is not, the values
+    // end up in some order but are still all there. buffer must have room for
+    // count / 2 values.
+    template<typename T, typename LessThan> class TimSorter : public Noncopyable {
+    public:
+        TimSorter(T* values, T* buffer, LessThan& lessThan)
+            : m_values(values)
+            , m_buffer(buffer)
+            , m_lessThan(lessThan)
+            , m_runCount(0)
+        {
+        }
+
+        void sort(size_t count);
+
+    private:
+        static const size_t minMerge = 32;
+        // Merging keeps each pending run longer than the two above it, so the
+        // lengths grow at least as fast as the Fibonacci numbers.
+        static const size_t maxRuns = 96;
+
+        struct Run {
+            size_t base;
+            size_t length;
+        };
+
+        static size_t minRunLength(size_t);
+        size_t countRunAndMakeAscending(size_t begin, size_t end);
+        void binaryInsertionSort(size_t begin, size_t end, size_t sortedEnd);
+        size_t lowerBound(const T& key, const T* base, size_t length);
+        size_t upperBound(const T& key, const T* base, size_t length);
+        void pushRun(size_t base, size_t length);
+        void mergeCollapse();
+        void mergeForceCollapse();
+        void mergeAt(size_t);
+        void mergeLow(size_t base1, size_t length1, size_t length2);
+        void mergeHigh(size_t base1, size_t length1, size_t length2);
+
+        T* m_values;
+        T* m_buffer;
+        LessThan& m_lessThan;
+        Run m_runs[maxRuns];
+        size_t m_runCount;
+    };
+
+    template<typename T, typename LessThan>
+    void TimSorter<T, LessThan>::sort(size_t count)
+    {
+        if (count < 2)
+            return;
+
+        if (count < minMerge) {
+            binaryInsertionSort(0, count, countRunAndMakeAscending(0, count));
+            return;
+        }
+
+        size_t minRun = minRunLength(count);
+        size_t begin = 0;
+        do {
+            size_t runLength = countRunAndMakeAscending(begin, count);
+            if (runLength < minRun) {
+                size_t forcedLength = std::min(count - begin, minRun);
+                binaryInsertionSort(begin, begin + forcedLength, begin + runLength);
+                runLength = forcedLength;
+            }
+            pushRun(begin, runLength);
+            mergeCollapse();
+            begin += runLength;
+        } while (begin < count);
+
+        mergeForceCollapse();
+        ASSERT(m_runCount == 1 && m_runs[0].length == count);
+    }
+
+    // Returns a length between minMerge / 2 and minMerge that divides count
+    // into a power of two runs, or slightly fewer.
+    template<typename T, typename LessThan>
+    size_t TimSorter<T, LessThan>::minRunLength(size_t count)
+    {
+        size_t remainder = 0;
+        while (count >= minMerge) {
+            remainder |= count & 1;
+            count >>= 1;
+        }
+        return count + remainder;
+    }
+
+    template<typename T, typename LessThan>
+    size_t TimSorter<T, LessThan>::countRunAndMakeAscending(size_t begin, size_t end)
+    {
+        size_t runEnd = begin + 1;
+        if (runEnd == end)
+            return 1;
+
+        // A descending run must be strict, so that reversing it keeps the sort stable.
+        if (m_lessThan(m_values[runEnd++], m_values[begin])) {
+            while (runEnd < end && m_lessThan(m_values[runEnd], m_values[runEnd - 1]))
+                ++runEnd;
+            std::reverse(m_values + begin, m_values + runEnd);
+        } else {
+            while (runEnd < end && !m_lessThan(m_values[runEnd], m_values[runEnd - 1]))
+                ++runEnd;
+        }
+        return runEnd - begin;
+    }
+
+    template<typename T, typename LessThan>
+    void TimSorter<T, LessThan>::binaryInsertionSort(size_t begin, size_t end, size_t sortedEnd)
+    {
+        if (sortedEnd == begin)
+            ++sortedEnd;
+
+        for (; sortedEnd < end; ++sortedEnd) {
+            T pivot = m_values[sortedEnd];
+            size_t position = begin + upperBound(pivot, m_values + begin, sortedEnd - begin);
+            for (size_t i = sortedEnd; i > position; --i)
+                m_values[i] = m_values[i - 1];
+            m_values[position] = pivot;
+        }
+    }
+
+    // The first position in the sorted range whose value is not less than key.
+    template<typename T, typename LessThan>
+    size_t TimSorter<T, LessThan>::lowerBound(const T& key, const T* base, size_t length)
+    {
+        size_t low = 0;
+        while (length) {
+            size_t half = length >> 1;
+            if (m_lessThan(base[low + half], key)) {
+                low += half + 1;
+                length -= half + 1;
+            } else
+                length = half;
+        }
+        return low;
+    }
+
+    // The first position in the sorted range whose value key is less than.
+    template<typename T, typename LessThan>
+    size_t TimSorter<T, LessThan>::upperBound(const T& key, const T* base, size_t length)
+    {
+        size_t low = 0;
+        while (length) {
+            size_t half = length >> 1;
+            if (m_lessThan(key, base[low + half]))
+                length = half;
+            else {
+                low += half + 1;
+                length -= half + 1;
+            }
+        }
+        return low;
+    }
+
+    template<typename T, typename LessThan>
+    void TimSorter<T, LessThan>::pushRun(size_t base, size_t length)
+    {
+        ASSERT(m_runCount < maxRuns);
+        m_runs[m_runCount].base = base;
+        m_runs[m_runCount].length = length;
+        ++m_runCount;
+    }
+
+    // Merges pending runs until, from the bottom of the stack up, each run is
+    // longer than the two above it together, and each run is longer than the
+    // one above it. This checks three runs down, not two as listsort did,
+    // which is needed for the invariant to hold throughout the stack.
+    template<typename T, typename LessThan>
+    void TimSorter<T, LessThan>::mergeCollapse()
+    {
+        while (m_runCount > 1) {
+            size_t n = m_runCount - 2;
+            if ((n > 0 && m_runs[n - 1].length <= m_runs[n].length + m_runs[n + 1].length)
+                || (n > 1 && m_runs[n - 2].length <= m_runs[n - 1].length + m_runs[n].length)) {
+                if (m_runs[n - 1].length < m_runs[n + 1].length)
+                    --n;
+            } else if (m_runs[n].length > m_runs[n + 1].length)
+                break;
+            mergeAt(n);
+        }
+    }
+
+    template<typename T, typename LessThan>
+    void TimSorter<T, LessThan>::mergeForceCollapse()
+    {
+        while (m_runCount > 1) {
+            size_t n = m_runCount - 2;
+            if (n > 0 && m_runs[n - 1].length < m_runs[n + 1].length)
+                --n;
+            mergeAt(n);
+        }
+    }
+
+    template<typename T, typename LessThan>
+    void TimSorter<T, LessThan>::mergeAt(size_t i)
+    {
+        ASSERT(i + 2 == m_runCount || i + 3 == m_runCount);
+
+        size_t base1 = m_runs[i].base;
+        size_t length1 = m_runs[i].length;
+        size_t base2 = m_runs[i + 1].base;
+        size_t length2 = m_runs[i + 1].length;
+        ASSERT(base1 + length1 == base2);
+
+        m_runs[i].length = length1 + length2;
+        if (i + 3 == m_runCount)
+            m_runs[i + 1] = m_runs[i + 2];
+        --m_runCount;
+
+        // Values at the start of the first run that are not greater than the
+        // second run's first value are already in place.
+        size_t inPlace = upperBound(m_values[base2], m_values + base1, length1);
+        base1 += inPlace;
+        length1 -= inPlace;
+        if (!length1)
+            return;
+
+        // So are values at the end of the second run that are not less than
+        // the first run's last value.
+        length2 = lowerBound(m_values[base1 + length1 - 1], m_values + base2, length2);
+        if (!length2)
+            return;
+
+        if (length1 <= length2)
+            mergeLow(base1, length1, length2);
+        else
+            mergeHigh(base1, length1, length2);
+    }
+
+    // Merges from the front, with the shorter first run moved to the buffer.
+    template<typename T, typename LessThan>
+    void TimSorter<T, LessThan>::mergeLow(size_t base1, size_t length1, size_t length2)
+    {
+        T* values = m_values;
+        T* buffer = m_buffer;
+        for (size_t i = 0; i < length1; ++i)
+            buffer[i] = values[base1 + i];
+
+        size_t destination = base1;
+        size_t cursor1 = 0;
+        size_t cursor2 = base1 + length1;
+        size_t end2 = cursor2 + length2;
+        while (cursor1 < length1 && cursor2 < end2) {
+            if (m_lessThan(values[cursor2], buffer[cursor1]))
+                values[destination++] = values[cursor2++];
+            else
+                values[destination++] = buffer[cursor1++];
+        }
+
+        // Whatever is left of the second run is already in place.
+        while (cursor1 < length1)
+            values[destination++] = buffer[cursor1++];
+    }
+
+    // Merges from the back, with the shorter second run moved to the buffer.
+    template<typename T, typename LessThan>
+    void TimSorter<T, LessThan>::mergeHigh(size_t base1, size_t length1, size_t length2)
+    {
+        T* values = m_values;
+        T* buffer = m_buffer;
+        for (size_t i = 0; i < length2; ++i)
+            buffer[i] = values[base1 + length1 + i];
+
+        size_t remaining1 = length1;
+        size_t remaining2 = length2;
+        while (remaining1 && remaining2) {
+            if (m_lessThan(buffer[remaining2 - 1], values[base1 + remaining1 - 1])) {
+                values[base1 + remaining1 + remaining2 - 1] = values[base1 + remaining1 - 1];
+                --remaining1;
+            } else {
+                values[base1 + remaining1 + remaining2 - 1] = buffer[remaining2 - 1];
+                --remaining2;
+            }
+        }
+
+        // Whatever is left of the first run is already in place.
+        for (size_t i = 0; i < remaining2; ++i)
+            values[base1 + i] = buffer[i];
+    }
+
+    template<typename T, typename LessThan>
+    inline void timSort(T* values, size_t count, T* buffer, LessThan& lessThan)
+    {
+        TimSorter<T, LessThan>(values, buffer, lessThan).sort(count);
+    }
+
+} // namespace WTI
+
+using WTI::timSort;
+
+#endif // WTF_TimSort_h
@@ -1102,6 +1102,377 @@ static void hexnan(U* rvp, const char** sp)
 #endif /*No_Hex_NaN*/
 #endif /* INFNAN_CHECK */
 
+/* Fast paths for strtod and dtoa, after Florian Loitsch's "Printing
+ * Floating-Point Numbers Quickly and Accurately with Integers" (Grisu3) and
+ * the extended-precision strtod of the double-conversion library. Both work
+ * on DiyFp values, a 64-bit significand with a binary exponent, and report
+ * when their error bounds cannot guarantee the correct result, in which case
+ * the Bigint algorithms below are used instead.
+ */
+
+struct DiyFp {
+    uint64_t f;
+    int e;
+};
+
+static const int diyFpSignificandSize = 64;
+static const int doubleSignificandSize = 53;
+static const int doubleExponentBias = 0x3ff + 52;
+static const int doubleDenormalExponent = 1 - doubleExponentBias;
+static const int doubleMaxExponent = 0x7ff - doubleExponentBias;
+static const uint64_t doubleHiddenBit = 1ULL << 52;
+static const uint64_t doubleSignificandMask = doubleHiddenBit - 1;
+
+static inline DiyFp makeDiyFp(uint64_t f, int e)
+{
+    DiyFp result;
+    result.f = f;
+    result.e = e;
+    return result;
+}
+
+static inline DiyFp normalizeDiyFp(DiyFp a)
+{
+    ASSERT(a.f);
+    while (!(a.f & 0xffc0000000000000ULL)) {
+        a.f <<= 10;
+        a.e -= 10;
+    }
+    while (!(a.f & 0x8000000000000000ULL)) {
+        a.f <<= 1;
+        a.e -= 1;
+    }
+    return a;
+}
+
+/* The product rounded to 64 bits; the error is at most half a unit in the last place. */
+static inline DiyFp multiplyDiyFp(DiyFp x, DiyFp y)
+{
+    uint64_t a = x.f >> 32;
+    uint64_t b = x.f & 0xffffffff;
+    uint64_t c = y.f >> 32;
+    uint64_t d = y.f & 0xffffffff;
+    uint64_t ac = a * c;
+    uint64_t bc = b * c;
+    uint64_t ad = a * d;
+    uint64_t bd = b * d;
+    uint64_t tmp = (bd >> 32) + (ad & 0xffffffff) + (bc & 0xffffffff);
+    tmp += 1U << 31;
+    return makeDiyFp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64);
+}
+
+struct CachedPower {
+    uint64_t significand;
+    int16_t binaryExponent;
+    int16_t decimalExponent;
+};
+
+/* 10^k for k = -348, -340, ..., 340, rounded to 64-bit significands. */
+static const CachedPower cachedPowers[] = {
+    { 0xfa8fd5a0081c0288ULL, -1220, -348 },
+    { 0xbaaee17fa23ebf76ULL, -1193, -340 },
+    { 0x8b16fb203055ac76ULL, -1166, -332 },
+    { 0xcf42894a5dce35eaULL, -1140, -324 },
+    { 0x9a6bb0aa55653b2dULL, -1113, -316 },
+    { 0xe61acf033d1a45dfULL, -1087, -308 },
+    { 0xab70fe17c79ac6caULL, -1060, -300 },
+    { 0xff77b1fcbebcdc4fULL, -1034, -292 },
+    { 0xbe5691ef416bd60cULL, -1007, -284 },
+    { 0x8dd01fad907ffc3cULL, -980, -276 },
+    { 0xd3515c2831559a83ULL, -954, -268 },
+    { 0x9d71ac8fada6c9b5ULL, -927, -260 },
+    { 0xea9c227723ee8bcbULL, -901, -252 },
+    { 0xaecc49914078536dULL, -874, -244 },
+    { 0x823c12795db6ce57ULL, -847, -236 },
+    { 0xc21094364dfb5637ULL, -821, -228 },
+    { 0x9096ea6f3848984fULL, -794, -220 },
+    { 0xd77485cb25823ac7ULL, -768, -212 },
+    { 0xa086cfcd97bf97f4ULL, -741, -204 },
+    { 0xef340a98172aace5ULL, -715, -196 },
+    { 0xb23867fb2a35b28eULL, -688, -188 },
+    { 0x84c8d4dfd2c63f3bULL, -661, -180 },
+    { 0xc5dd44271ad3cdbaULL, -635, -172 },
+    { 0x936b9fcebb25c996ULL, -608, -164 },
+    { 0xdbac6c247d62a584ULL, -582, -156 },
+    { 0xa3ab66580d5fdaf6ULL, -555, -148 },
+    { 0xf3e2f893dec3f126ULL, -529, -140 },
+    { 0xb5b5ada8aaff80b8ULL, -502, -132 },
+    { 0x87625f056c7c4a8bULL, -475, -124 },
+    { 0xc9bcff6034c13053ULL, -449, -116 },
+    { 0x964e858c91ba2655ULL, -422, -108 },
+    { 0xdff9772470297ebdULL, -396, -100 },
+    { 0xa6dfbd9fb8e5b88fULL, -369, -92 },
+    { 0xf8a95fcf88747d94ULL, -343, -84 },
+    { 0xb94470938fa89bcfULL, -316, -76 },
+    { 0x8a08f0f8bf0f156bULL, -289, -68 },
+    { 0xcdb02555653131b6ULL, -263, -60 },
+    { 0x993fe2c6d07b7facULL, -236, -52 },
+    { 0xe45c10c42a2b3b06ULL, -210, -44 },
+    { 0xaa242499697392d3ULL, -183, -36 },
+    { 0xfd87b5f28300ca0eULL, -157, -28 },
+    { 0xbce5086492111aebULL, -130, -20 },
+    { 0x8cbccc096f5088ccULL, -103, -12 },
+    { 0xd1b71758e219652cULL, -77, -4 },
+    { 0x9c40000000000000ULL, -50, 4 },
+    { 0xe8d4a51000000000ULL, -24, 12 },
+    { 0xad78ebc5ac620000ULL, 3, 20 },
+    { 0x813f3978f8940984ULL, 30, 28 },
+    { 0xc097ce7bc90715b3ULL, 56, 36 },
+    { 0x8f7e32ce7bea5c70ULL, 83, 44 },
+    { 0xd5d238a4abe98068ULL, 109, 52 },
+    { 0x9f4f2726179a2245ULL, 136, 60 },
+    { 0xed63a231d4c4fb27ULL, 162, 68 },
+    { 0xb0de65388cc8ada8ULL, 189, 76 },
+    { 0x83c7088e1aab65dbULL, 216, 84 },
+    { 0xc45d1df942711d9aULL, 242, 92 },
+    { 0x924d692ca61be758ULL, 269, 100 },
+    { 0xda01ee641a708deaULL, 295, 108 },
+    { 0xa26da3999aef774aULL, 322, 116 },
+    { 0xf209787bb47d6b85ULL, 348, 124 },
+    { 0xb454e4a179dd1877ULL, 375, 132 },
+    { 0x865b86925b9bc5c2ULL, 402, 140 },
+    { 0xc83553c5c8965d3dULL, 428, 148 },
+    { 0x952ab45cfa97a0b3ULL, 455, 156 },
+    { 0xde469fbd99a05fe3ULL, 481, 164 },
+    { 0xa59bc234db398c25ULL, 508, 172 },
+    { 0xf6c69a72a3989f5cULL, 534, 180 },
+    { 0xb7dcbf5354e9beceULL, 561, 188 },
+    { 0x88fcf317f22241e2ULL, 588, 196 },
+    { 0xcc20ce9bd35c78a5ULL, 614, 204 },
+    { 0x98165af37b2153dfULL, 641, 212 },
+    { 0xe2a0b5dc971f303aULL, 667, 220 },
+    { 0xa8d9d1535ce3b396ULL, 694, 228 },
+    { 0xfb9b7cd9a4a7443cULL, 720, 236 },
+    { 0xbb764c4ca7a44410ULL, 747, 244 },
+    { 0x8bab8eefb6409c1aULL, 774, 252 },
+    { 0xd01fef10a657842cULL, 800, 260 },
+    { 0x9b10a4e5e9913129ULL, 827, 268 },
+    { 0xe7109bfba19c0c9dULL, 853, 276 },
+    { 0xac2820d9623bf429ULL, 880, 284 },
+    { 0x80444b5e7aa7cf85ULL, 907, 292 },
+    { 0xbf21e44003acdd2dULL, 933, 300 },
+    { 0x8e679c2f5e44ff8fULL, 960, 308 },
+    { 0xd433179d9c8cb841ULL, 986, 316 },
+    { 0x9e19db92b4e31ba9ULL, 1013, 324 },
+    { 0xeb96bf6ebadf77d9ULL, 1039, 332 },
+    { 0xaf87023b9bf0ee6bULL, 1066, 340 },
+};
+
+static const int cachedPowersOffset = 348;
+static const int cachedPowersDecimalDistance = 8;
+static const int cachedPowersMinDecimalExponent = -348;
+static const int cachedPowersMaxDecimalExponent = 340;
+
+/* Grisu3 needs the scaled value's binary exponent in this range. */
+static const int grisuMinimalTargetExponent = -60;
+static const int grisuMaximalTargetExponent = -32;
+
+static inline DiyFp cachedPowerForBinaryExponent(int minExponent, int* decimalExponent)
+{
+    int k = static_cast<int>(ceil((minExponent + diyFpSignificandSize - 1) * 0.30102999566398114));
+    int index = (cachedPowersOffset + k - 1) / cachedPowersDecimalDistance + 1;
+    const CachedPower& power = cachedPowers[index];
+    *decimalExponent = power.decimalExponent;
+    return makeDiyFp(power.significand, power.binaryExponent);
+}
+
+static inline DiyFp cachedPowerForDecimalExponent(int requestedExponent, int* decimalExponent)
+{
+    ASSERT(requestedExponent >= cachedPowersMinDecimalExponent && requestedExponent <= cachedPowersMaxDecimalExponent);
+    int index = (requestedExponent + cachedPowersOffset) / cachedPowersDecimalDistance;
+    const CachedPower& power = cachedPowers[index];
+    *decimalExponent = power.decimalExponent;
+    return makeDiyFp(power.significand, power.binaryExponent);
+}
+
+/* Moves the last generated digit towards w while that keeps it inside the
+ * rounding interval, then checks that the result is provably the closest
+ * shortest representation. */
+static bool grisuRoundWeed(char* buffer, int length, uint64_t distanceTooHighW, uint64_t unsafeInterval, uint64_t rest, uint64_t tenKappa, uint64_t unit)
+{
+    uint64_t smallDistance = distanceTooHighW - unit;
+    uint64_t bigDistance = distanceTooHighW + unit;
+    while (rest < smallDistance && unsafeInterval - rest >= tenKappa
+        && (rest + tenKappa < smallDistance || smallDistance - rest >= rest + tenKappa - smallDistance)) {
+        buffer[length - 1]--;
+        rest += tenKappa;
+    }
+    if (rest < bigDistance && unsafeInterval - rest >= tenKappa
+        && (rest + tenKappa < bigDistance || bigDistance - rest > rest + tenKappa - bigDistance))
+        return false;
+    return (2 * unit <= rest) && (rest <= unsafeInterval - 4 * unit);
+}
+
+static const uint32_t smallPowersOfTen[] = { 0, 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+static bool grisuDigitGen(DiyFp low, DiyFp w, DiyFp high, char* buffer, int* length, int* kappa)
+{
+    ASSERT(low.e == w.e && w.e == high.e);
+    ASSERT(grisuMinimalTargetExponent <= w.e && w.e <= grisuMaximalTargetExponent);
+    uint64_t unit = 1;
+    DiyFp tooLow = makeDiyFp(low.f - unit, low.e);
+    DiyFp tooHigh = makeDiyFp(high.f + unit, high.e);
+    uint64_t unsafeInterval = tooHigh.f - tooLow.f;
+    int oneShift = -w.e;
+    uint64_t one = 1ULL << oneShift;
+    uint32_t integrals = static_cast<uint32_t>(tooHigh.f >> oneShift);
+    uint64_t fractionals = tooHigh.f & (one - 1);
+
+    int divisorExponentPlusOne = 10;
+    while (divisorExponentPlusOne > 0 && integrals < smallPowersOfTen[divisorExponentPlusOne])
+        --divisorExponentPlusOne;
+    uint32_t divisor = smallPowersOfTen[divisorExponentPlusOne];
+
+    *kappa = divisorExponentPlusOne;
+    *length = 0;
+    while (*kappa > 0) {
+        buffer[(*length)++] = static_cast<char>('0' + integrals / divisor);
+        integrals %= divisor;
+        (*kappa)--;
+        uint64_t rest = (static_cast<uint64_t>(integrals) << oneShift) + fractionals;
+        if (rest < unsafeInterval)
+            return grisuRoundWeed(buffer, *length, tooHigh.f - w.f, unsafeInterval, rest, static_cast<uint64_t>(divisor) << oneShift, unit);
+        divisor /= 10;
+    }
+
+    for (;;) {
+        fractionals *= 10;
+        unit *= 10;
+        unsafeInterval *= 10;
+        buffer[(*length)++] = static_cast<char>('0' + (fractionals >> oneShift));
+        fractionals &= one - 1;
+        (*kappa)--;
+        if (fractionals < unsafeInterval)
+            return grisuRoundWeed(buffer, *length, (tooHigh.f - w.f) * unit, unsafeInterval, fractionals, one, unit);
+    }
+}
+
+/* Writes the shortest digits that read back as the positive, finite, nonzero
+ * u, and sets *decpt as dtoa does. Returns false when Grisu3 cannot prove its
+ * digits correct. */
+static bool grisuShortest(U* u, char* buffer, int* length, int* decpt)
+{
+    uint64_t bits = (static_cast<uint64_t>(word0(u)) << 32) | word1(u);
+    int biasedExponent = static_cast<int>(bits >> 52) & 0x7ff;
+    DiyFp v;
+    if (biasedExponent) {
+        v.f = (bits & doubleSignificandMask) | doubleHiddenBit;
+        v.e = biasedExponent - doubleExponentBias;
+    } else {
+        v.f = bits & doubleSignificandMask;
+        v.e = doubleDenormalExponent;
+    }
+
+    DiyFp w = normalizeDiyFp(v);
+    DiyFp boundaryPlus = normalizeDiyFp(makeDiyFp((v.f << 1) + 1, v.e - 1));
+    DiyFp boundaryMinus;
+    if (!(bits & doubleSignificandMask) && biasedExponent > 1)
+        boundaryMinus = makeDiyFp((v.f << 2) - 1, v.e - 2); /* The lower boundary is closer. */
+    else
+        boundaryMinus = makeDiyFp((v.f << 1) - 1, v.e - 1);
+    boundaryMinus.f <<= boundaryMinus.e - boundaryPlus.e;
+    boundaryMinus.e = boundaryPlus.e;
+    ASSERT(boundaryPlus.e == w.e);
+
+    int mk;
+    DiyFp tenMk = cachedPowerForBinaryExponent(grisuMinimalTargetExponent - (w.e + diyFpSignificandSize), &mk);
+
+    int kappa;
+    bool result = grisuDigitGen(multiplyDiyFp(boundaryMinus, tenMk), multiplyDiyFp(w, tenMk), multiplyDiyFp(boundaryPlus, tenMk), buffer, length, &kappa);
+    *decpt = *length - mk + kappa;
+    return result;
+}
+
+/* Converts nd decimal digits starting at s0, with a decimal point after the
+ * first nd0 of them when nd0 < nd, times 10^e. Only results in the range of
+ * normal doubles are produced; everything else, and any case too close to
+ * call, is left to the Bigint algorithm. */
+static bool diyFpStrtod(const char* s0, int nd, int nd0, int e, U* rv)
+{
+    static const int maxUint64DecimalDigits = 19;
+    static const int denominatorLog = 3;
+    static const int denominator = 1 << denominatorLog;
+    static const DiyFp adjustmentPowers[] = {
+        { 0xa000000000000000ULL, -60 },
+        { 0xc800000000000000ULL, -57 },
+        { 0xfa00000000000000ULL, -54 },
+        { 0x9c40000000000000ULL, -50 },
+        { 0xc350000000000000ULL, -47 },
+        { 0xf424000000000000ULL, -44 },
+        { 0x9896800000000000ULL, -40 },
+    };
+
+    /* Read up to 19 digits exactly; the rest are rounded into an error of half a unit. */
+    uint64_t significand = 0;
+    int read = 0;
+    const char* s = s0;
+    for (; read < nd && read < maxUint64DecimalDigits; ++read, ++s) {
+        if (read == nd0)
+            ++s;
+        significand = significand * 10 + (*s - '0');
+    }
+    int exponent = e + nd - read;
+    uint64_t error = 0;
+    if (read < nd) {
+        if (read == nd0)
+            ++s;
+        if (*s >= '5')
+            ++significand;
+        error = denominator / 2;
+    }
+
+    if (exponent < cachedPowersMinDecimalExponent || exponent > cachedPowersMaxDecimalExponent)
+        return false;
+
+    DiyFp input = makeDiyFp(significand, 0);
+    DiyFp normalized = normalizeDiyFp(input);
+    error <<= input.e - normalized.e;
+    input = normalized;
+
+    int cachedDecimalExponent;
+    DiyFp cachedPower = cachedPowerForDecimalExponent(exponent, &cachedDecimalExponent);
+    if (int adjustment = exponent - cachedDecimalExponent) {
+        input = multiplyDiyFp(input, adjustmentPowers[adjustment - 1]);
+        /* The adjustment powers are exact; the product is too if it fits in 64 bits. */
+        if (maxUint64DecimalDigits - read < adjustment)
+            error += denominator / 2;
+    }
+
+    input = multiplyDiyFp(input, cachedPower);
+    /* Half a unit each for the cached power and the multiplication, and one for the input's error. */
+    error += denominator / 2 + (error ? 1 : 0) + denominator / 2;
+
+    normalized = normalizeDiyFp(input);
+    error <<= input.e - normalized.e;
+    input = normalized;
+
+    /* Results that are denormal, or nearly so, take fewer than 53 significant bits. */
+    if (diyFpSignificandSize + input.e < doubleDenormalExponent + doubleSignificandSize)
+        return false;
+
+    static const int precisionBitsCount = diyFpSignificandSize - doubleSignificandSize;
+    uint64_t precisionBits = (input.f & ((1ULL << precisionBitsCount) - 1)) * denominator;
+    uint64_t halfWay = (1ULL << (precisionBitsCount - 1)) * denominator;
+    if (error >= halfWay || (halfWay - error < precisionBits && precisionBits < halfWay + error))
+        return false;
+
+    uint64_t resultSignificand = input.f >> precisionBitsCount;
+    int resultExponent = input.e + precisionBitsCount;
+    if (precisionBits >= halfWay + error) {
+        if (++resultSignificand > (doubleHiddenBit | doubleSignificandMask)) {
+            resultSignificand >>= 1;
+            ++resultExponent;
+        }
+    }
+    if (resultExponent >= doubleMaxExponent)
+        return false;
+
+    uint64_t bits = (static_cast<uint64_t>(resultExponent + doubleExponentBias) << 52) | (resultSignificand & doubleSignificandMask);
+    word0(rv) = static_cast<uint32_t>(bits >> 32);
+    word1(rv) = static_cast<uint32_t>(bits);
+    return true;
+}
+
 double strtod(const char* s00, char** se)
 {
 #ifdef Avoid_Underflow
@@ -1303,6 +1674,9 @@ ret0:
         }
 #endif
     }
+    if (diyFpStrtod(s0, nd, nd0, e, &rv))
+        goto ret;
+
     e1 += nd - k;
 
 #ifdef SET_INEXACT
@@ -1928,6 +2302,16 @@ void dtoa(char* result, double dd, int ndigits, int* decpt, int* sign, char** rv
         return;
     }
 
+    {
+        int length;
+        if (grisuShortest(&u, result, &length, decpt)) {
+            result[length] = '\0';
+            if (rve)
+                *rve = result + length;
+            return;
+        }
+    }
+
 #ifdef SET_INEXACT
     try_quick = oldinexact = get_inexact();
     inexact = 1;
@@ -491,7 +491,7 @@ public:
             PatternTerm& term = currentAlternative->lastTerm();
             ASSERT((term.type == PatternTerm::TypeParenthesesSubpattern) || (term.type == PatternTerm::TypeParentheticalAssertion));
 
-            if ((term.type == PatternTerm::TypeParenthesesSubpattern) && term.invertOrCapture && (subpatternId == term.subpatternId)) {
+            if ((term.type == PatternTerm::TypeParenthesesSubpattern) && term.invertOrCapture && (subpatternId == term.parentheses.subpatternId)) {
                 m_alternative->m_terms.append(PatternTerm::ForwardReference());
                 return;
             }
@@ -641,9 +641,11 @@ public:
                     }
                     term.inputPosition = currentInputPosition;
                 } else {
+                    // The interpreter gives each iteration a frame of its own; the JIT keeps
+                    // the current iteration's frame within this one, after the backtrack info.
                     term.inputPosition = currentInputPosition;
-                    setupDisjunctionOffsets(term.parentheses.disjunction, 0, currentInputPosition);
-                    currentCallFrameSize += RegexStackSpaceForBackTrackInfoParentheses;
+                    unsigned parenthesesCallFrameSize = setupDisjunctionOffsets(term.parentheses.disjunction, 0, currentInputPosition);
+                    currentCallFrameSize += RegexStackSpaceForBackTrackInfoParentheses + parenthesesCallFrameSize;
                 }
                 // Fixed count of 1 could be accepted, if they have a fixed size *AND* if all alternatives are of the same length.
                 alternative->m_hasFixedSize = false;
@@ -692,6 +694,25 @@ public:
         setupDisjunctionOffsets(m_pattern.m_body, 0, 0);
     }
 
+    // A pattern with a single alternative that starts with literal characters can
+    // only match where those characters occur; record them so the matcher need
+    // only be entered there.
+    void setupLiteralPrefix()
+    {
+        m_pattern.m_literalPrefix.clear();
+        if (m_pattern.m_ignoreCase || (m_pattern.m_body->m_alternatives.size() != 1))
+            return;
+
+        Vector<PatternTerm>& terms = m_pattern.m_body->m_alternatives[0]->m_terms;
+        for (unsigned i = 0; i < terms.size(); ++i) {
+            PatternTerm& term = terms[i];
+            if ((term.type != PatternTerm::TypePatternCharacter) || (term.quantityType != QuantifierFixedCount))
+                break;
+            for (unsigned j = 0; j < term.quantityCount; ++j)
+                m_pattern.m_literalPrefix.append(term.patternCharacter);
+        }
+    }
+
 private:
     RegexPattern& m_pattern;
     PatternAlternative* m_alternative;
@@ -725,6 +746,7 @@ const char* compileRegex(const UString& patternString, RegexPattern& pattern)
     }
 
     constructor.setupOffsets();
+    constructor.setupLiteralPrefix();
 
     return false;
 };
@@ -111,7 +111,8 @@ public:
 
     DisjunctionContext* allocDisjunctionContext(ByteDisjunction* disjunction)
     {
-        return new(malloc(sizeof(DisjunctionContext) + (disjunction->m_frameSize - 1) * sizeof(uintptr_t))) DisjunctionContext();
+        size_t size = sizeof(DisjunctionContext) - sizeof(uintptr_t) + disjunction->m_frameSize * sizeof(uintptr_t);
+        return new(malloc(size)) DisjunctionContext();
     }
 
     void freeDisjunctionContext(DisjunctionContext* context)
@@ -157,7 +158,9 @@ public:
 
     ParenthesesDisjunctionContext* allocParenthesesDisjunctionContext(ByteDisjunction* disjunction, int* output, ByteTerm& term)
     {
-        return new(malloc(sizeof(ParenthesesDisjunctionContext) + (((term.atom.parenthesesDisjunction->m_numSubpatterns << 1) - 1) * sizeof(int)) + sizeof(DisjunctionContext) + (disjunction->m_frameSize - 1) * sizeof(uintptr_t))) ParenthesesDisjunctionContext(output, term);
+        // Both contexts end in a one-element array, and either count may be zero.
+        size_t size = sizeof(ParenthesesDisjunctionContext) - sizeof(int) + (term.atom.parenthesesDisjunction->m_numSubpatterns << 1) * sizeof(int) + sizeof(DisjunctionContext) - sizeof(uintptr_t) + disjunction->m_frameSize * sizeof(uintptr_t);
+        return new(malloc(size)) ParenthesesDisjunctionContext(output, term);
     }
 
     void freeParenthesesDisjunctionContext(ParenthesesDisjunctionContext* context)
@@ -343,7 +346,15 @@ public:
             return false;
 
         for (int i = 0; i < matchSize; ++i) {
-            if (!checkCharacter(input.reread(matchBegin + i), inputOffset - matchSize + i)) {
+            int ch = input.reread(matchBegin + i);
+            bool matched;
+            if (pattern->m_ignoreCase) {
+                int lo = Unicode::toLower(ch);
+                int hi = Unicode::toUpper(ch);
+                matched = (lo == hi) ? checkCharacter(ch, inputOffset - matchSize + i) : checkCasedCharacter(lo, hi, inputOffset - matchSize + i);
+            } else
+                matched = checkCharacter(ch, inputOffset - matchSize + i);
+            if (!matched) {
                 input.uncheckInput(matchSize);
                 return false;
             }
@@ -510,11 +521,13 @@ public:
 
         int matchBegin = output[(term.atom.subpatternId << 1)];
         int matchEnd = output[(term.atom.subpatternId << 1) + 1];
-        ASSERT((matchBegin == -1) == (matchEnd == -1));
-        ASSERT(matchBegin <= matchEnd);
 
-        if (matchBegin == matchEnd)
+        // A subpattern that has not finished matching has no end yet; a reference
+        // to it matches the empty string, as does one to a subpattern that has not
+        // matched at all.
+        if ((matchEnd == -1) || (matchBegin == matchEnd))
             return true;
+        ASSERT((matchBegin != -1) && (matchBegin < matchEnd));
 
         switch (term.atom.quantityType) {
         case QuantifierFixedCount: {
@@ -553,11 +566,10 @@ public:
 
         int matchBegin = output[(term.atom.subpatternId << 1)];
         int matchEnd = output[(term.atom.subpatternId << 1) + 1];
-        ASSERT((matchBegin == -1) == (matchEnd == -1));
-        ASSERT(matchBegin <= matchEnd);
 
-        if (matchBegin == matchEnd)
+        if ((matchEnd == -1) || (matchBegin == matchEnd))
             return false;
+        ASSERT((matchBegin != -1) && (matchBegin < matchEnd));
 
         switch (term.atom.quantityType) {
         case QuantifierFixedCount:
@@ -601,10 +613,10 @@ public:
     }
     void resetAssertionMatches(ByteTerm& term)
     {
-        unsigned firstSubpatternId = term.atom.subpatternId;
-        unsigned count = term.atom.parenthesesDisjunction->m_numSubpatterns;
-        for (unsigned i = 0; i < (count << 1); ++i)
-            output[(firstSubpatternId << 1) + i] = -1;
+        for (unsigned subpatternId = term.atom.subpatternId; subpatternId <= term.atom.lastSubpatternId; ++subpatternId) {
+            output[(subpatternId << 1)] = -1;
+            output[(subpatternId << 1) + 1] = -1;
+        }
     }
     bool parenthesesDoBacktrack(ByteTerm& term, BackTrackInfoParentheses* backTrack)
     {
@@ -712,7 +724,7 @@ public:
                 backTrack->inParentheses = 1;
                 if (term.capture()) {
                     unsigned subpatternId = term.atom.subpatternId;
-                    output[(subpatternId << 1) + 1] = input.getPos() + term.inputPosition;
+                    output[(subpatternId << 1)] = input.getPos() + term.inputPosition;
                 }
                 context->term -= term.atom.parenthesesWidth;
                 return true;
@@ -744,8 +756,10 @@ public:
 
         input.setPos(backTrack->begin);
 
-        // We've reached the end of the parens; if they are inverted, this is failure.
+        // We've reached the end of the parens; if they are inverted, this is failure,
+        // and nothing they captured is kept.
         if (term.invert()) {
+            resetAssertionMatches(term);
             context->term -= term.atom.parenthesesWidth;
             return false;
         }
@@ -776,6 +790,8 @@ public:
 
         input.setPos(backTrack->begin);
 
+        // Assertions are not backtracked into; drop what they captured.
+        resetAssertionMatches(term);
         context->term -= term.atom.parenthesesWidth;
         return false;
     }
@@ -1109,6 +1125,10 @@ public:
             if (input.checkInput(currentTerm().checkInputCount))
                 MATCH_NEXT();
             BACKTRACK();
+
+        case ByteTerm::TypeUncheckInput:
+            input.uncheckInput(currentTerm().uncheckInputCount);
+            MATCH_NEXT();
         }
 
         // We should never fall-through to here.
@@ -1207,6 +1227,10 @@ public:
             case ByteTerm::TypeCheckInput:
                 input.uncheckInput(currentTerm().checkInputCount);
                 BACKTRACK();
+
+            case ByteTerm::TypeUncheckInput:
+                input.checkInput(currentTerm().uncheckInputCount);
+                BACKTRACK();
         }
 
         ASSERT_NOT_REACHED();
@@ -1291,6 +1315,11 @@ public:
         m_bodyDisjunction->terms.append(ByteTerm::CheckInput(count));
     }
 
+    void uncheckInput(unsigned count)
+    {
+        m_bodyDisjunction->terms.append(ByteTerm::UncheckInput(count));
+    }
+
     void assertionBOL(int inputPosition)
     {
         m_bodyDisjunction->terms.append(ByteTerm::BOL(inputPosition));
@@ -1453,6 +1482,11 @@ public:
         m_bodyDisjunction->terms[endTerm].atom.parenthesesWidth = endTerm - beginTerm;
         m_bodyDisjunction->terms[endTerm].frameLocation = frameLocation;
 
+        if (isAssertion) {
+            m_bodyDisjunction->terms[beginTerm].atom.lastSubpatternId = lastSubpatternId;
+            m_bodyDisjunction->terms[endTerm].atom.lastSubpatternId = lastSubpatternId;
+        }
+
         if (doInline) {
             m_bodyDisjunction->terms[beginTerm].atom.quantityCount = quantityCount;
             m_bodyDisjunction->terms[beginTerm].atom.quantityType = quantityType;
@@ -1592,11 +1626,21 @@ public:
                 }
 
                 case PatternTerm::TypeParentheticalAssertion: {
-                    unsigned alternativeFrameLocation = term.inputPosition + RegexStackSpaceForBackTrackInfoParentheticalAssertion;
+                    unsigned alternativeFrameLocation = term.frameLocation + RegexStackSpaceForBackTrackInfoParentheticalAssertion;
+
+                    // The input checked for this alternative runs past the assertion; step back to
+                    // where the assertion starts, so that its own checks are made from there.
+                    ASSERT(currentCountAlreadyChecked >= static_cast<unsigned>(term.inputPosition));
+                    unsigned uncheckAmount = currentCountAlreadyChecked - term.inputPosition;
+                    if (uncheckAmount)
+                        uncheckInput(uncheckAmount);
 
                     atomParentheticalAssertionBegin(term.parentheses.subpatternId, term.invertOrCapture, term.frameLocation, alternativeFrameLocation);
-                    emitDisjunction(term.parentheses.disjunction, currentCountAlreadyChecked, 0);
+                    emitDisjunction(term.parentheses.disjunction, currentCountAlreadyChecked - uncheckAmount, 0);
                     atomParenthesesEnd(true, term.parentheses.lastSubpatternId, 0, term.frameLocation, term.quantityCount, term.quantityType);
+
+                    if (uncheckAmount)
+                        checkInput(uncheckAmount);
                     break;
                 }
                 }
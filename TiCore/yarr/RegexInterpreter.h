@@ -74,6 +74,7 @@ struct ByteTerm {
         TypeParentheticalAssertionBegin,
         TypeParentheticalAssertionEnd,
         TypeCheckInput,
+        TypeUncheckInput,
     } type;
     bool invertOrCapture;
     union {
@@ -93,12 +94,15 @@ struct ByteTerm {
             };
             QuantifierType quantityType;
             unsigned quantityCount;
+            // For parenthetical assertions, the last subpattern nested within them.
+            unsigned lastSubpatternId;
         } atom;
         struct {
             int next;
             int end;
         } alternative;
         unsigned checkInputCount;
+        unsigned uncheckInputCount;
     };
     unsigned frameLocation;
     int inputPosition;
@@ -199,6 +203,13 @@ struct ByteTerm {
         return term;
     }
 
+    static ByteTerm UncheckInput(unsigned count)
+    {
+        ByteTerm term(TypeUncheckInput);
+        term.uncheckInputCount = count;
+        return term;
+    }
+
     static ByteTerm EOL(int inputPos)
     {
         ByteTerm term(TypeAssertionEOL);
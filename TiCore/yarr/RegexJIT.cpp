@@ -39,8 +39,6 @@
 #include "MacroAssembler.h"
 #include "RegexCompiler.h"
 
-#include "pcre.h" // temporary, remove when fallback is removed.
-
 #if ENABLE(YARR_JIT)
 
 using namespace WTI;
@@ -83,6 +81,10 @@ class RegexGenerator : private MacroAssembler {
     static const RegisterID returnRegister = X86Registers::eax;
 #endif
 
+    // Slots in the frame for recording iterations of quantified parentheses; matches
+    // that need more are left to the interpreter.
+    static const unsigned parenthesesStackSize = 1024;
+
     void optimizeAlternative(PatternAlternative* alternative)
     {
         if (!alternative->m_terms.size())
@@ -257,29 +259,36 @@ class RegexGenerator : private MacroAssembler {
         load16(BaseIndex(input, index, TimesTwo, inputPosition * sizeof(UChar)), reg);
     }
 
+    // Frame locations of terms within quantified parentheses are relative to the
+    // frame of the current iteration, which starts at m_frameBase.
+    Address frameAddress(unsigned frameLocation)
+    {
+        return Address(stackPointerRegister, (m_frameBase + frameLocation) * sizeof(void*));
+    }
+
     void storeToFrame(RegisterID reg, unsigned frameLocation)
     {
-        poke(reg, frameLocation);
+        poke(reg, m_frameBase + frameLocation);
     }
 
     void storeToFrame(Imm32 imm, unsigned frameLocation)
     {
-        poke(imm, frameLocation);
+        poke(imm, m_frameBase + frameLocation);
     }
 
     DataLabelPtr storeToFrameWithPatch(unsigned frameLocation)
     {
-        return storePtrWithPatch(ImmPtr(0), Address(stackPointerRegister, frameLocation * sizeof(void*)));
+        return storePtrWithPatch(ImmPtr(0), frameAddress(frameLocation));
     }
 
     void loadFromFrame(unsigned frameLocation, RegisterID reg)
     {
-        peek(reg, frameLocation);
+        peek(reg, m_frameBase + frameLocation);
     }
 
     void loadFromFrameAndJump(unsigned frameLocation)
     {
-        jump(Address(stackPointerRegister, frameLocation * sizeof(void*)));
+        jump(frameAddress(frameLocation));
     }
 
     struct AlternativeBacktrackRecord {
@@ -785,13 +794,100 @@ class RegexGenerator : private MacroAssembler {
         state.setBacktrackGenerated(backtrackBegin);
     }
 
+    void generateBackReference(TermGenerationState& state)
+    {
+        const RegisterID character = regT0;
+        const RegisterID matchLength = regT1;
+        PatternTerm& term = state.term();
+        unsigned lengthFrameLocation = term.frameLocation;
+        unsigned endFrameLocation = term.frameLocation + 1;
+        int inputOffset = state.inputOffset();
+
+        JumpList emptyMatch;
+        JumpList failures;
+
+        // A reference to a subpattern that has not (yet) matched matches the empty string.
+        load32(Address(output, (term.subpatternId << 1) * sizeof(int)), character);
+        load32(Address(output, ((term.subpatternId << 1) + 1) * sizeof(int)), matchLength);
+        emptyMatch.append(branch32(Equal, character, Imm32(-1)));
+        emptyMatch.append(branch32(Equal, matchLength, Imm32(-1)));
+        sub32(character, matchLength);
+        emptyMatch.append(branch32(LessThanOrEqual, matchLength, Imm32(0)));
+
+        // Consume the length of the captured substring, then check the input against it.
+        add32(matchLength, index);
+        storeToFrame(matchLength, lengthFrameLocation);
+        Jump notEnoughInput = branch32(Above, index, length);
+
+        // While comparing, index holds the distance from the captured substring to the
+        // current position, and character walks the captured substring up to its end.
+        add32(character, matchLength);
+        storeToFrame(matchLength, endFrameLocation);
+        sub32(matchLength, index);
+        if (inputOffset)
+            add32(Imm32(inputOffset), index);
+
+        Label loop(this);
+        load16(BaseIndex(input, character, TimesTwo), matchLength);
+        add32(index, character);
+        if (m_pattern.m_ignoreCase) {
+            Jump charactersMatch = branch16(Equal, BaseIndex(input, character, TimesTwo), matchLength);
+
+            // Only ASCII is folded here; other characters are left to the interpreter.
+            m_fallBackToInterpreter.append(branch32(Above, matchLength, Imm32(0x7f)));
+            or32(Imm32(32), matchLength);
+            sub32(Imm32('a'), matchLength);
+            failures.append(branch32(Above, matchLength, Imm32('z' - 'a')));
+            add32(Imm32('a'), matchLength);
+            Jump lowerCaseMatch = branch16(Equal, BaseIndex(input, character, TimesTwo), matchLength);
+            and32(Imm32(~32), matchLength);
+            failures.append(branch16(NotEqual, BaseIndex(input, character, TimesTwo), matchLength));
+
+            lowerCaseMatch.link(this);
+            charactersMatch.link(this);
+        } else
+            failures.append(branch16(NotEqual, BaseIndex(input, character, TimesTwo), matchLength));
+        sub32(index, character);
+        add32(Imm32(1), character);
+        branch32(NotEqual, character, frameAddress(endFrameLocation)).linkTo(loop, this);
+
+        // Matched; restore index to the end of the consumed input.
+        add32(character, index);
+        if (inputOffset)
+            sub32(Imm32(inputOffset), index);
+        Jump matched = jump();
+
+        failures.link(this);
+        loadFromFrame(endFrameLocation, character);
+        add32(character, index);
+        if (inputOffset)
+            sub32(Imm32(inputOffset), index);
+        notEnoughInput.link(this);
+        loadFromFrame(lengthFrameLocation, matchLength);
+        sub32(matchLength, index);
+        state.jumpToBacktrack(jump(), this);
+
+        // A back-reference matches in only one way, so backtracking into it just gives
+        // back the input it consumed.
+        Label backtrackBegin(this);
+        loadFromFrame(lengthFrameLocation, matchLength);
+        sub32(matchLength, index);
+        state.jumpToBacktrack(jump(), this);
+
+        emptyMatch.link(this);
+        storeToFrame(Imm32(0), lengthFrameLocation);
+        matched.link(this);
+
+        state.setBacktrackGenerated(backtrackBegin);
+    }
+
     void generateParenthesesDisjunction(PatternTerm& parenthesesTerm, TermGenerationState& state, unsigned alternativeFrameLocation)
     {
         ASSERT((parenthesesTerm.type == PatternTerm::TypeParenthesesSubpattern) || (parenthesesTerm.type == PatternTerm::TypeParentheticalAssertion));
-        ASSERT(parenthesesTerm.quantityCount == 1);
     
         PatternDisjunction* disjunction = parenthesesTerm.parentheses.disjunction;
-        unsigned preCheckedCount = ((parenthesesTerm.quantityType == QuantifierFixedCount) && (parenthesesTerm.type != PatternTerm::TypeParentheticalAssertion)) ? disjunction->m_minimumSize : 0;
+        bool isFixedOnce = (parenthesesTerm.quantityType == QuantifierFixedCount) && (parenthesesTerm.quantityCount == 1) && (parenthesesTerm.type != PatternTerm::TypeParentheticalAssertion);
+        unsigned preCheckedCount = isFixedOnce ? disjunction->m_minimumSize : 0;
 
         if (disjunction->m_alternatives.size() == 1) {
             state.resetAlternative();
@@ -801,7 +897,7 @@ class RegexGenerator : private MacroAssembler {
 
             int countToCheck = alternative->m_minimumSize - preCheckedCount;
             if (countToCheck) {
-                ASSERT((parenthesesTerm.type == PatternTerm::TypeParentheticalAssertion) || (parenthesesTerm.quantityType != QuantifierFixedCount));
+                ASSERT(!isFixedOnce);
 
                 // FIXME: This is quite horrible.  The call to 'plantJumpToBacktrackIfExists'
                 // will be forced to always trampoline into here, just to decrement the index.
@@ -974,6 +1070,218 @@ class RegexGenerator : private MacroAssembler {
         }
     }
 
+    // Iterations of quantified parentheses are recorded on the parentheses stack, a region
+    // at the top of the frame; the slot at m_parenthesesStackLocation holds the offset of
+    // its first free entry from the stack pointer.  Both of these leave the offset of the
+    // record pushed or popped in regT1.
+    void pushParenthesesStack(unsigned count)
+    {
+        Address top(stackPointerRegister, m_parenthesesStackLocation * sizeof(void*));
+        load32(top, regT1);
+        m_fallBackToInterpreter.append(branch32(Above, regT1, Imm32((m_parenthesesStackLocation + 1 + parenthesesStackSize - count) * sizeof(void*))));
+        move(regT1, regT0);
+        add32(Imm32(count * sizeof(void*)), regT0);
+        store32(regT0, top);
+    }
+
+    void popParenthesesStack(unsigned count)
+    {
+        Address top(stackPointerRegister, m_parenthesesStackLocation * sizeof(void*));
+        load32(top, regT1);
+        sub32(Imm32(count * sizeof(void*)), regT1);
+        store32(regT1, top);
+    }
+
+    BaseIndex parenthesesStackEntry(unsigned entry)
+    {
+        return BaseIndex(stackPointerRegister, regT1, TimesOne, entry * sizeof(void*));
+    }
+
+    // Each iteration starts with its subpatterns unmatched; what the previous one
+    // captured is restored if it fails.
+    void saveAndResetSubpatterns(PatternTerm& term)
+    {
+        unsigned firstOffset = term.parentheses.subpatternId << 1;
+        unsigned count = (term.parentheses.lastSubpatternId + 1 - term.parentheses.subpatternId) << 1;
+
+        pushParenthesesStack(count);
+        for (unsigned i = 0; i < count; ++i) {
+            load32(Address(output, (firstOffset + i) * sizeof(int)), regT0);
+            store32(regT0, parenthesesStackEntry(i));
+            store32(Imm32(-1), Address(output, (firstOffset + i) * sizeof(int)));
+        }
+    }
+
+    void restoreSubpatterns(PatternTerm& term)
+    {
+        unsigned firstOffset = term.parentheses.subpatternId << 1;
+        unsigned count = (term.parentheses.lastSubpatternId + 1 - term.parentheses.subpatternId) << 1;
+
+        popParenthesesStack(count);
+        for (unsigned i = 0; i < count; ++i) {
+            load32(parenthesesStackEntry(i), regT0);
+            store32(regT0, Address(output, (firstOffset + i) * sizeof(int)));
+        }
+    }
+
+    // A matched iteration saves its frame, so that it can be backtracked into once
+    // the iterations after it have failed.
+    void saveIterationFrame(PatternTerm& term, unsigned frameBase)
+    {
+        unsigned frameSize = term.parentheses.disjunction->m_callFrameSize;
+
+        pushParenthesesStack(frameSize + 1);
+        for (unsigned i = 0; i < frameSize; ++i) {
+            loadPtr(Address(stackPointerRegister, (frameBase + i) * sizeof(void*)), regT0);
+            storePtr(regT0, parenthesesStackEntry(i));
+        }
+        loadFromFrame(term.frameLocation + 1, regT0);
+        storePtr(regT0, parenthesesStackEntry(frameSize));
+    }
+
+    void restoreIterationFrame(PatternTerm& term, unsigned frameBase)
+    {
+        unsigned frameSize = term.parentheses.disjunction->m_callFrameSize;
+
+        popParenthesesStack(frameSize + 1);
+        for (unsigned i = 0; i < frameSize; ++i) {
+            loadPtr(parenthesesStackEntry(i), regT0);
+            storePtr(regT0, Address(stackPointerRegister, (frameBase + i) * sizeof(void*)));
+        }
+        loadPtr(parenthesesStackEntry(frameSize), regT0);
+        storeToFrame(regT0, term.frameLocation + 1);
+    }
+
+    void generateParenthesesQuantified(TermGenerationState& state)
+    {
+        const RegisterID indexTemporary = regT0;
+        PatternTerm& term = state.term();
+        PatternDisjunction* disjunction = term.parentheses.disjunction;
+        ASSERT(m_parenthesesStackLocation);
+
+        unsigned countFrameLocation = term.frameLocation;
+        unsigned beginFrameLocation = term.frameLocation + 1;
+        unsigned parenthesesFrameBase = m_frameBase + term.frameLocation + RegexStackSpaceForBackTrackInfoParentheses;
+        bool hasSubpatterns = term.parentheses.lastSubpatternId >= term.parentheses.subpatternId;
+        int inputOffset = state.inputOffset();
+
+        // A single record must fit on the parentheses stack.
+        unsigned subpatternRecordSize = hasSubpatterns ? (term.parentheses.lastSubpatternId + 1 - term.parentheses.subpatternId) << 1 : 0;
+        if ((subpatternRecordSize > parenthesesStackSize) || (disjunction->m_callFrameSize + 1 > parenthesesStackSize)) {
+            m_generationFailed = true;
+            return;
+        }
+
+        storeToFrame(Imm32(0), countFrameLocation);
+        Jump nonGreedySkipParentheses;
+        if (term.quantityType == QuantifierNonGreedy)
+            nonGreedySkipParentheses = jump();
+
+        // Try another iteration.
+        Label tryIteration(this);
+        bool hasMaximum = term.quantityCount != UINT_MAX;
+        Jump atMaximum;
+        if (hasMaximum) {
+            loadFromFrame(countFrameLocation, indexTemporary);
+            atMaximum = branch32(Equal, indexTemporary, Imm32(term.quantityCount));
+        }
+        if (hasSubpatterns)
+            saveAndResetSubpatterns(term);
+        storeToFrame(index, beginFrameLocation);
+
+        unsigned frameBase = m_frameBase;
+        m_frameBase = parenthesesFrameBase;
+        TermGenerationState parenthesesState(disjunction, state.checkedTotal);
+        generateParenthesesDisjunction(term, parenthesesState, 0);
+        m_frameBase = frameBase;
+
+        // Beyond the minimum count an iteration matching the empty string is rejected.
+        if (term.quantityType != QuantifierFixedCount) {
+            loadFromFrame(beginFrameLocation, indexTemporary);
+            parenthesesState.jumpToBacktrack(branch32(Equal, index, indexTemporary), this);
+        }
+
+        if (term.invertOrCapture) {
+            loadFromFrame(beginFrameLocation, indexTemporary);
+            if (inputOffset)
+                add32(Imm32(inputOffset), indexTemporary);
+            store32(indexTemporary, Address(output, (term.parentheses.subpatternId << 1) * sizeof(int)));
+            if (inputOffset) {
+                move(index, indexTemporary);
+                add32(Imm32(inputOffset), indexTemporary);
+                store32(indexTemporary, Address(output, ((term.parentheses.subpatternId << 1) + 1) * sizeof(int)));
+            } else
+                store32(index, Address(output, ((term.parentheses.subpatternId << 1) + 1) * sizeof(int)));
+        }
+
+        saveIterationFrame(term, parenthesesFrameBase);
+        loadFromFrame(countFrameLocation, indexTemporary);
+        add32(Imm32(1), indexTemporary);
+        storeToFrame(indexTemporary, countFrameLocation);
+        JumpList done;
+        if (term.quantityType == QuantifierNonGreedy)
+            done.append(jump());
+        else
+            jump(tryIteration);
+
+        // Backtrack into the last matched iteration, or out of the parentheses if there is none.
+        Label backtrackIntoIteration(this);
+        loadFromFrame(countFrameLocation, indexTemporary);
+        state.jumpToBacktrack(branchTest32(Zero, indexTemporary), this);
+        sub32(Imm32(1), indexTemporary);
+        storeToFrame(indexTemporary, countFrameLocation);
+        restoreIterationFrame(term, parenthesesFrameBase);
+        parenthesesState.plantJumpToBacktrackIfExists(this);
+
+        // The iteration failed; index is back where it began.
+        parenthesesState.linkAlternativeBacktracks(this);
+        if (hasSubpatterns)
+            restoreSubpatterns(term);
+
+        if (term.quantityType == QuantifierGreedy) {
+            if (hasMaximum)
+                done.append(atMaximum);
+            state.setBacktrackGenerated(backtrackIntoIteration);
+        } else {
+            jump(backtrackIntoIteration);
+            if (term.quantityType == QuantifierNonGreedy) {
+                if (hasMaximum)
+                    atMaximum.linkTo(backtrackIntoIteration, this);
+                nonGreedySkipParentheses.link(this);
+                state.setBacktrackGenerated(tryIteration);
+            } else {
+                done.append(atMaximum);
+                state.setBacktrackGenerated(backtrackIntoIteration);
+            }
+        }
+        done.link(this);
+    }
+
+    static bool containsQuantifiedParentheses(PatternDisjunction* disjunction)
+    {
+        for (unsigned alt = 0; alt < disjunction->m_alternatives.size(); ++alt) {
+            PatternAlternative* alternative = disjunction->m_alternatives[alt];
+            for (unsigned i = 0; i < alternative->m_terms.size(); ++i) {
+                PatternTerm& term = alternative->m_terms[i];
+                if ((term.type != PatternTerm::TypeParenthesesSubpattern) && (term.type != PatternTerm::TypeParentheticalAssertion))
+                    continue;
+                if ((term.type == PatternTerm::TypeParenthesesSubpattern) && ((term.quantityCount != 1) || term.parentheses.isCopy))
+                    return true;
+                if (containsQuantifiedParentheses(term.parentheses.disjunction))
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    void clearSubpatternsInAssertion(PatternTerm& term)
+    {
+        for (unsigned subpatternId = term.parentheses.subpatternId; subpatternId <= term.parentheses.lastSubpatternId; ++subpatternId) {
+            store32(Imm32(-1), Address(output, (subpatternId << 1) * sizeof(int)));
+            store32(Imm32(-1), Address(output, ((subpatternId << 1) + 1) * sizeof(int)));
+        }
+    }
+
     void generateParentheticalAssertion(TermGenerationState& state)
     {
         PatternTerm& term = state.term();
@@ -998,6 +1306,7 @@ class RegexGenerator : private MacroAssembler {
             generateParenthesesDisjunction(state.term(), parenthesesState, alternativeFrameLocation);
             // Success! - which means - Fail!
             loadFromFrame(parenthesesFrameLocation, index);
+            clearSubpatternsInAssertion(term);
             state.jumpToBacktrack(jump(), this);
 
             // And fail means success.
@@ -1023,6 +1332,15 @@ class RegexGenerator : private MacroAssembler {
             loadFromFrame(parenthesesFrameLocation, index);
             state.jumpToBacktrack(jump(), this);
 
+            // Assertions are not backtracked into, but what they captured must be
+            // dropped when backtracking past them.
+            if (term.parentheses.lastSubpatternId >= term.parentheses.subpatternId) {
+                Label backtrackFromAfterAssertion(this);
+                clearSubpatternsInAssertion(term);
+                state.jumpToBacktrack(jump(), this);
+                state.setBacktrackGenerated(backtrackFromAfterAssertion);
+            }
+
             success.link(this);
 
             state.checkedTotal += countCheckedAfterAssertion;
@@ -1085,7 +1403,10 @@ class RegexGenerator : private MacroAssembler {
             break;
 
         case PatternTerm::TypeBackReference:
-            m_generationFailed = true;
+            if ((term.quantityType == QuantifierFixedCount) && (term.quantityCount == 1))
+                generateBackReference(state);
+            else
+                m_generationFailed = true;
             break;
 
         case PatternTerm::TypeForwardReference:
@@ -1095,11 +1416,15 @@ class RegexGenerator : private MacroAssembler {
             if ((term.quantityCount == 1) && !term.parentheses.isCopy)
                 generateParenthesesSingle(state);
             else
-                m_generationFailed = true;
+                generateParenthesesQuantified(state);
             break;
 
         case PatternTerm::TypeParentheticalAssertion:
-            generateParentheticalAssertion(state);
+            // Iterations recorded within an assertion would outlive it on the parentheses stack.
+            if (containsQuantifiedParentheses(term.parentheses.disjunction))
+                m_generationFailed = true;
+            else
+                generateParentheticalAssertion(state);
             break;
         }
     }
@@ -1144,8 +1469,8 @@ class RegexGenerator : private MacroAssembler {
                 generateTerm(state);
 
             // If we get here, the alternative matched.
-            if (m_pattern.m_body->m_callFrameSize)
-                addPtr(Imm32(m_pattern.m_body->m_callFrameSize * sizeof(void*)), stackPointerRegister);
+            if (m_callFrameSize)
+                addPtr(Imm32(m_callFrameSize * sizeof(void*)), stackPointerRegister);
             
             ASSERT(index != returnRegister);
             if (m_pattern.m_body->m_hasFixedSize) {
@@ -1212,6 +1537,14 @@ class RegexGenerator : private MacroAssembler {
 
         state.checkedTotal -= countCheckedForCurrentAlternative;
 
+        // An anchored match is only tried at the start position it was given.
+        if (m_anchored) {
+            state.linkAlternativeBacktracks(this);
+            notEnoughInputForPreviousAlternative.link(this);
+            generateFailureReturn(-1);
+            return;
+        }
+
         // How much more input need there be to be able to retry from the first alternative?
         // examples:
         //   /yarr_jit/ or /wrec|pcre/
@@ -1239,7 +1572,7 @@ class RegexGenerator : private MacroAssembler {
             if (!m_pattern.m_body->m_hasFixedSize) {
                 move(index, regT0);
                 sub32(Imm32(countCheckedForCurrentAlternative - 1), regT0);
-                poke(regT0, m_pattern.m_body->m_callFrameSize);
+                poke(regT0, m_callFrameSize);
             }
 
             // Update index if necessary, and loop (without checking).
@@ -1254,9 +1587,9 @@ class RegexGenerator : private MacroAssembler {
             if (countCheckedForCurrentAlternative - 1) {
                 move(index, regT0);
                 sub32(Imm32(countCheckedForCurrentAlternative - 1), regT0);
-                poke(regT0, m_pattern.m_body->m_callFrameSize);
+                poke(regT0, m_callFrameSize);
             } else
-                poke(index, m_pattern.m_body->m_callFrameSize);
+                poke(index, m_callFrameSize);
         }
         // Check if there is sufficent input to run the first alternative again.
         jumpIfAvailableInput(incrementForNextIter).linkTo(firstAlternativeInputChecked, this);
@@ -1282,13 +1615,18 @@ class RegexGenerator : private MacroAssembler {
         // it has either been incremented by 1 or by (countToCheckForFirstAlternative + 1) ... 
         // but since we're about to return a failure this doesn't really matter!)
 
-        unsigned frameSize = m_pattern.m_body->m_callFrameSize;
+        generateFailureReturn(-1);
+    }
+
+    void generateFailureReturn(int result)
+    {
+        unsigned frameSize = m_callFrameSize;
         if (!m_pattern.m_body->m_hasFixedSize)
             ++frameSize;
         if (frameSize)
             addPtr(Imm32(frameSize * sizeof(void*)), stackPointerRegister);
 
-        move(Imm32(-1), returnRegister);
+        move(Imm32(result), returnRegister);
 
         generateReturn();
     }
@@ -1342,8 +1680,13 @@ class RegexGenerator : private MacroAssembler {
     }
 
 public:
-    RegexGenerator(RegexPattern& pattern)
+    RegexGenerator(RegexPattern& pattern, bool anchored)
         : m_pattern(pattern)
+        , m_anchored(anchored)
+        , m_callFrameSize(0)
+        , m_frameBase(0)
+        , m_parenthesesStackLocation(0)
+        , m_mayFallBackToInterpreter(false)
         , m_generationFailed(false)
     {
     }
@@ -1356,10 +1699,25 @@ public:
         if (!m_pattern.m_body->m_hasFixedSize)
             push(index);
 
-        if (m_pattern.m_body->m_callFrameSize)
-            subPtr(Imm32(m_pattern.m_body->m_callFrameSize * sizeof(void*)), stackPointerRegister);
+        m_callFrameSize = m_pattern.m_body->m_callFrameSize;
+        if (containsQuantifiedParentheses(m_pattern.m_body)) {
+            m_parenthesesStackLocation = m_callFrameSize;
+            m_callFrameSize += 1 + parenthesesStackSize;
+        }
+
+        if (m_callFrameSize)
+            subPtr(Imm32(m_callFrameSize * sizeof(void*)), stackPointerRegister);
+
+        if (m_parenthesesStackLocation)
+            store32(Imm32((m_parenthesesStackLocation + 1) * sizeof(void*)), Address(stackPointerRegister, m_parenthesesStackLocation * sizeof(void*)));
 
         generateDisjunction(m_pattern.m_body);
+
+        if (!m_fallBackToInterpreter.empty()) {
+            m_mayFallBackToInterpreter = true;
+            m_fallBackToInterpreter.link(this);
+            generateFailureReturn(RegexCodeBlock::FallBackToInterpreter);
+        }
     }
 
     void compile(TiGlobalData* globalData, RegexCodeBlock& jitObject)
@@ -1379,9 +1737,21 @@ public:
         return m_generationFailed;
     }
 
+    // Whether the generated code may give up on a match and leave it to the interpreter.
+    bool mayFallBackToInterpreter()
+    {
+        return m_mayFallBackToInterpreter;
+    }
+
 private:
     RegexPattern& m_pattern;
+    bool m_anchored;
     Vector<AlternativeBacktrackRecord> m_backtrackRecords;
+    JumpList m_fallBackToInterpreter;
+    unsigned m_callFrameSize;
+    unsigned m_frameBase;
+    unsigned m_parenthesesStackLocation;
+    bool m_mayFallBackToInterpreter;
     bool m_generationFailed;
 };
 
@@ -1394,14 +1764,20 @@ void jitCompileRegex(TiGlobalData* globalData, RegexCodeBlock& jitObject, const
 
     numSubpatterns = pattern.m_numSubpatterns;
 
-    RegexGenerator generator(pattern);
+    // A single leading character is found about as quickly by the generated code itself.
+    // Otherwise the prefix search picks each start position, and the generated code only
+    // tries a match there.
+    bool usePrefixSearch = pattern.m_literalPrefix.size() > 1;
+    if (usePrefixSearch)
+        jitObject.setPrefixSearch(new RegexPrefixSearch(pattern.m_literalPrefix));
+
+    RegexGenerator generator(pattern, usePrefixSearch);
     generator.compile(globalData, jitObject);
 
-    if (generator.generationFailed()) {
-        JSRegExpIgnoreCaseOption ignoreCaseOption = ignoreCase ? JSRegExpIgnoreCase : JSRegExpDoNotIgnoreCase;
-        JSRegExpMultilineOption multilineOption = multiline ? JSRegExpMultiline : JSRegExpSingleLine;
-        jitObject.setFallback(jsRegExpCompile(reinterpret_cast<const UChar*>(patternString.data()), patternString.size(), ignoreCaseOption, multilineOption, &numSubpatterns, &error));
-    }
+    if (generator.generationFailed())
+        jitObject.setFallback(byteCompileRegex(patternString, numSubpatterns, error, ignoreCase, multiline));
+    else if (generator.mayFallBackToInterpreter())
+        jitObject.setBailOutFallback(byteCompileRegex(patternString, numSubpatterns, error, ignoreCase, multiline));
 }
 
 }}
@@ -38,11 +38,10 @@
 #if ENABLE(YARR_JIT)
 
 #include "MacroAssembler.h"
+#include "RegexInterpreter.h"
 #include "RegexPattern.h"
 #include <UString.h>
-
-#include <pcre.h>
-struct JSRegExp; // temporary, remove when fallback is removed.
+#include <wtf/OwnPtr.h>
 
 #if PLATFORM(X86) && !COMPILER(MSVC)
 #define YARR_CALL __attribute__ ((regparm (3)))
@@ -57,26 +56,79 @@ class ExecutablePool;
 
 namespace Yarr {
 
+// Finds the literal characters that every match of a pattern starts with, using a
+// Boyer-Moore-Horspool scan whose skip table is keyed on the low byte of each character.
+class RegexPrefixSearch : public FastAllocBase {
+public:
+    RegexPrefixSearch(const Vector<UChar>& prefix)
+        : m_prefix(prefix)
+    {
+        ASSERT(m_prefix.size());
+        unsigned last = m_prefix.size() - 1;
+        for (unsigned i = 0; i < 256; ++i)
+            m_shift[i] = m_prefix.size();
+        for (unsigned i = 0; i < last; ++i)
+            m_shift[m_prefix[i] & 0xff] = last - i;
+    }
+
+    // Returns the first offset at or after start at which the prefix occurs, or -1.
+    int find(const UChar* input, unsigned start, unsigned length) const
+    {
+        unsigned prefixLength = m_prefix.size();
+        unsigned last = prefixLength - 1;
+        const UChar* prefix = m_prefix.data();
+
+        for (unsigned position = start; position + prefixLength <= length; ) {
+            UChar ch = input[position + last];
+            if (ch == prefix[last]) {
+                unsigned i = 0;
+                while (i < last && input[position + i] == prefix[i])
+                    ++i;
+                if (i == last)
+                    return position;
+            }
+            position += m_shift[ch & 0xff];
+        }
+        return -1;
+    }
+
+private:
+    Vector<UChar> m_prefix;
+    unsigned m_shift[256];
+};
+
 class RegexCodeBlock {
     typedef int (*RegexJITCode)(const UChar* input, unsigned start, unsigned length, int* output) YARR_CALL;
 
 public:
+    // Returned by generated code that gives up on a match part way through.
+    static const int FallBackToInterpreter = -2;
+
     RegexCodeBlock()
-        : m_fallback(0)
+        : m_useFallback(false)
     {
     }
 
-    ~RegexCodeBlock()
+    // Patterns the generator cannot compile run on the YARR interpreter instead.
+    BytecodePattern* getFallback() { return m_useFallback ? m_fallback.get() : 0; }
+    void setFallback(BytecodePattern* fallback)
     {
-        if (m_fallback)
-            jsRegExpFree(m_fallback);
+        m_fallback.set(fallback);
+        m_useFallback = true;
     }
 
-    JSRegExp* getFallback() { return m_fallback; }
-    void setFallback(JSRegExp* fallback) { m_fallback = fallback; }
+    // Matches the generated code gives up on are rerun on the interpreter.
+    BytecodePattern* getBailOutFallback() { return m_fallback.get(); }
+    void setBailOutFallback(BytecodePattern* fallback) { m_fallback.set(fallback); }
+
+    // Generated code for a pattern with a prefix search is anchored: it only tries a
+    // match at the start position it is given.
+    RegexPrefixSearch* getPrefixSearch() { return m_prefixSearch.get(); }
+    void setPrefixSearch(RegexPrefixSearch* prefixSearch) { m_prefixSearch.set(prefixSearch); }
 
     bool operator!() { return !m_ref.m_code.executableAddress(); }
     void set(MacroAssembler::CodeRef ref) { m_ref = ref; }
+    size_t size() const { return m_ref.m_size; }
 
     int execute(const UChar* input, unsigned start, unsigned length, int* output)
     {
@@ -85,17 +137,41 @@ public:
 
 private:
     MacroAssembler::CodeRef m_ref;
-    JSRegExp* m_fallback;
+    OwnPtr<BytecodePattern> m_fallback;
+    bool m_useFallback;
+    OwnPtr<RegexPrefixSearch> m_prefixSearch;
 };
 
 void jitCompileRegex(TiGlobalData* globalData, RegexCodeBlock& jitObject, const UString& pattern, unsigned& numSubpatterns, const char*& error, bool ignoreCase = false, bool multiline = false);
 
-inline int executeRegex(RegexCodeBlock& jitObject, const UChar* input, unsigned start, unsigned length, int* output, int outputArraySize)
+inline int executeRegex(RegexCodeBlock& jitObject, const UChar* input, unsigned start, unsigned length, int* output)
 {
-    if (JSRegExp* fallback = jitObject.getFallback())
-        return (jsRegExpExecute(fallback, input, length, start, output, outputArraySize) < 0) ? -1 : output[0];
+    // No match can begin before the first occurrence of the pattern's literal prefix.
+    RegexPrefixSearch* prefixSearch = jitObject.getPrefixSearch();
+    if (prefixSearch) {
+        int candidate = prefixSearch->find(input, start, length);
+        if (candidate < 0)
+            return -1;
+        start = candidate;
+    }
 
-    return jitObject.execute(input, start, length, output);
+    if (BytecodePattern* fallback = jitObject.getFallback())
+        return interpretRegex(fallback, input, start, length, output);
+
+    while (true) {
+        int result = jitObject.execute(input, start, length, output);
+        // The interpreter is not anchored, so it carries on from here by itself.
+        if (result == RegexCodeBlock::FallBackToInterpreter)
+            return interpretRegex(jitObject.getBailOutFallback(), input, start, length, output);
+        if (result >= 0 || !prefixSearch)
+            return result;
+
+        // The anchored match failed; try the next occurrence of the prefix.
+        int candidate = prefixSearch->find(input, start + 1, length);
+        if (candidate < 0)
+            return -1;
+        start = candidate;
+    }
 }
 
 } } // namespace TI::Yarr
@@ -275,6 +275,7 @@ struct RegexPattern {
     {
         m_numSubpatterns = 0;
         m_maxBackReference = 0;
+        m_literalPrefix.clear();
 
         newlineCached = 0;
         digitsCached = 0;
@@ -345,6 +346,7 @@ struct RegexPattern {
     PatternDisjunction* m_body;
     Vector<PatternDisjunction*, 4> m_disjunctions;
     Vector<CharacterClass*> m_userCharacterClasses;
+    Vector<UChar> m_literalPrefix; // Characters every match starts with.
 
 private:
     CharacterClass* newlineCached;